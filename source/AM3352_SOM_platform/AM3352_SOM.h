@@ -8,6 +8,8 @@
 #ifndef AM3352_SOM_H_
 #define AM3352_SOM_H_
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -15,6 +17,21 @@ extern "C" {
 /* Which UART is used for the console */
 #define UART_CONSOLE_PORT 0
 
+/* Statistics for the CPU overhead of the console output */
+typedef struct
+{
+    /* Identifies the method used to transmit the characters */
+    const char *tx_mode;
+    /* The number of characters accepted for output */
+    uint32_t bytes_written;
+    /* The number of characters discarded due to the software buffer being full */
+    uint32_t bytes_discarded;
+    /* The CPU cycles spent in the console output functions called by the main-line */
+    uint64_t write_cpu_cycles;
+    /* The CPU cycles spent in the console interrupt handlers */
+    uint64_t isr_cpu_cycles;
+} uart_console_statistics_t;
+
 /*****************************************************************************
 **                    FUNCTION PROTOTYPES
 *****************************************************************************/
@@ -23,6 +40,11 @@ void UART0ModuleClkConfig(void);
 void UART1ModuleClkConfig(void);
 void UART2ModuleClkConfig(void);
 void UART4ModuleClkConfig(void);
+void UARTConsoleInit(void);
+void UARTConsolePutc(unsigned char data);
+unsigned int UARTConsoleWrite(const unsigned char *const buf, const unsigned int len);
+void UARTConsoleGetStatistics(uart_console_statistics_t *const stats);
+unsigned int UARTConsoleTxSpaceGet(void);
 void UARTPinMuxSetup(unsigned int instanceNum);
 void RTCModuleClkConfig(void);
 void SysPerfTimerSetup(void);
@@ -33,6 +55,8 @@ void DMTimer4ModuleClkConfig(void);
 void DMTimer6ModuleClkConfig(void);
 void DMTimer7ModuleClkConfig(void);
 void DMTimer1msModuleClkConfig(unsigned int clkselect);
+uint32_t get_crystal_hz (void);
+void EDMAModuleClkConfig(void);
 unsigned int pmu_get_cycle_count (void);
 void enable_cycle_count (void);
 void HSMMCSDModuleClkConfig(void);
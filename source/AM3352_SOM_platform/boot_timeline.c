@@ -0,0 +1,221 @@
+/*
+ * @file boot_timeline.c
+ * @date 16 Oct 2026
+ * @brief Boot timeline, a log of the time spent in each boot phase written by both the bootloader and the application
+ * @details The log is in a fixed 256 byte region of the L3 OCMC RAM, just below the bootloader MMU page table, which is
+ *          reserved by the linker scripts of the bootloader and of the applications which add to the log. The region
+ *          isn't loaded or cleared by the C run time start up, so the log written by the bootloader is still present
+ *          when the application starts.
+ *
+ *          Each mark records the number of PMU cycle counter ticks since the previous mark, which is the duration of
+ *          the phase which has just ended, along with the frequency of the cycle counter during the phase. The
+ *          frequency isn't constant during the boot:
+ *          - Until PLLInit() the MPU runs at the clock left by the boot ROM.
+ *          - During PLLInit() the MPU PLL is bypassed while it is re-locked.
+ *          Therefore the bootloader measures the average frequency of those phases against DMTimer2, and then sets
+ *          the frequency the MPU PLL was programmed to.
+ *
+ *          enable_cycle_count() resets the cycle counter, so the application marks BOOT_PHASE_APP_ENTRY before
+ *          calling enable_cycle_count() and then calls boot_timeline_cycle_counter_reset(). The few cycles between
+ *          the mark and the reset are not counted.
+ *
+ *          BOOT_PHASE_APP_ENTRY is only added to a log which the bootloader has just left, so an application which
+ *          was loaded by the debugger, or re-started without a reset, doesn't add to a stale log.
+ */
+
+#include <stddef.h>
+
+#include "uartStdio.h"
+#include "AM3352_SOM.h"
+#include "boot_timeline.h"
+
+/* Identifies a log written by the bootloader */
+#define BOOT_TIMELINE_MAGIC 0x6C6D6954u /* "Timl" */
+
+/* The number of entries which fit in the 256 byte region after the header */
+#define BOOT_TIMELINE_MAX_ENTRIES 20u
+
+#define US_PER_SEC 1000000u
+
+/** One entry in the log, recording the duration of one boot phase */
+typedef struct
+{
+    /** The boot_phase_t which ended at the mark */
+    uint32_t phase;
+    /** The number of cycle counter ticks during the phase */
+    uint32_t cycles;
+    /** The frequency of the cycle counter during the phase, or zero if unknown */
+    uint32_t cycle_hz;
+} boot_timeline_entry_t;
+
+/** The log, which is shared between the bootloader and the application */
+typedef struct
+{
+    /** Set to BOOT_TIMELINE_MAGIC by the bootloader */
+    uint32_t magic;
+    /** The number of valid entries */
+    uint32_t num_entries;
+    /** The value of the cycle counter at the previous mark */
+    uint32_t previous_cycles;
+    /** The frequency of the cycle counter during the current phase */
+    uint32_t cycle_hz;
+    boot_timeline_entry_t entries[BOOT_TIMELINE_MAX_ENTRIES];
+} boot_timeline_t;
+
+/** The log, in a NOLOAD section placed by the linker script at a fixed address in the OCMC RAM */
+static boot_timeline_t timeline __attribute__((section(".boot_timeline")));
+
+/** The names of the boot phases, in the order of boot_phase_t */
+static const char *const phase_names[BOOT_NUM_PHASES] =
+{
+    "BlPlatformConfig() before PLLInit()",
+    "PLLInit()",
+    "EMIFInit()",
+    "DDR3Init()",
+    "Bootloader UARTSetup()",
+    "Bootloader MMU and cache enable",
+    "SD card initialisation and file open",
+    "Image copy from SD card",
+    "Image CRC verification",
+    "Bootloader reporting and exit",
+    "Application C run time start up",
+    "Application MMU enable",
+    "Application UART_setup()",
+    "Application RTC_setup()",
+    "Application timestamp_init()",
+    "Other application initialisation",
+    "Application AINTC initialisation",
+    "Application scheduler_init()",
+    "Application delay with MMU and caches off",
+    "Application delay with MMU and caches on"
+};
+
+/**
+ * @brief Start a new log, and reset the cycle counter.
+ * @details Called by the bootloader at the start of BlPlatformConfig(), which is the start of the timeline.
+ *          The time spent in the boot ROM isn't measured.
+ */
+void boot_timeline_start (void)
+{
+    enable_cycle_count ();
+    timeline.num_entries = 0;
+    timeline.previous_cycles = 0;
+    timeline.cycle_hz = 0;
+    timeline.magic = BOOT_TIMELINE_MAGIC;
+}
+
+/**
+ * @brief Set the frequency of the cycle counter during the current phase, which is recorded by the next mark
+ * @param[in] cycle_hz The cycle counter frequency in Hz, or zero if unknown
+ */
+void boot_timeline_set_cycle_hz (const uint32_t cycle_hz)
+{
+    timeline.cycle_hz = cycle_hz;
+}
+
+/**
+ * @brief Record the end of a boot phase, which is also the start of the next phase
+ * @details Has no effect if there is no log from the bootloader, or the log is full.
+ * @param[in] phase The phase which has ended
+ */
+void boot_timeline_mark (const boot_phase_t phase)
+{
+    const uint32_t cycles = pmu_get_cycle_count ();
+    boot_timeline_entry_t *entry;
+
+    if ((phase == BOOT_PHASE_APP_ENTRY) &&
+        ((timeline.num_entries == 0) || (timeline.entries[timeline.num_entries - 1].phase != BOOT_PHASE_BL_EXIT)))
+    {
+        /* The application wasn't started by the bootloader, so any log is stale */
+        timeline.magic = 0;
+    }
+
+    if ((timeline.magic == BOOT_TIMELINE_MAGIC) && (timeline.num_entries < BOOT_TIMELINE_MAX_ENTRIES))
+    {
+        entry = &timeline.entries[timeline.num_entries];
+        entry->phase = phase;
+        entry->cycles = cycles - timeline.previous_cycles;
+        entry->cycle_hz = timeline.cycle_hz;
+        timeline.previous_cycles = cycles;
+        timeline.num_entries++;
+    }
+}
+
+/**
+ * @brief Notify the log that the cycle counter has been reset by enable_cycle_count()
+ */
+void boot_timeline_cycle_counter_reset (void)
+{
+    timeline.previous_cycles = 0;
+}
+
+/**
+ * @brief Check if a region of memory overlaps the log
+ * @details Used by the bootloader to reject an application image which would overwrite the log.
+ * @param[in] start_addr The start address of the region
+ * @param[in] num_bytes The size of the region
+ * @return Returns true if the region overlaps the log
+ */
+bool boot_timeline_overlaps (const uint32_t start_addr, const uint32_t num_bytes)
+{
+    const uint32_t timeline_start = (uint32_t) &timeline;
+    const uint32_t timeline_end = timeline_start + sizeof (timeline);
+
+    return (start_addr < timeline_end) && ((start_addr + num_bytes) > timeline_start);
+}
+
+/**
+ * @brief Display the boot timeline on the console, with the slowest phase
+ * @details Called by the application once its initialisation is complete. The durations are from the cycle
+ *          counter, converted to microseconds using the frequency recorded for each phase.
+ */
+void boot_timeline_print (void)
+{
+    const boot_timeline_entry_t *entry;
+    const char *slowest_name = NULL;
+    uint32_t slowest_us = 0;
+    uint32_t total_us = 0;
+    uint32_t phase_us;
+    uint32_t entry_index;
+
+    if (timeline.magic != BOOT_TIMELINE_MAGIC)
+    {
+        UARTprintf ("No boot timeline, since not started by the bootloader\n");
+        return;
+    }
+
+    UARTprintf ("\nBoot timeline from the start of the bootloader:\n");
+    UARTprintf ("    Cycles  Cycle MHz   Phase us     End us  Phase\n");
+    for (entry_index = 0; entry_index < timeline.num_entries; entry_index++)
+    {
+        entry = &timeline.entries[entry_index];
+        if (entry->cycle_hz != 0)
+        {
+            phase_us = (uint32_t) (((uint64_t) entry->cycles * US_PER_SEC) / entry->cycle_hz);
+            total_us += phase_us;
+            UARTprintf ("%10u %10u %10u %10u  %s\n", (unsigned int) entry->cycles,
+                        (unsigned int) (entry->cycle_hz / US_PER_SEC), (unsigned int) phase_us,
+                        (unsigned int) total_us, phase_names[entry->phase]);
+            if (phase_us > slowest_us)
+            {
+                slowest_us = phase_us;
+                slowest_name = phase_names[entry->phase];
+            }
+        }
+        else
+        {
+            UARTprintf ("%10u    unknown                        %s\n", (unsigned int) entry->cycles,
+                        phase_names[entry->phase]);
+        }
+    }
+
+    if (slowest_name != NULL)
+    {
+        UARTprintf ("Total %u us, slowest phase %s took %u us\n", (unsigned int) total_us, slowest_name,
+                    (unsigned int) slowest_us);
+    }
+    if (timeline.num_entries == BOOT_TIMELINE_MAX_ENTRIES)
+    {
+        UARTprintf ("Boot timeline full, later phases not recorded\n");
+    }
+}
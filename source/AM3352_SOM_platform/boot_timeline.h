@@ -0,0 +1,59 @@
+/*
+ * @file boot_timeline.h
+ * @date 16 Oct 2026
+ * @brief Interface to the boot timeline, a log of the boot phases written by both the bootloader and the application
+ */
+
+#ifndef BOOT_TIMELINE_H_
+#define BOOT_TIMELINE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The boot phases, each of which is recorded by a mark at the end of the phase.
+ * The values are stored in the log, so are shared by the bootloader and the application. New phases are added at the
+ * end, so the existing values don't change. */
+typedef enum
+{
+    /* Bootloader phases */
+    BOOT_PHASE_BL_EARLY_CONFIG,
+    BOOT_PHASE_BL_PLL_INIT,
+    BOOT_PHASE_BL_EMIF_INIT,
+    BOOT_PHASE_BL_DDR3_INIT,
+    BOOT_PHASE_BL_UART_SETUP,
+    BOOT_PHASE_BL_CACHE_ENABLE,
+    BOOT_PHASE_BL_SD_CARD_INIT,
+    BOOT_PHASE_BL_IMAGE_COPY,
+    BOOT_PHASE_BL_IMAGE_VERIFY,
+    BOOT_PHASE_BL_EXIT,
+    /* Application phases */
+    BOOT_PHASE_APP_ENTRY,
+    BOOT_PHASE_APP_MMU_ENABLE,
+    BOOT_PHASE_APP_UART_SETUP,
+    BOOT_PHASE_APP_RTC_SETUP,
+    BOOT_PHASE_APP_TIMESTAMP_INIT,
+    BOOT_PHASE_APP_OTHER_INIT,
+    BOOT_PHASE_APP_INTC_INIT,
+    BOOT_PHASE_APP_SCHEDULER_INIT,
+    BOOT_PHASE_APP_MMU_OFF_DELAY,
+    BOOT_PHASE_APP_MMU_ON_DELAY,
+
+    BOOT_NUM_PHASES
+} boot_phase_t;
+
+void boot_timeline_start (void);
+void boot_timeline_set_cycle_hz (const uint32_t cycle_hz);
+void boot_timeline_mark (const boot_phase_t phase);
+void boot_timeline_cycle_counter_reset (void);
+bool boot_timeline_overlaps (const uint32_t start_addr, const uint32_t num_bytes);
+void boot_timeline_print (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_TIMELINE_H_ */
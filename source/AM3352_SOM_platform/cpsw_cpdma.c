@@ -0,0 +1,730 @@
+/*
+ * @file cpsw_cpdma.c
+ * @date 16 Oct 2026
+ * @brief CPDMA engine which receives frames from, and transmits frames to, the CPSW host port 0
+ * @details The RX buffer descriptors are placed in the CPPI RAM, which is dedicated memory in the CPSW for buffer descriptors.
+ *          The RX buffer descriptors are permanently queued to the CPDMA, with each descriptor re-queued at the tail of the
+ *          queue once the received frame has been processed.
+ *
+ *          The packet buffers come from the fixed pool in packet_pool.c, which contains more buffers than RX descriptors.
+ *          This allows the RX handler to keep the buffer containing a received frame, with the RX descriptor being
+ *          refilled from the pool.
+ *
+ *          Frames are transmitted as directed packets, which bypass the ALE and are sent to one specific port.
+ *          The TX descriptors follow the RX descriptors in the CPPI RAM. Transmission takes ownership of the buffer,
+ *          which is returned to the pool once the transmission has completed. This allows a received frame to be forwarded
+ *          by passing the buffer from the RX queue to the TX queue without copying the frame contents. A frame may be
+ *          queued on more than one port by adding a reference to the buffer with packet_pool_ref() for each additional
+ *          transmission, since each TX completion drops one reference.
+ *
+ *          Completed descriptors are processed in a NAPI-style poll loop, rather than in the interrupt handlers:
+ *          - The RX and TX completion interrupts only disable themselves and schedule a poll.
+ *          - cpsw_cpdma_poll(), called from the main loop, processes up to a budget of descriptors in each queue per pass
+ *            and writes the completion pointer once per batch. An event driven main loop can register a notify
+ *            function with cpsw_cpdma_set_poll_notify() to be told when a poll has been scheduled.
+ *          - Once a queue has been drained its interrupt is re-enabled.
+ *          The CPSW wrapper interrupt pacing can be used to limit the rate of interrupts when the queues are being drained
+ *          faster than frames arrive.
+ *
+ *          Optionally, selected by cpsw_cpdma_set_rx_fiq(), the RX completion interrupt is routed to FIQ and the RX queue
+ *          is processed up to the budget directly in the FIQ handler. This pre-empts the IRQ handlers and avoids the delay
+ *          until the poll runs, at the cost of the RX handler and cpsw_cpdma_transmit_directed() being called in FIQ
+ *          context. The TX queue is still processed by cpsw_cpdma_poll(), with FIQs disabled while the TX descriptors
+ *          are being completed.
+ *
+ *          The ring logic only accesses the CPDMA through the descriptors and the functions in the "CPDMA register access"
+ *          section, to keep the hardware dependencies in one place.
+ *
+ *          The descriptors are in the CPPI RAM, which is mapped as device memory so doesn't need any cache maintenance.
+ *          The packet buffers may be in cached memory, so every hand off of a buffer between the CPU and the CPDMA uses
+ *          the dma_coherency functions:
+ *          - A buffer is cleaned and invalidated when it is queued for reception.
+ *          - A received frame is invalidated before being passed to the RX handler.
+ *          - A frame is cleaned before being queued for transmission.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "soc_AM335x.h"
+#include "hw_types.h"
+#include "interrupt.h"
+#include "cpsw.h"
+#include "AM3352_SOM.h"
+#include "cpsw_cpdma.h"
+#include "dma_coherency.h"
+#include "packet_pool.h"
+#include "fiq.h"
+
+/** The CPDMA channel used for all received frames */
+#define CPDMA_RX_CHANNEL 0
+
+/** The CPDMA channel used for all transmitted frames */
+#define CPDMA_TX_CHANNEL 0
+
+/** The core used for the CPSW wrapper interrupts */
+#define CPSW_WR_CORE 0
+
+/* Copies of the CPSW wrapper interrupt pacing register definitions from the AM335x TRM */
+#define CPSW_WR_INT_CONTROL_OFFSET      0x0Cu
+#define CPSW_WR_C0_RX_IMAX_OFFSET       0x70u
+#define CPSW_WR_C0_TX_IMAX_OFFSET       0x74u
+#define CPSW_WR_INT_CONTROL_C0_RX_PACE_EN 0x00010000u
+#define CPSW_WR_INT_CONTROL_C0_TX_PACE_EN 0x00020000u
+#define CPSW_WR_INT_CONTROL_PRESCALE_MASK 0x00000FFFu
+
+/** The interrupt pacing prescale, which is the number of CPSW 125 MHz main clock periods in 4 microseconds */
+#define CPSW_WR_INT_PRESCALE_4US (125u * 4u)
+
+/** The range of supported interrupts per millisecond when interrupt pacing is enabled */
+#define CPSW_WR_IMAX_MIN 2u
+#define CPSW_WR_IMAX_MAX 63u
+
+/* Fields in the flags_packet_length word of a CPPI buffer descriptor */
+#define CPDMA_DESC_SOP           0x80000000u /* Start of packet */
+#define CPDMA_DESC_EOP           0x40000000u /* End of packet */
+#define CPDMA_DESC_OWNER         0x20000000u /* Set when the descriptor is owned by the CPDMA */
+#define CPDMA_DESC_EOQ           0x10000000u /* Set by the CPDMA when the descriptor was the end of the queue */
+#define CPDMA_DESC_TDOWNCMPLT    0x08000000u /* Teardown complete */
+#define CPDMA_DESC_PASS_CRC      0x04000000u /* The frame includes the CRC */
+#define CPDMA_DESC_RX_LONG       0x02000000u /* RX frame was longer than RX_MAXLEN */
+#define CPDMA_DESC_RX_SHORT      0x01000000u /* RX frame was shorter than 64 bytes */
+#define CPDMA_DESC_RX_MAC_CTL    0x00800000u /* RX frame is a MAC control frame */
+#define CPDMA_DESC_RX_OVERRUN    0x00400000u /* RX frame was truncated due to a buffer overrun */
+#define CPDMA_DESC_RX_PKT_ERROR  0x00300000u /* RX frame had a CRC, code or alignment error */
+#define CPDMA_DESC_FROM_PORT_MASK  0x00070000u
+#define CPDMA_DESC_FROM_PORT_SHIFT 16
+#define CPDMA_DESC_TX_TO_PORT_EN   0x00100000u /* TX frame is a directed packet sent to TO_PORT */
+#define CPDMA_DESC_TX_TO_PORT_SHIFT 16
+#define CPDMA_DESC_PKT_LEN_MASK  0x000007FFu
+
+/** The length of the Ethernet CRC, which may be included in received frames */
+#define ETHERNET_CRC_LEN 4u
+
+/** The RX descriptor flags which indicate a frame which can't be passed to the RX handler */
+#define CPDMA_DESC_RX_ERRORS (CPDMA_DESC_RX_OVERRUN | CPDMA_DESC_RX_PKT_ERROR)
+
+/** A CPPI 3.0 buffer descriptor, as used by the CPDMA */
+typedef struct cpdma_desc
+{
+    /** The next descriptor in the queue, or NULL for the end of the queue */
+    struct cpdma_desc *volatile next;
+    /** The buffer used to transmit or receive the frame */
+    uint8_t *volatile buffer;
+    /** The buffer offset in bits 26:16 and buffer length in bits 10:0 */
+    volatile uint32_t buffer_offset_length;
+    /** The flags and packet length, using the CPDMA_DESC_* definitions */
+    volatile uint32_t flags_packet_length;
+} cpdma_desc_t;
+
+/** The RX descriptors, allocated at the start of the CPPI RAM */
+static cpdma_desc_t *const rx_descs = (cpdma_desc_t *) SOC_CPSW_CPPI_RAM_REGS;
+
+/** The index into rx_descs[] of the next descriptor expected to be completed by the CPDMA */
+static uint32_t rx_head_index;
+
+/** The descriptor at the tail of the RX queue, to which re-queued descriptors are appended */
+static cpdma_desc_t *rx_tail_desc;
+
+/** The TX descriptors, allocated in the CPPI RAM following the RX descriptors */
+static cpdma_desc_t *const tx_descs = (cpdma_desc_t *) (SOC_CPSW_CPPI_RAM_REGS + (CPDMA_NUM_RX_DESCRIPTORS * sizeof (cpdma_desc_t)));
+
+/** The index into tx_descs[] of the oldest descriptor queued for transmission */
+static uint32_t tx_head_index;
+
+/** The number of TX descriptors queued for transmission, which have yet to be processed for completion */
+static uint32_t tx_num_queued;
+
+/** The descriptor at the tail of the TX queue, or NULL if no frame has been transmitted yet */
+static cpdma_desc_t *tx_tail_desc;
+
+/** The value of the cycle counter at the start of the most recent RX interrupt */
+static uint32_t rx_interrupt_start_cycles;
+
+/** When true the RX completion interrupt is routed to FIQ, and the RX queue processed in the FIQ handler */
+static bool rx_fiq_enabled;
+
+/** Set by the completion interrupts to indicate the queue needs to be processed by cpsw_cpdma_poll() */
+static volatile bool rx_poll_scheduled;
+static volatile bool tx_poll_scheduled;
+
+/** The maximum number of descriptors processed in each queue per call to cpsw_cpdma_poll() */
+static uint32_t poll_budget;
+
+/** Called for each received frame */
+static cpsw_cpdma_rx_handler rx_frame_handler;
+
+/** If non-NULL called when a completion interrupt schedules a poll */
+static volatile cpsw_cpdma_poll_notify poll_notify;
+
+static cpsw_cpdma_statistics_t cpdma_stats;
+
+/******************************************************************************
+**                      CPDMA register access
+*******************************************************************************/
+
+/**
+ * @brief Start the CPDMA processing the RX queue starting at the specified descriptor
+ * @details Must only be called when the CPDMA RX channel is idle
+ * @param[in] desc The head of the RX queue
+ */
+static void cpdma_rx_queue_start (cpdma_desc_t *const desc)
+{
+    CPSWCPDMARxHdrDescPtrWrite (SOC_CPSW_CPDMA_REGS, (unsigned int) (uintptr_t) desc, CPDMA_RX_CHANNEL);
+}
+
+/**
+ * @brief Acknowledge to the CPDMA the RX descriptors which have been processed by software
+ * @param[in] desc The last RX descriptor processed by software
+ */
+static void cpdma_rx_completion_acknowledge (cpdma_desc_t *const desc)
+{
+    CPSWCPDMARxCPWrite (SOC_CPSW_CPDMA_REGS, CPDMA_RX_CHANNEL, (unsigned int) (uintptr_t) desc);
+}
+
+/**
+ * @brief Signal the end of processing of the RX interrupt, and re-enable the interrupt
+ * @details The interrupt is enabled before the end of interrupt is signalled, so that if the CPDMA has completed
+ *          further descriptors the CPSW wrapper generates a new interrupt pulse which is not missed.
+ */
+static void cpdma_rx_end_of_interrupt (void)
+{
+    IntSystemEnable (SYS_INT_3PGSWRXINT0);
+    CPSWCPDMAEndOfIntVectorWrite (SOC_CPSW_CPDMA_REGS, CPSW_EOI_RX_PULSE);
+}
+
+/**
+ * @brief Signal the end of processing of the RX interrupt from the FIQ handler, in which the interrupt remains enabled
+ */
+static void cpdma_rx_fiq_end_of_interrupt (void)
+{
+    CPSWCPDMAEndOfIntVectorWrite (SOC_CPSW_CPDMA_REGS, CPSW_EOI_RX_PULSE);
+}
+
+/**
+ * @brief Start the CPDMA processing the TX queue starting at the specified descriptor
+ * @details Must only be called when the CPDMA TX channel is idle
+ * @param[in] desc The head of the TX queue
+ */
+static void cpdma_tx_queue_start (cpdma_desc_t *const desc)
+{
+    CPSWCPDMATxHdrDescPtrWrite (SOC_CPSW_CPDMA_REGS, (unsigned int) (uintptr_t) desc, CPDMA_TX_CHANNEL);
+}
+
+/**
+ * @brief Acknowledge to the CPDMA the TX descriptors which have been processed by software
+ * @param[in] desc The last TX descriptor processed by software
+ */
+static void cpdma_tx_completion_acknowledge (cpdma_desc_t *const desc)
+{
+    CPSWCPDMATxCPWrite (SOC_CPSW_CPDMA_REGS, CPDMA_TX_CHANNEL, (unsigned int) (uintptr_t) desc);
+}
+
+/**
+ * @brief Signal the end of processing of the TX interrupt, and re-enable the interrupt
+ */
+static void cpdma_tx_end_of_interrupt (void)
+{
+    IntSystemEnable (SYS_INT_3PGSWTXINT0);
+    CPSWCPDMAEndOfIntVectorWrite (SOC_CPSW_CPDMA_REGS, CPSW_EOI_TX_PULSE);
+}
+
+/**
+ * @brief Set the CPSW wrapper interrupt pacing for the RX and TX completion interrupts
+ * @param[in] max_interrupts_per_ms When zero interrupt pacing is disabled. When non-zero the maximum number of
+ *                                  interrupts per millisecond for each of RX and TX, clipped to the supported range.
+ */
+static void cpdma_interrupt_pacing_set (const uint32_t max_interrupts_per_ms)
+{
+    uint32_t int_control = HWREG (SOC_CPSW_WR_REGS + CPSW_WR_INT_CONTROL_OFFSET);
+
+    int_control &= ~(CPSW_WR_INT_CONTROL_C0_RX_PACE_EN | CPSW_WR_INT_CONTROL_C0_TX_PACE_EN |
+                     CPSW_WR_INT_CONTROL_PRESCALE_MASK);
+    if (max_interrupts_per_ms > 0)
+    {
+        uint32_t imax = max_interrupts_per_ms;
+
+        if (imax < CPSW_WR_IMAX_MIN)
+        {
+            imax = CPSW_WR_IMAX_MIN;
+        }
+        else if (imax > CPSW_WR_IMAX_MAX)
+        {
+            imax = CPSW_WR_IMAX_MAX;
+        }
+        HWREG (SOC_CPSW_WR_REGS + CPSW_WR_C0_RX_IMAX_OFFSET) = imax;
+        HWREG (SOC_CPSW_WR_REGS + CPSW_WR_C0_TX_IMAX_OFFSET) = imax;
+        int_control |= CPSW_WR_INT_CONTROL_C0_RX_PACE_EN | CPSW_WR_INT_CONTROL_C0_TX_PACE_EN | CPSW_WR_INT_PRESCALE_4US;
+    }
+    HWREG (SOC_CPSW_WR_REGS + CPSW_WR_INT_CONTROL_OFFSET) = int_control;
+}
+
+/******************************************************************************
+**                      RX queue management
+*******************************************************************************/
+
+/**
+ * @brief Give a RX descriptor to the CPDMA, as the end of a queue
+ * @param[out] desc The descriptor to initialise
+ * @param[in] buffer The buffer to receive the next frame into
+ */
+static void rx_desc_arm (cpdma_desc_t *const desc, uint8_t *const buffer)
+{
+    dma_coherency_before_device_write (buffer, PACKET_POOL_BUFFER_SIZE);
+    desc->next = NULL;
+    desc->buffer = buffer;
+    desc->buffer_offset_length = PACKET_POOL_BUFFER_SIZE;
+    desc->flags_packet_length = CPDMA_DESC_OWNER;
+}
+
+/**
+ * @brief Append a re-armed RX descriptor to the tail of the RX queue
+ * @details If the CPDMA has already reached the end of the queue, which is indicated by the EOQ flag in the previous
+ *          tail descriptor, the CPDMA is restarted from the appended descriptor. The EOQ flag is then cleared so that
+ *          rx_queue_process() doesn't restart the CPDMA a second time.
+ *
+ *          The CPDMA may have read the NULL next pointer of the previous tail, but not yet set EOQ, when the flags are
+ *          checked. That missed end of queue is recovered by rx_queue_process() when it completes the previous tail.
+ * @param[in] desc The descriptor to append
+ */
+static void rx_queue_append (cpdma_desc_t *const desc)
+{
+    cpdma_desc_t *const previous_tail = rx_tail_desc;
+
+    previous_tail->next = desc;
+    rx_tail_desc = desc;
+    if ((previous_tail->flags_packet_length & (CPDMA_DESC_OWNER | CPDMA_DESC_EOQ)) == CPDMA_DESC_EOQ)
+    {
+        previous_tail->flags_packet_length &= ~CPDMA_DESC_EOQ;
+        cpdma_rx_queue_start (desc);
+        cpdma_stats.rx_end_of_queue_restarts++;
+    }
+}
+
+/**
+ * @brief RX completion interrupt handler, which schedules processing of the RX queue
+ */
+static void cpsw_cpdma_rx_isr (void)
+{
+    rx_interrupt_start_cycles = pmu_get_cycle_count ();
+    cpdma_stats.rx_interrupts++;
+    IntSystemDisable (SYS_INT_3PGSWRXINT0);
+    rx_poll_scheduled = true;
+    if (poll_notify != NULL)
+    {
+        poll_notify ();
+    }
+}
+
+/**
+ * @brief Process a batch of RX descriptors which have been completed by the CPDMA
+ * @details Each received frame is passed to the RX handler, and the descriptor re-queued to the CPDMA.
+ *          A received frame is only passed to the RX handler if a replacement buffer is available, so that
+ *          the RX queue never shrinks. The completion pointer is written once for the batch.
+ *
+ *          A completed descriptor with the EOQ flag set and a non-NULL next pointer means the CPDMA stopped after
+ *          reading a NULL next pointer which rx_queue_append() then replaced, so the CPDMA is restarted from the next
+ *          descriptor. Otherwise RX would stop permanently, since later appends only check the new tail.
+ * @param[in] budget The maximum number of descriptors to process
+ * @return The number of descriptors processed. Less than budget means the RX queue has been drained.
+ */
+static uint32_t rx_queue_process (const uint32_t budget)
+{
+    uint32_t num_processed = 0;
+    cpdma_desc_t *last_processed_desc = NULL;
+    cpdma_desc_t *desc = &rx_descs[rx_head_index];
+
+    while ((num_processed < budget) && ((desc->flags_packet_length & CPDMA_DESC_OWNER) == 0))
+    {
+        const uint32_t flags = desc->flags_packet_length;
+        cpdma_desc_t *const next_desc = desc->next;
+        uint8_t *buffer = desc->buffer;
+
+        if (((flags & CPDMA_DESC_EOQ) != 0) && (next_desc != NULL))
+        {
+            cpdma_rx_queue_start (next_desc);
+            cpdma_stats.rx_end_of_queue_restarts++;
+        }
+
+        if ((flags & CPDMA_DESC_RX_ERRORS) != 0)
+        {
+            cpdma_stats.rx_descriptor_errors++;
+        }
+        else
+        {
+            const uint32_t length = (flags & CPDMA_DESC_PKT_LEN_MASK) -
+                    (((flags & CPDMA_DESC_PASS_CRC) != 0) ? ETHERNET_CRC_LEN : 0);
+            const uint32_t from_port = (flags & CPDMA_DESC_FROM_PORT_MASK) >> CPDMA_DESC_FROM_PORT_SHIFT;
+            uint8_t *const replacement_buffer = packet_pool_alloc ();
+
+            cpdma_stats.rx_frames++;
+            cpdma_stats.rx_octets += length;
+            if (replacement_buffer == NULL)
+            {
+                cpdma_stats.rx_no_buffer_discards++;
+            }
+            else
+            {
+                dma_coherency_after_device_write (buffer, length);
+                if (rx_frame_handler (buffer, length, from_port))
+                {
+                    buffer = replacement_buffer;
+                }
+                else
+                {
+                    packet_pool_free (replacement_buffer);
+                }
+            }
+        }
+
+        last_processed_desc = desc;
+        rx_desc_arm (desc, buffer);
+        rx_queue_append (desc);
+
+        rx_head_index = (rx_head_index + 1) % CPDMA_NUM_RX_DESCRIPTORS;
+        desc = &rx_descs[rx_head_index];
+        num_processed++;
+    }
+
+    if (last_processed_desc != NULL)
+    {
+        cpdma_rx_completion_acknowledge (last_processed_desc);
+    }
+
+    return num_processed;
+}
+
+/**
+ * @brief RX completion FIQ handler, which processes the RX queue
+ * @details If the RX queue wasn't drained within the budget the CPSW wrapper generates a new interrupt pulse once
+ *          the end of interrupt has been signalled, so the remaining descriptors are processed by the next FIQ.
+ * @param[in] entry_cycles The value of the cycle counter at the start of the FIQ handler
+ */
+static void cpsw_cpdma_rx_fiq (const uint32_t entry_cycles)
+{
+    rx_interrupt_start_cycles = entry_cycles;
+    cpdma_stats.rx_interrupts++;
+    (void) rx_queue_process (poll_budget);
+    cpdma_stats.rx_fiq_cycles += pmu_get_cycle_count () - entry_cycles;
+    cpdma_rx_fiq_end_of_interrupt ();
+}
+
+/******************************************************************************
+**                      TX queue management
+*******************************************************************************/
+
+/**
+ * @brief Queue a frame for transmission as a directed packet to one CPSW port
+ * @details Must be called from the same context as the RX handler, such as from the RX handler. That context is the
+ *          FIQ handler when the RX completion interrupt is routed to FIQ, otherwise cpsw_cpdma_poll().
+ *          The frame is transmitted from the buffer, without copying, after the frame has been written back from the
+ *          data cache. The CPSW appends the CRC.
+ * @param[in] buffer The buffer containing the frame, which must have been allocated from the pool.
+ *                   On success the caller's reference to the buffer passes to the CPDMA engine, which drops the
+ *                   reference once the transmission has completed.
+ * @param[in] length The length of the frame in bytes, excluding the CRC
+ * @param[in] to_port The CPSW port (1 or 2) to transmit the frame on
+ * @return Returns true if the frame has been queued, or false if all TX descriptors are in use in which case
+ *         the caller retains its reference to the buffer.
+ */
+bool cpsw_cpdma_transmit_directed (uint8_t *const buffer, const uint32_t length, const uint32_t to_port)
+{
+    cpdma_desc_t *desc;
+    cpdma_desc_t *const previous_tail = tx_tail_desc;
+
+    if (tx_num_queued == CPDMA_NUM_TX_DESCRIPTORS)
+    {
+        cpdma_stats.tx_queue_full_discards++;
+        return false;
+    }
+
+    dma_coherency_before_device_read (buffer, length);
+    desc = &tx_descs[(tx_head_index + tx_num_queued) % CPDMA_NUM_TX_DESCRIPTORS];
+    desc->next = NULL;
+    desc->buffer = buffer;
+    desc->buffer_offset_length = length;
+    desc->flags_packet_length = CPDMA_DESC_SOP | CPDMA_DESC_EOP | CPDMA_DESC_OWNER |
+            CPDMA_DESC_TX_TO_PORT_EN | (to_port << CPDMA_DESC_TX_TO_PORT_SHIFT) | length;
+    tx_num_queued++;
+    tx_tail_desc = desc;
+
+    if (previous_tail == NULL)
+    {
+        cpdma_tx_queue_start (desc);
+    }
+    else
+    {
+        /* As for rx_queue_append(), an end of queue missed here is recovered by tx_queue_process() */
+        previous_tail->next = desc;
+        if ((previous_tail->flags_packet_length & (CPDMA_DESC_OWNER | CPDMA_DESC_EOQ)) == CPDMA_DESC_EOQ)
+        {
+            previous_tail->flags_packet_length &= ~CPDMA_DESC_EOQ;
+            cpdma_tx_queue_start (desc);
+            cpdma_stats.tx_end_of_queue_restarts++;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief TX completion interrupt handler, which schedules processing of the TX queue
+ */
+static void cpsw_cpdma_tx_isr (void)
+{
+    cpdma_stats.tx_interrupts++;
+    IntSystemDisable (SYS_INT_3PGSWTXINT0);
+    tx_poll_scheduled = true;
+    if (poll_notify != NULL)
+    {
+        poll_notify ();
+    }
+}
+
+/**
+ * @brief Process a batch of TX descriptors which have been completed by the CPDMA, returning the buffers to the pool
+ * @details The completion pointer is written once for the batch.
+ *          A completed descriptor with the EOQ flag set and a non-NULL next pointer means the CPDMA stopped before
+ *          cpsw_cpdma_transmit_directed() linked the next frame, so the CPDMA is restarted from the next descriptor.
+ *          Otherwise the TX queue would stop permanently and fill up.
+ * @param[in] budget The maximum number of descriptors to process
+ * @return The number of descriptors processed. Less than budget means all completed descriptors have been processed.
+ */
+static uint32_t tx_queue_process (const uint32_t budget)
+{
+    uint32_t num_processed = 0;
+    cpdma_desc_t *last_processed_desc = NULL;
+    cpdma_desc_t *desc = &tx_descs[tx_head_index];
+
+    while ((num_processed < budget) && (tx_num_queued > 0) && ((desc->flags_packet_length & CPDMA_DESC_OWNER) == 0))
+    {
+        cpdma_desc_t *const next_desc = desc->next;
+
+        if (((desc->flags_packet_length & CPDMA_DESC_EOQ) != 0) && (next_desc != NULL))
+        {
+            cpdma_tx_queue_start (next_desc);
+            cpdma_stats.tx_end_of_queue_restarts++;
+        }
+        cpdma_stats.tx_frames++;
+        cpdma_stats.tx_octets += desc->buffer_offset_length & CPDMA_DESC_PKT_LEN_MASK;
+        packet_pool_free (desc->buffer);
+
+        last_processed_desc = desc;
+        tx_num_queued--;
+        tx_head_index = (tx_head_index + 1) % CPDMA_NUM_TX_DESCRIPTORS;
+        desc = &tx_descs[tx_head_index];
+        num_processed++;
+    }
+
+    if (last_processed_desc != NULL)
+    {
+        cpdma_tx_completion_acknowledge (last_processed_desc);
+    }
+
+    return num_processed;
+}
+
+/******************************************************************************
+**                      Poll loop
+*******************************************************************************/
+
+/**
+ * @brief Process the RX and TX queues which have been scheduled by their completion interrupts
+ * @details To be called repeatedly from the main loop. Processes up to the configured budget of descriptors in each
+ *          queue. A queue which has been drained has its completion interrupt re-enabled, otherwise the queue remains
+ *          scheduled for the next call.
+ * @return Returns the number of descriptors processed
+ */
+uint32_t cpsw_cpdma_poll (void)
+{
+    uint32_t num_processed = 0;
+    uint32_t start_cycles;
+
+    if (!rx_poll_scheduled && !tx_poll_scheduled)
+    {
+        return 0;
+    }
+
+    start_cycles = pmu_get_cycle_count ();
+    if (rx_poll_scheduled)
+    {
+        const uint32_t num_rx = rx_queue_process (poll_budget);
+
+        if (num_rx < poll_budget)
+        {
+            rx_poll_scheduled = false;
+            cpdma_rx_end_of_interrupt ();
+        }
+        num_processed += num_rx;
+    }
+
+    if (tx_poll_scheduled)
+    {
+        uint32_t num_tx;
+
+        /* The FIQ handler may queue frames for transmission, which updates the same TX queue state */
+        if (rx_fiq_enabled)
+        {
+            IntMasterFIQDisable ();
+        }
+        num_tx = tx_queue_process (poll_budget);
+        if (rx_fiq_enabled)
+        {
+            IntMasterFIQEnable ();
+        }
+
+        if (num_tx < poll_budget)
+        {
+            tx_poll_scheduled = false;
+            cpdma_tx_end_of_interrupt ();
+        }
+        num_processed += num_tx;
+    }
+
+    cpdma_stats.polls++;
+    cpdma_stats.poll_cycles += pmu_get_cycle_count () - start_cycles;
+
+    return num_processed;
+}
+
+/**
+ * @brief Register a function to be called from the completion interrupts when a poll has been scheduled
+ * @details The notify function is called from interrupt context. After being notified the caller should keep calling
+ *          cpsw_cpdma_poll() until it returns zero, since a queue which wasn't drained by one call remains scheduled
+ *          without a further interrupt.
+ * @param[in] notify The function to call, or NULL to disable notification
+ */
+void cpsw_cpdma_set_poll_notify (cpsw_cpdma_poll_notify notify)
+{
+    poll_notify = notify;
+}
+
+/**
+ * @brief Change the batch size and interrupt pacing used by the CPDMA engine
+ * @details May be called at any time after cpsw_cpdma_init(), from the same context as cpsw_cpdma_poll()
+ * @param[in] budget The maximum number of descriptors processed in each queue per call to cpsw_cpdma_poll().
+ *                   Zero selects CPDMA_DEFAULT_POLL_BUDGET.
+ * @param[in] max_interrupts_per_ms Zero to disable interrupt pacing, or the maximum number of RX and TX interrupts
+ *                                  per millisecond in the range 2..63
+ */
+void cpsw_cpdma_configure (const uint32_t budget, const uint32_t max_interrupts_per_ms)
+{
+    poll_budget = (budget > 0) ? budget : CPDMA_DEFAULT_POLL_BUDGET;
+    cpdma_interrupt_pacing_set (max_interrupts_per_ms);
+}
+
+/**
+ * @brief Select if the RX completion interrupt is routed to FIQ, with the RX queue processed in the FIQ handler
+ * @details Must be called before cpsw_cpdma_init(). When enabled the RX handler is called in FIQ context, so must
+ *          not use floating point and may only share data with other contexts by using lock-free updates.
+ * @param[in] enabled When true the RX completion interrupt is routed to FIQ, otherwise to IRQ
+ */
+void cpsw_cpdma_set_rx_fiq (const bool enabled)
+{
+    rx_fiq_enabled = enabled;
+}
+
+/**
+ * @brief Default RX handler, which discards all frames
+ */
+static bool discard_rx_frame (uint8_t *const buffer, const uint32_t length, const uint32_t from_port)
+{
+    return false;
+}
+
+/**
+ * @brief Initialise the CPDMA to receive frames from, and transmit frames to, the host port
+ * @details RX and TX completion interrupts schedule the queues to be processed by cpsw_cpdma_poll(), unless
+ *          cpsw_cpdma_set_rx_fiq() has selected processing the RX queue in the FIQ handler.
+ *          The default poll budget is used, with interrupt pacing disabled.
+ *          Must be called after the CPSW and CPDMA have been reset, with the AINTC initialised.
+ * @param[in] rx_handler Called for each received frame. If NULL received frames are discarded.
+ */
+void cpsw_cpdma_init (cpsw_cpdma_rx_handler rx_handler)
+{
+    uint32_t desc_index;
+
+    rx_frame_handler = (rx_handler != NULL) ? rx_handler : discard_rx_frame;
+    memset (&cpdma_stats, 0, sizeof (cpdma_stats));
+
+    packet_pool_init ();
+
+    /* Create the initial RX queue containing all RX descriptors */
+    for (desc_index = 0; desc_index < CPDMA_NUM_RX_DESCRIPTORS; desc_index++)
+    {
+        rx_desc_arm (&rx_descs[desc_index], packet_pool_alloc ());
+        if (desc_index > 0)
+        {
+            rx_descs[desc_index - 1].next = &rx_descs[desc_index];
+        }
+    }
+    rx_head_index = 0;
+    rx_tail_desc = &rx_descs[CPDMA_NUM_RX_DESCRIPTORS - 1];
+
+    /* The TX queue is initially empty */
+    tx_head_index = 0;
+    tx_num_queued = 0;
+    tx_tail_desc = NULL;
+
+    rx_poll_scheduled = false;
+    tx_poll_scheduled = false;
+    poll_notify = NULL;
+    cpsw_cpdma_configure (CPDMA_DEFAULT_POLL_BUDGET, 0);
+
+    /* Install the RX completion interrupt handler */
+    if (rx_fiq_enabled)
+    {
+        fiq_install (SYS_INT_3PGSWRXINT0, cpsw_cpdma_rx_fiq);
+    }
+    else
+    {
+        IntRegister (SYS_INT_3PGSWRXINT0, cpsw_cpdma_rx_isr);
+        IntPrioritySet (SYS_INT_3PGSWRXINT0, 0, AINTC_HOSTINT_ROUTE_IRQ);
+    }
+    IntSystemEnable (SYS_INT_3PGSWRXINT0);
+    CPSWCPDMARxIntEnable (SOC_CPSW_CPDMA_REGS, CPDMA_RX_CHANNEL);
+    CPSWWrCoreIntEnable (SOC_CPSW_WR_REGS, CPSW_WR_CORE, CPDMA_RX_CHANNEL, CPSW_CORE_INT_RX_PULSE);
+
+    /* Install the TX completion interrupt handler */
+    IntRegister (SYS_INT_3PGSWTXINT0, cpsw_cpdma_tx_isr);
+    IntPrioritySet (SYS_INT_3PGSWTXINT0, 0, AINTC_HOSTINT_ROUTE_IRQ);
+    IntSystemEnable (SYS_INT_3PGSWTXINT0);
+    CPSWCPDMATxIntEnable (SOC_CPSW_CPDMA_REGS, CPDMA_TX_CHANNEL);
+    CPSWWrCoreIntEnable (SOC_CPSW_WR_REGS, CPSW_WR_CORE, CPDMA_TX_CHANNEL, CPSW_CORE_INT_TX_PULSE);
+
+    /* Start reception and allow transmission */
+    CPSWCPDMATxEnable (SOC_CPSW_CPDMA_REGS);
+    CPSWCPDMARxEnable (SOC_CPSW_CPDMA_REGS);
+    cpdma_rx_queue_start (&rx_descs[0]);
+}
+
+/**
+ * @brief Get the value of the cycle counter at the start of the most recent RX interrupt
+ * @details Allows the RX handler to measure the latency from the RX interrupt which scheduled the poll, or from the
+ *          entry to the FIQ handler when the RX completion interrupt is routed to FIQ.
+ *          Only meaningful when the cycle counter has been enabled by enable_cycle_count().
+ * @return Returns the cycle counter value
+ */
+uint32_t cpsw_cpdma_rx_interrupt_start_cycles (void)
+{
+    return rx_interrupt_start_cycles;
+}
+
+/**
+ * @brief Get the current CPDMA statistics
+ * @details When the RX queue is processed in the FIQ handler FIQs are disabled during the copy, so that the RX
+ *          counters and the 64-bit rx_fiq_cycles are consistent.
+ * @param[out] stats Where to store the current statistics
+ */
+void cpsw_cpdma_get_statistics (cpsw_cpdma_statistics_t *const stats)
+{
+    if (rx_fiq_enabled)
+    {
+        IntMasterFIQDisable ();
+    }
+    *stats = cpdma_stats;
+    if (rx_fiq_enabled)
+    {
+        IntMasterFIQEnable ();
+    }
+}
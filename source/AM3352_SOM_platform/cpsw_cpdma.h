@@ -0,0 +1,91 @@
+/*
+ * @file cpsw_cpdma.h
+ * @date 16 Oct 2026
+ * @brief Interface to the CPDMA engine which services the CPSW host port 0
+ */
+
+#ifndef CPSW_CPDMA_H_
+#define CPSW_CPDMA_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The number of RX buffer descriptors which are queued to the CPDMA */
+#define CPDMA_NUM_RX_DESCRIPTORS 128u
+
+/** The number of TX buffer descriptors, which limits the number of frames which can be queued for transmission */
+#define CPDMA_NUM_TX_DESCRIPTORS 128u
+
+/** The default maximum number of descriptors processed in each of the RX and TX queues per poll */
+#define CPDMA_DEFAULT_POLL_BUDGET 16u
+
+/**
+ * @brief Called from cpsw_cpdma_poll(), or the FIQ handler when selected by cpsw_cpdma_set_rx_fiq(), for each frame
+ *        received on the host port
+ * @param[in] buffer The buffer containing the received frame
+ * @param[in] length The length of the received frame in bytes
+ * @param[in] from_port The CPSW port (1 or 2) the frame was received on
+ * @return Returns true if the handler has taken the reference to buffer, and will later drop it by calling
+ *         packet_pool_free() or by queueing the buffer for transmission. Returns false if the buffer may be re-used
+ *         for reception.
+ */
+typedef bool (*cpsw_cpdma_rx_handler) (uint8_t *const buffer, const uint32_t length, const uint32_t from_port);
+
+/**
+ * @brief Called from the completion interrupts when a poll has been scheduled, so that the poll can be run
+ *        from an event driven main loop rather than by calling cpsw_cpdma_poll() continuously
+ */
+typedef void (*cpsw_cpdma_poll_notify) (void);
+
+/** Statistics maintained by the CPDMA engine */
+typedef struct
+{
+    /** The number of frames received from the host port */
+    uint32_t rx_frames;
+    /** The number of octets in the frames received from the host port */
+    uint32_t rx_octets;
+    /** The number of received frames which were discarded as a buffer couldn't be allocated from the pool
+     *  to replace the one taken by the RX handler */
+    uint32_t rx_no_buffer_discards;
+    /** The number of RX buffer descriptors which the CPDMA flagged as an error */
+    uint32_t rx_descriptor_errors;
+    /** The number of times the RX queue had to be restarted, due to the CPDMA reaching the end of queue */
+    uint32_t rx_end_of_queue_restarts;
+    /** The number of RX interrupts */
+    uint32_t rx_interrupts;
+    /** The number of frames transmitted to the host port, which have been completed by the CPDMA */
+    uint32_t tx_frames;
+    /** The number of octets in the frames transmitted to the host port */
+    uint32_t tx_octets;
+    /** The number of frames which couldn't be transmitted as all TX descriptors were in use */
+    uint32_t tx_queue_full_discards;
+    /** The number of times the TX queue had to be restarted, due to the CPDMA reaching the end of queue */
+    uint32_t tx_end_of_queue_restarts;
+    /** The number of TX interrupts */
+    uint32_t tx_interrupts;
+    /** The number of calls to cpsw_cpdma_poll() which processed a scheduled queue */
+    uint32_t polls;
+    /** The total number of CPU cycles spent processing the queues in cpsw_cpdma_poll() */
+    uint64_t poll_cycles;
+    /** The total number of CPU cycles spent processing the RX queue in the FIQ handler */
+    uint64_t rx_fiq_cycles;
+} cpsw_cpdma_statistics_t;
+
+void cpsw_cpdma_set_rx_fiq (const bool enabled);
+void cpsw_cpdma_init (cpsw_cpdma_rx_handler rx_handler);
+void cpsw_cpdma_configure (const uint32_t budget, const uint32_t max_interrupts_per_ms);
+void cpsw_cpdma_set_poll_notify (cpsw_cpdma_poll_notify notify);
+uint32_t cpsw_cpdma_poll (void);
+bool cpsw_cpdma_transmit_directed (uint8_t *const buffer, const uint32_t length, const uint32_t to_port);
+uint32_t cpsw_cpdma_rx_interrupt_start_cycles (void);
+void cpsw_cpdma_get_statistics (cpsw_cpdma_statistics_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPSW_CPDMA_H_ */
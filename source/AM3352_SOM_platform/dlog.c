@@ -0,0 +1,63 @@
+/*
+ * @file dlog.c
+ * @date 16 Oct 2026
+ * @brief Writes deferred binary logging records to the UART console
+ */
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "AM3352_SOM.h"
+#include "dlog.h"
+
+static dlog_statistics_t dlog_stats;
+
+/**
+ * @brief Write one deferred logging record to the UART console
+ * @details Called by the DLOG() macro. The record is only written if it fits in the console buffer, since a partial
+ *          record would cause the host decoder to lose synchronisation.
+ * @param[in] format_id The identity of the format string, which is its offset in the .dlog_formats section
+ * @param[in] num_args The number of following arguments, each of which is converted to a uint32_t.
+ *                     Only the first DLOG_MAX_ARGS arguments are recorded.
+ */
+void dlog_record (const uint32_t format_id, const uint32_t num_args, ...)
+{
+    const uint32_t record_num_args = (num_args < DLOG_MAX_ARGS) ? num_args : DLOG_MAX_ARGS;
+    uint8_t record[DLOG_RECORD_HEADER_LEN + (DLOG_MAX_ARGS * sizeof (uint32_t))];
+    uint32_t record_len = DLOG_RECORD_HEADER_LEN;
+    uint32_t arg_index;
+    uint32_t arg;
+    va_list args;
+
+    /* The Cortex-A8 is little-endian, so the values can be copied directly into the record */
+    record[0] = DLOG_RECORD_MARKER;
+    record[1] = (uint8_t) record_num_args;
+    memcpy (&record[2], &format_id, sizeof (format_id));
+    va_start (args, num_args);
+    for (arg_index = 0; arg_index < record_num_args; arg_index++)
+    {
+        arg = va_arg (args, uint32_t);
+        memcpy (&record[record_len], &arg, sizeof (arg));
+        record_len += sizeof (arg);
+    }
+    va_end (args);
+
+    if (UARTConsoleTxSpaceGet () >= record_len)
+    {
+        (void) UARTConsoleWrite (record, record_len);
+        dlog_stats.records_written++;
+    }
+    else
+    {
+        dlog_stats.records_discarded++;
+    }
+}
+
+/**
+ * @brief Get the deferred logging statistics
+ * @param[out] stats Where to store the statistics
+ */
+void dlog_get_statistics (dlog_statistics_t *const stats)
+{
+    *stats = dlog_stats;
+}
@@ -0,0 +1,90 @@
+/*
+ * @file dlog.h
+ * @date 16 Oct 2026
+ * @brief Deferred binary logging, where the formatting of log messages is performed by a host tool
+ * @details When DLOG_ENABLED is defined, each DLOG() call site records a binary record containing the identity of the
+ *          format string plus the raw argument values. The format strings are placed in the .dlog_formats section,
+ *          which the linker script must locate at address zero as a non-loaded (INFO) section:
+ *
+ *              .dlog_formats 0 (INFO) : { KEEP(*(.dlog_formats)) }
+ *
+ *          This means the format string identity is the offset of the string in the section of the ELF file, and the
+ *          format strings don't occupy any target memory. The records are written to the UART console, interleaved with
+ *          any text output, and are decoded by the host_tools/dlog_decode program using the ELF file.
+ *
+ *          Each record is:
+ *          - DLOG_RECORD_MARKER byte, which doesn't appear in text output
+ *          - The number of arguments, as a byte
+ *          - The format string identity, as a 32-bit little-endian value
+ *          - The arguments, each as a 32-bit little-endian value
+ *
+ *          The arguments are limited to integer values which fit in 32-bits, and at most DLOG_MAX_ARGS arguments
+ *          which is checked at compile time.
+ *          Since the target memory isn't available to the host tool, %s conversions aren't supported.
+ *
+ *          When DLOG_ENABLED isn't defined, DLOG() formats the message on the target using UARTprintf().
+ *
+ *          DLOG() must only be called from the main-line code, which is the single producer for the console buffer.
+ */
+
+#ifndef DLOG_H_
+#define DLOG_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Marks the start of a binary record in the console output. ASCII Record Separator */
+#define DLOG_RECORD_MARKER 0x1Eu
+
+/** The maximum number of arguments to a DLOG() call */
+#define DLOG_MAX_ARGS 8u
+
+/** The number of bytes in a record header, before the arguments */
+#define DLOG_RECORD_HEADER_LEN 6u
+
+/* The value of DLOG_NUM_ARGS() when a call has more than DLOG_MAX_ARGS arguments */
+#define DLOG_TOO_MANY_ARGS (DLOG_MAX_ARGS + 1u)
+
+/* Count the number of variable arguments, from zero up to DLOG_MAX_ARGS. Between DLOG_MAX_ARGS + 1 and 16 arguments
+ * give DLOG_TOO_MANY_ARGS, so that DLOG() can reject the call at compile time. */
+#define DLOG_NUM_ARGS(...) DLOG_NUM_ARGS_(0, ##__VA_ARGS__, \
+        DLOG_TOO_MANY_ARGS, DLOG_TOO_MANY_ARGS, DLOG_TOO_MANY_ARGS, DLOG_TOO_MANY_ARGS, \
+        DLOG_TOO_MANY_ARGS, DLOG_TOO_MANY_ARGS, DLOG_TOO_MANY_ARGS, DLOG_TOO_MANY_ARGS, \
+        8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NUM_ARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, num_args, ...) \
+        num_args
+
+#ifdef DLOG_ENABLED
+#define DLOG(format, ...) \
+    do \
+    { \
+        static const char dlog_format[] __attribute__((section (".dlog_formats"), used)) = format; \
+        _Static_assert (DLOG_NUM_ARGS (__VA_ARGS__) <= DLOG_MAX_ARGS, "DLOG() has too many arguments"); \
+        dlog_record ((uint32_t) dlog_format, DLOG_NUM_ARGS (__VA_ARGS__), ##__VA_ARGS__); \
+    } while (0)
+#else
+#include "uartStdio.h"
+
+#define DLOG(format, ...) UARTprintf (format, ##__VA_ARGS__)
+#endif
+
+/** Statistics for the deferred logging */
+typedef struct
+{
+    /** The number of records written to the console */
+    uint32_t records_written;
+    /** The number of records discarded as there was insufficient space in the console buffer */
+    uint32_t records_discarded;
+} dlog_statistics_t;
+
+void dlog_record (const uint32_t format_id, const uint32_t num_args, ...);
+void dlog_get_statistics (dlog_statistics_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DLOG_H_ */
@@ -0,0 +1,114 @@
+/*
+ * @file dma_coherency.c
+ * @date 16 Oct 2026
+ * @brief Data cache maintenance performed when a buffer is handed between the CPU and a DMA engine
+ * @details The Cortex-A8 caches aren't coherent with the DMA engines, such as the CPDMA and EDMA3. When a program runs
+ *          with the data cache enabled every hand off of a buffer in cached memory has to be bracketed by one of:
+ *          - dma_coherency_before_device_read() before a DMA engine reads a buffer written by the CPU, which writes
+ *            back any dirty cache lines to memory.
+ *          - dma_coherency_before_device_write() before a DMA engine writes a buffer, which writes back and invalidates
+ *            the cache lines so that a dirty line can't later be evicted over the data written by the DMA.
+ *          - dma_coherency_after_device_write() before the CPU reads a buffer written by a DMA engine, which discards
+ *            any cache lines loaded while the DMA was writing the buffer, e.g. by speculative accesses.
+ *
+ *          The maintenance is by address to the point of coherency, so covers both the L1 and L2 caches. A buffer
+ *          written by DMA should be aligned to DMA_CACHE_LINE_SIZE and sized to a multiple of DMA_CACHE_LINE_SIZE.
+ *
+ *          The maintenance can be disabled at run time, for when the buffers are in memory which isn't cached and so
+ *          the maintenance would only add CPU overhead. Buffers in the DMA pool of the memory map, or descriptors in
+ *          the CPPI RAM, don't need any maintenance.
+ */
+
+#include "cache.h"
+#include "dma_coherency.h"
+
+/** When false the cache maintenance is skipped */
+static volatile bool coherency_enabled = true;
+
+/** The cache lines which have been maintained. Updated from both the main-line and interrupt handlers without
+ *  interrupt masking, so the counts are approximate. */
+static dma_coherency_statistics_t coherency_stats;
+
+/**
+ * @brief Get the number of cache lines which cover a buffer
+ * @param[in] buffer The start of the buffer
+ * @param[in] num_bytes The size of the buffer
+ * @return The number of cache lines
+ */
+static uint32_t num_cache_lines (const void *const buffer, const uint32_t num_bytes)
+{
+    const uint32_t start_addr = (uint32_t) buffer & ~(DMA_CACHE_LINE_SIZE - 1u);
+    const uint32_t end_addr = (uint32_t) buffer + num_bytes;
+
+    return (end_addr - start_addr + (DMA_CACHE_LINE_SIZE - 1u)) / DMA_CACHE_LINE_SIZE;
+}
+
+/**
+ * @brief Enable or disable the cache maintenance
+ * @details The maintenance must be enabled whenever the buffers handed to DMA engines are in cached memory
+ * @param[in] enabled Whether to perform the cache maintenance
+ */
+void dma_coherency_set_enabled (const bool enabled)
+{
+    coherency_enabled = enabled;
+}
+
+/**
+ * @brief Get if the cache maintenance is enabled
+ * @return Returns true if the cache maintenance is performed
+ */
+bool dma_coherency_is_enabled (void)
+{
+    return coherency_enabled;
+}
+
+/**
+ * @brief Write back a buffer written by the CPU to memory, before it is read by a DMA engine
+ * @param[in] buffer The buffer which is to be read by the DMA engine
+ * @param[in] num_bytes The number of bytes to be read by the DMA engine
+ */
+void dma_coherency_before_device_read (const void *const buffer, const uint32_t num_bytes)
+{
+    if (coherency_enabled && (num_bytes > 0))
+    {
+        CacheDataCleanBuff ((unsigned int) buffer, num_bytes);
+        coherency_stats.lines_cleaned += num_cache_lines (buffer, num_bytes);
+    }
+}
+
+/**
+ * @brief Write back and invalidate a buffer, before it is written by a DMA engine
+ * @param[in] buffer The buffer which is to be written by the DMA engine
+ * @param[in] num_bytes The maximum number of bytes which may be written by the DMA engine
+ */
+void dma_coherency_before_device_write (void *const buffer, const uint32_t num_bytes)
+{
+    if (coherency_enabled && (num_bytes > 0))
+    {
+        CacheDataCleanInvalidateBuff ((unsigned int) buffer, num_bytes);
+        coherency_stats.lines_invalidated += num_cache_lines (buffer, num_bytes);
+    }
+}
+
+/**
+ * @brief Invalidate a buffer which has been written by a DMA engine, before it is read by the CPU
+ * @param[in] buffer The buffer which has been written by the DMA engine
+ * @param[in] num_bytes The number of bytes written by the DMA engine
+ */
+void dma_coherency_after_device_write (void *const buffer, const uint32_t num_bytes)
+{
+    if (coherency_enabled && (num_bytes > 0))
+    {
+        CacheDataInvalidateBuff ((unsigned int) buffer, num_bytes);
+        coherency_stats.lines_invalidated += num_cache_lines (buffer, num_bytes);
+    }
+}
+
+/**
+ * @brief Get the cache maintenance statistics
+ * @param[out] stats Where to store the current statistics
+ */
+void dma_coherency_get_statistics (dma_coherency_statistics_t *const stats)
+{
+    *stats = coherency_stats;
+}
@@ -0,0 +1,41 @@
+/*
+ * @file dma_coherency.h
+ * @date 16 Oct 2026
+ * @brief Interface to the data cache maintenance performed when a buffer is handed between the CPU and a DMA engine
+ */
+
+#ifndef DMA_COHERENCY_H_
+#define DMA_COHERENCY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The Cortex-A8 L1 and L2 data cache line size. Buffers written by DMA must be aligned to, and a multiple of, the
+ * cache line size so that no other data shares the cache lines which are invalidated. */
+#define DMA_CACHE_LINE_SIZE 64u
+
+/** Statistics for the cache maintenance */
+typedef struct
+{
+    /** The number of cache lines cleaned before a DMA engine read a buffer */
+    uint32_t lines_cleaned;
+    /** The number of cache lines invalidated before or after a DMA engine wrote a buffer */
+    uint32_t lines_invalidated;
+} dma_coherency_statistics_t;
+
+void dma_coherency_set_enabled (const bool enabled);
+bool dma_coherency_is_enabled (void);
+void dma_coherency_before_device_read (const void *const buffer, const uint32_t num_bytes);
+void dma_coherency_before_device_write (void *const buffer, const uint32_t num_bytes);
+void dma_coherency_after_device_write (void *const buffer, const uint32_t num_bytes);
+void dma_coherency_get_statistics (dma_coherency_statistics_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DMA_COHERENCY_H_ */
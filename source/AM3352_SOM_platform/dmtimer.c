@@ -46,6 +46,13 @@
 #include "hw_types.h"
 #include "hw_dmtimer_1ms.h"
 #include "hw_cm_wkup.h"
+
+/* Copies of the AM335x control module definitions for the SYSBOOT pins latched at reset,
+   of which SYSBOOT[15:14] give the frequency of the crystal which clocks the DMTimer */
+#define CONTROL_STATUS 0x40u
+#define CONTROL_STATUS_SYSBOOT1_CRYSTAL (0x00C00000u)
+#define CONTROL_STATUS_SYSBOOT1_CRYSTAL_SHIFT 22u
+
 /*
  *
  * Note: No pin-muxing is required for DMTimer instances 0,1,2,3. 
@@ -456,3 +463,21 @@ void DMTimer1msModuleClkConfig(unsigned int clkselect) {
             & CM_WKUP_TIMER1_CLKCTRL_IDLEST)
                                          != CM_WKUP_TIMER1_CLKCTRL_IDLEST_FUNC);
 }
+
+/**
+ * @brief Determine the frequency of the crystal which clocks the DMTimer
+ * @details The crystal is also the master oscillator input to the PLLs, and is read from the SYSBOOT pins latched at
+ *          reset, so is valid before the PLLs are configured.
+ * @return The DMTimer frequency in Hz
+ */
+uint32_t get_crystal_hz (void)
+{
+    static const uint32_t crystal_frequencies[] =
+    {
+        19200000u, 24000000u, 25000000u, 26000000u
+    };
+    const uint32_t sysboot = (HWREG (SOC_CONTROL_REGS + CONTROL_STATUS) & CONTROL_STATUS_SYSBOOT1_CRYSTAL) >>
+            CONTROL_STATUS_SYSBOOT1_CRYSTAL_SHIFT;
+
+    return crystal_frequencies[sysboot];
+}
@@ -0,0 +1,117 @@
+/**
+ * \file   edma.c
+ *
+ * \brief  This file contains functions which configure the EDMA3 module.
+ */
+
+/*
+* Copyright (C) 2010 Texas Instruments Incorporated - http://www.ti.com/
+*/
+/*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*    Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*
+*    Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the
+*    distribution.
+*
+*    Neither the name of Texas Instruments Incorporated nor the names of
+*    its contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+*  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+*  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+*  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+*  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+*  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+
+#include "soc_AM335x.h"
+#include "AM3352_SOM.h"
+#include "hw_cm_per.h"
+#include "hw_types.h"
+
+/* Offsets of the TPTC SYSCONFIG registers, which are not defined by the StarterWare headers */
+#define TPTC_SYSCONFIG                 (0x10u)
+#define TPTC_SYSCONFIG_NO_IDLE_NO_STANDBY (0x28u)
+
+/*
+ * \brief This function enables the clocks for the EDMA3 TPCC and TPTC0..2 instances,
+ *        and configures the TPTCs to be in non-idle and non-standby mode.
+ *
+ * \return None.
+ */
+void EDMAModuleClkConfig(void)
+{
+    /* Writing to MODULEMODE field of the CM_PER TPCC and TPTC clock control registers. */
+    HWREG(SOC_CM_PER_REGS + CM_PER_TPCC_CLKCTRL) |=
+                             CM_PER_TPCC_CLKCTRL_MODULEMODE_ENABLE;
+
+    while((HWREG(SOC_CM_PER_REGS + CM_PER_TPCC_CLKCTRL) &
+      CM_PER_TPCC_CLKCTRL_MODULEMODE) != CM_PER_TPCC_CLKCTRL_MODULEMODE_ENABLE);
+
+    HWREG(SOC_CM_PER_REGS + CM_PER_TPTC0_CLKCTRL) |=
+                             CM_PER_TPTC0_CLKCTRL_MODULEMODE_ENABLE;
+
+    while((HWREG(SOC_CM_PER_REGS + CM_PER_TPTC0_CLKCTRL) &
+      CM_PER_TPTC0_CLKCTRL_MODULEMODE) != CM_PER_TPTC0_CLKCTRL_MODULEMODE_ENABLE);
+
+    HWREG(SOC_CM_PER_REGS + CM_PER_TPTC1_CLKCTRL) |=
+                             CM_PER_TPTC1_CLKCTRL_MODULEMODE_ENABLE;
+
+    while((HWREG(SOC_CM_PER_REGS + CM_PER_TPTC1_CLKCTRL) &
+      CM_PER_TPTC1_CLKCTRL_MODULEMODE) != CM_PER_TPTC1_CLKCTRL_MODULEMODE_ENABLE);
+
+    HWREG(SOC_CM_PER_REGS + CM_PER_TPTC2_CLKCTRL) |=
+                             CM_PER_TPTC2_CLKCTRL_MODULEMODE_ENABLE;
+
+    while((HWREG(SOC_CM_PER_REGS + CM_PER_TPTC2_CLKCTRL) &
+      CM_PER_TPTC2_CLKCTRL_MODULEMODE) != CM_PER_TPTC2_CLKCTRL_MODULEMODE_ENABLE);
+
+    /* DMA in non-idle mode */
+    HWREG(SOC_EDMA30TC_0_REGS + TPTC_SYSCONFIG) = TPTC_SYSCONFIG_NO_IDLE_NO_STANDBY;
+    HWREG(SOC_EDMA30TC_1_REGS + TPTC_SYSCONFIG) = TPTC_SYSCONFIG_NO_IDLE_NO_STANDBY;
+    HWREG(SOC_EDMA30TC_2_REGS + TPTC_SYSCONFIG) = TPTC_SYSCONFIG_NO_IDLE_NO_STANDBY;
+
+    /* Waiting for the TPCC and TPTCs to become functional. */
+    while((HWREG(SOC_CM_PER_REGS + CM_PER_TPCC_CLKCTRL) &
+       CM_PER_TPCC_CLKCTRL_IDLEST) != (CM_PER_TPCC_CLKCTRL_IDLEST_FUNC <<
+                                       CM_PER_TPCC_CLKCTRL_IDLEST_SHIFT));
+
+    while((HWREG(SOC_CM_PER_REGS + CM_PER_TPTC0_CLKCTRL) &
+       CM_PER_TPTC0_CLKCTRL_IDLEST) != (CM_PER_TPTC0_CLKCTRL_IDLEST_FUNC <<
+                                        CM_PER_TPTC0_CLKCTRL_IDLEST_SHIFT));
+
+    while((HWREG(SOC_CM_PER_REGS + CM_PER_TPTC0_CLKCTRL) &
+       CM_PER_TPTC0_CLKCTRL_STBYST) != (CM_PER_TPTC0_CLKCTRL_STBYST_FUNC <<
+                                        CM_PER_TPTC0_CLKCTRL_STBYST_SHIFT));
+
+    while((HWREG(SOC_CM_PER_REGS + CM_PER_TPTC1_CLKCTRL) &
+       CM_PER_TPTC1_CLKCTRL_IDLEST) != (CM_PER_TPTC1_CLKCTRL_IDLEST_FUNC <<
+                                        CM_PER_TPTC1_CLKCTRL_IDLEST_SHIFT));
+
+    while((HWREG(SOC_CM_PER_REGS + CM_PER_TPTC1_CLKCTRL) &
+       CM_PER_TPTC1_CLKCTRL_STBYST) != (CM_PER_TPTC1_CLKCTRL_STBYST_FUNC <<
+                                        CM_PER_TPTC1_CLKCTRL_STBYST_SHIFT));
+
+    while((HWREG(SOC_CM_PER_REGS + CM_PER_TPTC2_CLKCTRL) &
+       CM_PER_TPTC2_CLKCTRL_IDLEST) != (CM_PER_TPTC2_CLKCTRL_IDLEST_FUNC <<
+                                        CM_PER_TPTC2_CLKCTRL_IDLEST_SHIFT));
+
+    while((HWREG(SOC_CM_PER_REGS + CM_PER_TPTC2_CLKCTRL) &
+       CM_PER_TPTC2_CLKCTRL_STBYST) != (CM_PER_TPTC2_CLKCTRL_STBYST_FUNC <<
+                                        CM_PER_TPTC2_CLKCTRL_STBYST_SHIFT));
+}
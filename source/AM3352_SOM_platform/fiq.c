@@ -0,0 +1,47 @@
+/*
+ * @file fiq.c
+ * @date 16 Oct 2026
+ * @brief Route one latency critical interrupt to FIQ, so it pre-empts the IRQ handlers
+ * @details All other interrupts are IRQs dispatched by the StarterWare IRQHandler, which runs interrupt handlers
+ *          with IRQs disabled. An interrupt routed to FIQ pre-empts those handlers, e.g. the console and timer
+ *          interrupts, and the handler in fiq_handler.asm calls the installed function directly rather than
+ *          through the AINTC vector table.
+ *
+ *          The startup code only gives FIQ mode an 8 byte stack, so fiq_install() moves the FIQ mode stack to
+ *          fiq_stack[] which is sized by FIQ_STACK_SIZE. The stack must be large enough for the deepest call made by
+ *          the installed function.
+ */
+
+#include "interrupt.h"
+#include "fiq.h"
+
+#ifndef FIQ_STACK_SIZE
+#define FIQ_STACK_SIZE 1024u
+#endif
+
+#if (FIQ_STACK_SIZE % 8) != 0
+#error "FIQ_STACK_SIZE must be a multiple of 8 bytes"
+#endif
+
+/* Defined in fiq_handler.asm */
+extern volatile fiq_function fiq_installed_function;
+void fiq_set_stack (void *const stack_top);
+
+/** The FIQ mode stack. 64-bit elements to give the 8 byte alignment required by the AAPCS. */
+static uint64_t fiq_stack[FIQ_STACK_SIZE / sizeof (uint64_t)];
+
+/**
+ * @brief Route one interrupt to FIQ, and enable FIQs in the CPU
+ * @details Only one interrupt may be routed to FIQ. The caller is responsible for enabling the interrupt in the
+ *          AINTC, and for having initialised the AINTC. Must be called from a privileged mode.
+ * @param[in] int_num The AINTC system interrupt number
+ * @param[in] function Called with FIQ and IRQ disabled for each FIQ. Must not use floating point.
+ */
+void fiq_install (const unsigned int int_num, fiq_function function)
+{
+    IntMasterFIQDisable ();
+    fiq_set_stack (&fiq_stack[FIQ_STACK_SIZE / sizeof (uint64_t)]);
+    fiq_installed_function = function;
+    IntPrioritySet (int_num, 0, AINTC_HOSTINT_ROUTE_FIQ);
+    IntMasterFIQEnable ();
+}
@@ -0,0 +1,28 @@
+/*
+ * @file fiq.h
+ * @date 16 Oct 2026
+ * @brief Interface to route one latency critical interrupt to FIQ, so it pre-empts the IRQ handlers
+ */
+
+#ifndef FIQ_H_
+#define FIQ_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Called from the FIQ handler, with FIQ and IRQ disabled
+ * @param[in] entry_cycles The value of the cycle counter read by the first instruction of the FIQ handler
+ */
+typedef void (*fiq_function) (const uint32_t entry_cycles);
+
+void fiq_install (const unsigned int int_num, fiq_function function);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIQ_H_ */
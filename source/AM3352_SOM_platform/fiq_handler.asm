@@ -0,0 +1,57 @@
+/*
+  @file fiq_handler.asm
+  @date 16 Oct 2026
+  @brief FIQ exception handler, which calls the single function installed by fiq_install()
+  @details Used from the FIQ vector in startup_ARMCA8.S, in place of the StarterWare FIQHandler which doesn't
+           support any FIQ sources. Only one interrupt is routed to FIQ, so the AINTC isn't read to find the active
+           interrupt.
+
+           The handler uses the FIQ mode banked r8-r12 as scratch registers, so that only the registers which the
+           AAPCS allows the installed function to corrupt are saved. The cycle counter is read by the first
+           instruction, and passed to the installed function to allow the interrupt latency to be measured.
+           The VFP registers are not saved, so the installed function must not use floating point.
+*/
+
+/* The AINTC control register, and the bit which allows the next FIQ to be generated */
+        .equ  INTC_CONTROL_ADDR,      0x48200048
+        .equ  INTC_CONTROL_NEWFIQAGR, 0x2
+
+        .bss
+        .align 2
+
+/* The function called for each FIQ, or zero if none has been installed */
+        .global fiq_installed_function
+fiq_installed_function:
+        .space 4
+
+        .text
+        .code 32
+
+/* The FIQ exception handler */
+        .global fiq_handler
+fiq_handler:
+
+        mrc   p15, #0, r8, c9, c13, #0
+        /* r12 is banked, but is saved to keep the stack 8 byte aligned for the installed function */
+        stmfd sp!, {r0-r3, r12, lr}
+        ldr   r9, =fiq_installed_function
+        ldr   r9, [r9]
+        cmp   r9, #0
+        movne r0, r8
+        blxne r9
+        ldr   r8, =INTC_CONTROL_ADDR
+        mov   r9, #INTC_CONTROL_NEWFIQAGR
+        str   r9, [r8]
+        dsb
+        ldmfd sp!, {r0-r3, r12, lr}
+        subs  pc, lr, #4
+
+/* Set the FIQ mode stack pointer to the address in r0. Must be called from a privileged mode with FIQs disabled. */
+        .global fiq_set_stack
+fiq_set_stack:
+
+        mrs   r1, cpsr
+        msr   cpsr_c, #0xD1
+        mov   sp, r0
+        msr   cpsr_c, r1
+        bx    lr
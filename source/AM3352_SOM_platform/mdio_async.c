@@ -0,0 +1,147 @@
+/*
+ * @file mdio_async.c
+ * @date 16 Oct 2026
+ * @brief Interrupt driven MDIO link change detection and non-blocking phy register reads
+ * @details The MDIO module monitors the link status of the phys selected by USERPHYSEL0 and USERPHYSEL1, and raises
+ *          MDIO_LINKINT when the link status changes. MDIO_USERINT is raised when a transaction started through
+ *          USERACCESS1 completes. Both are routed through the CPSW wrapper misc interrupt to the AINTC.
+ *
+ *          The interrupt handler only records which phys had a link change, acknowledges the interrupts and calls the
+ *          notify function. The caller then reads the phy registers one at a time with mdio_async_read_start() and
+ *          mdio_async_read_poll(), so the 1 MHz MDIO transactions never block packet processing.
+ *
+ *          USERACCESS1 is used so that the blocking StarterWare functions, which use USERACCESS0, can still be used
+ *          during initialisation.
+ *
+ *          MDIOInit() must have been called, and the USERPHYSELn registers set to monitor the phys with the
+ *          LINKINTENB bit set, before mdio_async_init().
+ */
+
+#include <stddef.h>
+
+#include "soc_AM335x.h"
+#include "hw_types.h"
+#include "hw_mdio.h"
+#include "interrupt.h"
+#include "cpsw.h"
+#include "AM3352_SOM.h"
+#include "mdio_async.h"
+
+/* Copies of the CPSW wrapper definitions for the core 0 misc interrupt enables */
+#define CPSW_WR_C0_MISC_EN 0x1Cu
+#define CPSW_WR_C0_MISC_EN_MDIO_USERINT 0x01u
+#define CPSW_WR_C0_MISC_EN_MDIO_LINKINT 0x02u
+
+/* The MDIO user interrupt bit for USERACCESS1 */
+#define MDIO_USERINT_USERACCESS1 0x02u
+
+/** Bitmask of phy addresses which have had a link change, set by the interrupt handler */
+static volatile uint32_t link_changes;
+
+/** Called when a link change has been queued or a read has completed */
+static mdio_async_notify async_notify;
+
+/**
+ * @brief Interrupt handler for the CPSW misc interrupt, which handles the MDIO link change and user access
+ *        completion interrupts
+ */
+static void mdio_async_isr (void)
+{
+    const uint32_t link_ints = HWREG (SOC_CPSW_MDIO_REGS + MDIO_LINKINTMASKED);
+    const uint32_t user_ints = HWREG (SOC_CPSW_MDIO_REGS + MDIO_USERINTMASKED);
+    uint32_t changes = 0;
+
+    if ((link_ints & MDIO_LINKINTMASKED_USERPHY0) != 0)
+    {
+        changes |= 1u << (HWREG (SOC_CPSW_MDIO_REGS + MDIO_USERPHYSEL0) & MDIO_USERPHYSEL0_PHYADRMON);
+    }
+    if ((link_ints & MDIO_LINKINTMASKED_USERPHY1) != 0)
+    {
+        changes |= 1u << (HWREG (SOC_CPSW_MDIO_REGS + MDIO_USERPHYSEL1) & MDIO_USERPHYSEL1_PHYADRMON);
+    }
+    if (link_ints != 0)
+    {
+        HWREG (SOC_CPSW_MDIO_REGS + MDIO_LINKINTMASKED) = link_ints;
+        (void) __atomic_fetch_or (&link_changes, changes, __ATOMIC_SEQ_CST);
+    }
+    if (user_ints != 0)
+    {
+        HWREG (SOC_CPSW_MDIO_REGS + MDIO_USERINTMASKED) = user_ints;
+    }
+
+    CPSWCPDMAEndOfIntVectorWrite (SOC_CPSW_CPDMA_REGS, CPSW_EOI_MISC_PULSE);
+    if (async_notify != NULL)
+    {
+        async_notify ();
+    }
+}
+
+/**
+ * @brief Enable the MDIO link change and user access completion interrupts
+ * @details Link changes which occurred before this call are reported once the interrupt is enabled.
+ *          The caller is responsible for having initialised the interrupt controller.
+ * @param[in] notify Called from interrupt context when a link change has been queued or a read has completed.
+ *                   May be NULL, in which case the caller has to poll.
+ */
+void mdio_async_init (mdio_async_notify notify)
+{
+    async_notify = notify;
+    link_changes = 0;
+
+    HWREG (SOC_CPSW_MDIO_REGS + MDIO_USERINTMASKSET) = MDIO_USERINT_USERACCESS1;
+    IntRegister (SYS_INT_3PGSWMISC0, mdio_async_isr);
+    IntPrioritySet (SYS_INT_3PGSWMISC0, 0, AINTC_HOSTINT_ROUTE_IRQ);
+    IntSystemEnable (SYS_INT_3PGSWMISC0);
+    HWREG (SOC_CPSW_WR_REGS + CPSW_WR_C0_MISC_EN) |= CPSW_WR_C0_MISC_EN_MDIO_USERINT | CPSW_WR_C0_MISC_EN_MDIO_LINKINT;
+}
+
+/**
+ * @brief Get and clear the phys which have had a link change
+ * @return Bitmask of the phy addresses which have had a link change since the previous call
+ */
+uint32_t mdio_async_take_link_changes (void)
+{
+    return __atomic_exchange_n (&link_changes, 0, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Start reading a phy register, without waiting for the read to complete
+ * @details Completion is signalled by the notify function, after which mdio_async_read_poll() returns the value
+ * @param[in] phy_address The address of the phy to read
+ * @param[in] reg_num The phy register to read
+ * @return Returns false if a previous read is still in progress, in which case the read hasn't been started
+ */
+bool mdio_async_read_start (const uint32_t phy_address, const uint32_t reg_num)
+{
+    if ((HWREG (SOC_CPSW_MDIO_REGS + MDIO_USERACCESS1) & MDIO_USERACCESS1_GO) != 0)
+    {
+        return false;
+    }
+
+    HWREG (SOC_CPSW_MDIO_REGS + MDIO_USERACCESS1) = MDIO_USERACCESS1_GO |
+            ((reg_num << MDIO_USERACCESS1_REGADR_SHIFT) & MDIO_USERACCESS1_REGADR) |
+            ((phy_address << MDIO_USERACCESS1_PHYADR_SHIFT) & MDIO_USERACCESS1_PHYADR);
+    return true;
+}
+
+/**
+ * @brief Check if the read started by mdio_async_read_start() has completed, without waiting
+ * @param[out] value The register value when MDIO_ASYNC_READ_ACK is returned
+ * @return The state of the read
+ */
+mdio_async_read_status mdio_async_read_poll (uint16_t *const value)
+{
+    const uint32_t user_access = HWREG (SOC_CPSW_MDIO_REGS + MDIO_USERACCESS1);
+
+    if ((user_access & MDIO_USERACCESS1_GO) != 0)
+    {
+        return MDIO_ASYNC_READ_BUSY;
+    }
+    if ((user_access & MDIO_USERACCESS1_ACK) == 0)
+    {
+        return MDIO_ASYNC_READ_NACK;
+    }
+
+    *value = (uint16_t) (user_access & MDIO_USERACCESS1_DATA);
+    return MDIO_ASYNC_READ_ACK;
+}
@@ -0,0 +1,42 @@
+/*
+ * @file mdio_async.h
+ * @date 16 Oct 2026
+ * @brief Interface to interrupt driven MDIO link change detection and non-blocking phy register reads
+ */
+
+#ifndef MDIO_ASYNC_H_
+#define MDIO_ASYNC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Called from the MDIO interrupt when a link change has been queued or a phy register read has completed
+ */
+typedef void (*mdio_async_notify) (void);
+
+/** The state of a phy register read started by mdio_async_read_start() */
+typedef enum
+{
+    /** The read is still in progress */
+    MDIO_ASYNC_READ_BUSY,
+    /** The read has completed, and the phy acknowledged */
+    MDIO_ASYNC_READ_ACK,
+    /** The read has completed, but the phy didn't acknowledge so the value isn't valid */
+    MDIO_ASYNC_READ_NACK
+} mdio_async_read_status;
+
+void mdio_async_init (mdio_async_notify notify);
+uint32_t mdio_async_take_link_changes (void);
+bool mdio_async_read_start (const uint32_t phy_address, const uint32_t reg_num);
+mdio_async_read_status mdio_async_read_poll (uint16_t *const value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MDIO_ASYNC_H_ */
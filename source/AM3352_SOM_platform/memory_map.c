@@ -0,0 +1,204 @@
+/*
+ * @file memory_map.c
+ * @date 16 Oct 2026
+ * @brief The AM3352 SOM memory map, and the encoding of the MMU page table entries for each policy
+ * @details The memory map is declared once here, with each program selecting the policy of each region when its page
+ *          table is generated at build time by host_tools/mmu_page_table. Each region is mapped with 1MB sections
+ *          where the region covers complete sections, and otherwise with second level 64KB large pages or 4KB small
+ *          pages.
+ *
+ *          Only depends upon the standard headers, so is also used by host_tools/mmu_page_table to generate the page
+ *          tables, as well as on the target to change the policy of a region at run time.
+ *
+ *          The page table entries use the ARMv7-A short descriptor format, with the same attributes as the StarterWare
+ *          MMUMemRegionMap(), i.e. in the non-secure state in domain 0 with read/write access in both the privileged
+ *          and user modes. TEX remap is disabled, so the TEX, C and B bits give the memory type directly.
+ */
+
+#include <stdbool.h>
+
+#include "memory_map.h"
+
+/* The first level section entry fields */
+#define SECTION_TYPE       0x00000002u
+#define SECTION_B          0x00000004u
+#define SECTION_C          0x00000008u
+#define SECTION_XN         0x00000010u
+#define SECTION_AP_RW_RW   0x00000C00u
+#define SECTION_TEX_SHIFT  12u
+#define SECTION_NS         0x00080000u
+
+/* The first level page table entry fields, for a section mapped by a second level table */
+#define L2_TABLE_TYPE      0x00000001u
+#define L2_TABLE_NS        0x00000008u
+
+/* The second level large page entry fields */
+#define LARGE_PAGE_TYPE      0x00000001u
+#define LARGE_PAGE_B         0x00000004u
+#define LARGE_PAGE_C         0x00000008u
+#define LARGE_PAGE_AP_RW_RW  0x00000030u
+#define LARGE_PAGE_TEX_SHIFT 12u
+#define LARGE_PAGE_XN        0x00008000u
+
+/* The second level small page entry fields */
+#define SMALL_PAGE_XN        0x00000001u
+#define SMALL_PAGE_TYPE      0x00000002u
+#define SMALL_PAGE_B         0x00000004u
+#define SMALL_PAGE_C         0x00000008u
+#define SMALL_PAGE_AP_RW_RW  0x00000030u
+#define SMALL_PAGE_TEX_SHIFT 6u
+
+/* Normal memory is encoded with TEX[2] set, TEX[1:0] the outer cache policy and C,B the inner cache policy */
+#define CACHE_NONCACHE 0x0u
+#define CACHE_WB_WA    0x1u
+#define CACHE_WT_NOWA  0x2u
+#define CACHE_WB_NOWA  0x3u
+#define NORMAL_TEX(outer) (0x4u | (outer))
+
+/** The memory type of a policy, in the fields which are common to all entry formats */
+typedef struct
+{
+    uint32_t tex;
+    bool c;
+    bool b;
+    bool xn;
+} memory_type_t;
+
+const memory_map_region_t memory_map_regions[MEMORY_MAP_NUM_REGIONS] =
+{
+    [MEMORY_MAP_SRAM] = {"sram", 0x40200000u, 0x00100000u, MEMORY_POLICY_UNMAPPED},
+    [MEMORY_MAP_OCMC] = {"ocmc", 0x40300000u, 0x00100000u, MEMORY_POLICY_NORMAL_WT_WB},
+    [MEMORY_MAP_DEVICE] = {"device", 0x44000000u, 0x3C000000u, MEMORY_POLICY_DEVICE},
+    [MEMORY_MAP_DDR] = {"ddr", 0x80000000u, MEMORY_MAP_DMA_POOL_START - 0x80000000u, MEMORY_POLICY_NORMAL_WT_WB},
+    [MEMORY_MAP_DMA_POOL] = {"dma_pool", MEMORY_MAP_DMA_POOL_START, MEMORY_MAP_DMA_POOL_SIZE, MEMORY_POLICY_NORMAL_NC}
+};
+
+const char *const memory_map_policy_names[MEMORY_NUM_POLICIES] =
+{
+    [MEMORY_POLICY_UNMAPPED] = "unmapped",
+    [MEMORY_POLICY_NORMAL_WT_WB] = "normal_wt_wb",
+    [MEMORY_POLICY_NORMAL_WB] = "normal_wb",
+    [MEMORY_POLICY_NORMAL_WB_NOWA] = "normal_wb_nowa",
+    [MEMORY_POLICY_NORMAL_WT] = "normal_wt",
+    [MEMORY_POLICY_NORMAL_NC] = "normal_nc",
+    [MEMORY_POLICY_DEVICE] = "device",
+    [MEMORY_POLICY_STRONGLY_ORDERED] = "strongly_ordered"
+};
+
+/**
+ * @brief Get the memory type for a policy
+ * @param[in] policy The policy, which is mapped
+ * @return The memory type
+ */
+static memory_type_t get_memory_type (const memory_map_policy_t policy)
+{
+    memory_type_t type = {0, false, false, false};
+    uint32_t inner = CACHE_NONCACHE;
+    uint32_t outer = CACHE_NONCACHE;
+
+    switch (policy)
+    {
+    case MEMORY_POLICY_NORMAL_WT_WB:
+        inner = CACHE_WT_NOWA;
+        outer = CACHE_WB_WA;
+        break;
+    case MEMORY_POLICY_NORMAL_WB:
+        inner = CACHE_WB_WA;
+        outer = CACHE_WB_WA;
+        break;
+    case MEMORY_POLICY_NORMAL_WB_NOWA:
+        inner = CACHE_WB_NOWA;
+        outer = CACHE_WB_NOWA;
+        break;
+    case MEMORY_POLICY_NORMAL_WT:
+        inner = CACHE_WT_NOWA;
+        outer = CACHE_WT_NOWA;
+        break;
+    case MEMORY_POLICY_DEVICE:
+        type.b = true;
+        type.xn = true;
+        return type;
+    case MEMORY_POLICY_STRONGLY_ORDERED:
+    default:
+        return type;
+    }
+
+    /* The normal memory policies, including MEMORY_POLICY_NORMAL_NC */
+    type.tex = NORMAL_TEX (outer);
+    type.c = (inner & 0x2u) != 0;
+    type.b = (inner & 0x1u) != 0;
+    return type;
+}
+
+/**
+ * @brief Encode a first level section entry
+ * @param[in] addr The address of the section
+ * @param[in] policy The policy of the section
+ * @return The page table entry, which is a fault entry for MEMORY_POLICY_UNMAPPED
+ */
+uint32_t memory_map_section_entry (const uint32_t addr, const memory_map_policy_t policy)
+{
+    memory_type_t type;
+
+    if (policy == MEMORY_POLICY_UNMAPPED)
+    {
+        return 0;
+    }
+    type = get_memory_type (policy);
+
+    return (addr & ~(MEMORY_MAP_SECTION_SIZE - 1u)) | SECTION_TYPE | (type.tex << SECTION_TEX_SHIFT) |
+            (type.c ? SECTION_C : 0) | (type.b ? SECTION_B : 0) | (type.xn ? SECTION_XN : 0) |
+            SECTION_AP_RW_RW | SECTION_NS;
+}
+
+/**
+ * @brief Encode a second level large page entry, which has to be repeated in 16 consecutive entries
+ * @param[in] addr The address of the large page
+ * @param[in] policy The policy of the large page
+ * @return The page table entry, which is a fault entry for MEMORY_POLICY_UNMAPPED
+ */
+uint32_t memory_map_large_page_entry (const uint32_t addr, const memory_map_policy_t policy)
+{
+    memory_type_t type;
+
+    if (policy == MEMORY_POLICY_UNMAPPED)
+    {
+        return 0;
+    }
+    type = get_memory_type (policy);
+
+    return (addr & ~(MEMORY_MAP_LARGE_PAGE_SIZE - 1u)) | LARGE_PAGE_TYPE | (type.tex << LARGE_PAGE_TEX_SHIFT) |
+            (type.c ? LARGE_PAGE_C : 0) | (type.b ? LARGE_PAGE_B : 0) | (type.xn ? LARGE_PAGE_XN : 0) |
+            LARGE_PAGE_AP_RW_RW;
+}
+
+/**
+ * @brief Encode a second level small page entry
+ * @param[in] addr The address of the small page
+ * @param[in] policy The policy of the small page
+ * @return The page table entry, which is a fault entry for MEMORY_POLICY_UNMAPPED
+ */
+uint32_t memory_map_small_page_entry (const uint32_t addr, const memory_map_policy_t policy)
+{
+    memory_type_t type;
+
+    if (policy == MEMORY_POLICY_UNMAPPED)
+    {
+        return 0;
+    }
+    type = get_memory_type (policy);
+
+    return (addr & ~(MEMORY_MAP_SMALL_PAGE_SIZE - 1u)) | SMALL_PAGE_TYPE | (type.tex << SMALL_PAGE_TEX_SHIFT) |
+            (type.c ? SMALL_PAGE_C : 0) | (type.b ? SMALL_PAGE_B : 0) | (type.xn ? SMALL_PAGE_XN : 0) |
+            SMALL_PAGE_AP_RW_RW;
+}
+
+/**
+ * @brief Encode a first level entry which points at a second level page table
+ * @param[in] l2_table_addr The address of the 1K aligned second level page table
+ * @return The page table entry
+ */
+uint32_t memory_map_l2_table_entry (const uint32_t l2_table_addr)
+{
+    return l2_table_addr | L2_TABLE_NS | L2_TABLE_TYPE;
+}
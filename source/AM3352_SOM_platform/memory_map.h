@@ -0,0 +1,94 @@
+/*
+ * @file memory_map.h
+ * @date 16 Oct 2026
+ * @brief Interface to the AM3352 SOM memory map, used to generate the MMU page tables
+ * @details Only depends upon the standard headers, so is also used by host_tools/mmu_page_table.
+ */
+
+#ifndef MEMORY_MAP_H_
+#define MEMORY_MAP_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The sizes of the MMU page table mappings. A region is mapped using the largest size its alignment allows. */
+#define MEMORY_MAP_SECTION_SIZE    0x00100000u /* First level 1MB section */
+#define MEMORY_MAP_LARGE_PAGE_SIZE 0x00010000u /* Second level 64KB large page */
+#define MEMORY_MAP_SMALL_PAGE_SIZE 0x00001000u /* Second level 4KB small page */
+
+/* The number of entries in a first level page table, which covers the 4GB address space */
+#define MEMORY_MAP_L1_NUM_ENTRIES 4096u
+#define MEMORY_MAP_L1_ALIGN_SIZE (16u * 1024u)
+
+/* The number of entries in a second level page table, which covers one section */
+#define MEMORY_MAP_L2_NUM_ENTRIES 256u
+#define MEMORY_MAP_L2_ALIGN_SIZE 1024u
+
+/* The memory types and cache policies which can be given to a region */
+typedef enum
+{
+    /* Not mapped, so an access generates an abort */
+    MEMORY_POLICY_UNMAPPED,
+    /* Normal memory with inner write through no write allocate and outer write back write allocate caching, which is
+     * the default cache policy used by the StarterWare examples */
+    MEMORY_POLICY_NORMAL_WT_WB,
+    /* Normal memory with write back write allocate caching for both the inner (L1 and L2) and outer caches */
+    MEMORY_POLICY_NORMAL_WB,
+    MEMORY_POLICY_NORMAL_WB_NOWA,
+    MEMORY_POLICY_NORMAL_WT,
+    MEMORY_POLICY_NORMAL_NC,
+    /* Shareable device memory, which is execute never */
+    MEMORY_POLICY_DEVICE,
+    MEMORY_POLICY_STRONGLY_ORDERED,
+
+    MEMORY_NUM_POLICIES
+} memory_map_policy_t;
+
+/* The regions of the memory map, which don't overlap */
+typedef enum
+{
+    /* The section containing the 64KB internal SRAM, used by the bootloader */
+    MEMORY_MAP_SRAM,
+    /* The section containing the 64KB L3 OCMC RAM */
+    MEMORY_MAP_OCMC,
+    /* The peripherals between the OCMC RAM and DDR */
+    MEMORY_MAP_DEVICE,
+    /* The DDR, apart from the DMA pool at the end */
+    MEMORY_MAP_DDR,
+    /* A pool at the end of the DDR for buffers accessed by DMA, which by default isn't cached */
+    MEMORY_MAP_DMA_POOL,
+
+    MEMORY_MAP_NUM_REGIONS
+} memory_map_region_id_t;
+
+/* The location of the DMA pool, which has to match the linker script of a program which places buffers in the pool */
+#define MEMORY_MAP_DMA_POOL_START 0x9FFC0000u
+#define MEMORY_MAP_DMA_POOL_SIZE  0x00040000u
+
+/** One region of the memory map */
+typedef struct
+{
+    /** The name used to select the policy of the region when generating a page table */
+    const char *name;
+    uint32_t start_addr;
+    uint32_t size;
+    /** The policy used if a program doesn't select a policy for the region */
+    memory_map_policy_t default_policy;
+} memory_map_region_t;
+
+extern const memory_map_region_t memory_map_regions[MEMORY_MAP_NUM_REGIONS];
+extern const char *const memory_map_policy_names[MEMORY_NUM_POLICIES];
+
+uint32_t memory_map_section_entry (const uint32_t addr, const memory_map_policy_t policy);
+uint32_t memory_map_large_page_entry (const uint32_t addr, const memory_map_policy_t policy);
+uint32_t memory_map_small_page_entry (const uint32_t addr, const memory_map_policy_t policy);
+uint32_t memory_map_l2_table_entry (const uint32_t l2_table_addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEMORY_MAP_H_ */
@@ -0,0 +1,666 @@
+/*
+ * @file mmcsd_block.c
+ * @date 16 Oct 2026
+ * @brief MMC/SD block layer, which bounds the time waiting for the controller and retries failures
+ * @details Provides the controller callbacks used by the StarterWare MMC/SD protocol layer in mmcsdlib, for the MMCHS0
+ *          controller with EDMA3 transfers. Replaces the StarterWare HSMMCSDCmdStatusGet() and HSMMCSDXferStatusGet()
+ *          callbacks, which poll the controller status without a timeout so hang if the controller never signals
+ *          completion.
+ *
+ *          Every wait for the controller has a timeout measured with DMTimer6, which free runs from the master
+ *          oscillator. A command or data transfer which times out, or which the controller reports an error for,
+ *          is retried up to MMCSD_BLOCK_MAX_RETRIES times:
+ *          - The first retry resets the controller command and data lines.
+ *          - Subsequent retries soft reset the controller, and then restore the bus width and clock frequency
+ *            which the protocol layer had configured.
+ *          A data transfer is retried by re-sending the data command, preceded by a stop command to return the card
+ *          to the transfer state and by CMD55 if the data command was an application specific command.
+ *          A command response timeout reported by the controller isn't retried, since the protocol layer relies
+ *          upon response timeouts to identify the card type.
+ *
+ *          The worst case time for a command is therefore bounded by the timeouts and number of retries. The latency
+ *          of each command index, and the number of timeouts, errors and retries are recorded.
+ *
+ *          The caller is responsible for cache maintenance of buffers outside of the transfers made by this layer,
+ *          which clean and invalidate the buffer in the data cache around each transfer.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "soc_AM335x.h"
+#include "hw_types.h"
+#include "hw_hs_mmcsd.h"
+#include "hw_edma3cc.h"
+#include "hs_mmcsd.h"
+#include "hs_mmcsdlib.h"
+#include "edma.h"
+#include "cache.h"
+#include "dmtimer.h"
+#include "uartStdio.h"
+#include "AM3352_SOM.h"
+#include "mmcsd_block.h"
+
+/* The maximum number of times a failed command or data transfer is retried */
+#ifndef MMCSD_BLOCK_MAX_RETRIES
+#define MMCSD_BLOCK_MAX_RETRIES 3
+#endif
+
+/* The timeout for a command to complete, which is much longer than the 64 clock command response timeout
+ * applied by the controller */
+#define MMCSD_BLOCK_CMD_TIMEOUT_US 100000u
+
+/* The timeout for a data transfer to complete is the SD card read access time, plus the time to transfer each block
+ * on a 1-bit bus at the 400 kHz identification clock frequency */
+#define MMCSD_BLOCK_DATA_TIMEOUT_US 250000u
+#define MMCSD_BLOCK_DATA_TIMEOUT_PER_BLOCK_US 10000u
+
+/* The MMCHS0 controller used for the SD card, and its EDMA3 events */
+#define MMCSD_BLOCK_BASE SOC_MMCHS_0_REGS
+#define MMCSD_BLOCK_IN_FREQ 96000000u
+#define MMCSD_BLOCK_INIT_FREQ 400000u
+#define MMCSD_BLOCK_DMA_BASE SOC_EDMA30CC_0_REGS
+#define MMCSD_BLOCK_DMA_CHA_TX 24u
+#define MMCSD_BLOCK_DMA_CHA_RX 25u
+#define MMCSD_BLOCK_DMA_QUE_NUM 0u
+#define MMCSD_BLOCK_OCR (SD_OCR_VDD_3P0_3P1 | SD_OCR_VDD_3P1_3P2)
+
+/* The GPIO used for the SD card detect, as used by the StarterWare HSMMCSD examples */
+#define MMCSD_BLOCK_CARD_DETECT_PINNUM 6u
+
+/* The status bits which indicate an error, in the upper half of the MMCHS_STAT register */
+#define MMCSD_STAT_ERRORS 0xFFFF0000u
+
+/* The command index used to prefix an application specific command */
+#define MMCSD_APP_CMD SD_CMD(55)
+
+/* The DMTimer used to measure the timeouts and latency */
+#define MMCSD_BLOCK_TIMER_BASE SOC_DMTIMER_6_REGS
+
+/** The result of waiting for the controller */
+typedef enum
+{
+    WAIT_COMPLETE,
+    WAIT_ERROR,
+    WAIT_TIMEOUT
+} wait_result_t;
+
+/** The parameters of the data transfer set up by the protocol layer, to allow the transfer to be retried */
+typedef struct
+{
+    unsigned char rw_flag;
+    void *ptr;
+    unsigned int blk_size;
+    unsigned int nblks;
+    /** The data command, which is re-sent to retry the transfer */
+    mmcsdCmd cmd;
+    /** When true the data command is an application specific command, so has to be preceded by CMD55 */
+    bool is_app_cmd;
+    /** The argument for the CMD55 which preceded the data command, which contains the card address */
+    unsigned int app_cmd_arg;
+} transfer_t;
+
+static mmcsdCtrlInfo block_ctrl;
+static mmcsdCardInfo block_card;
+
+static mmcsd_block_poll_callback block_poll_callback;
+static mmcsd_block_read_callback block_read_callback;
+
+/** The DMTimer frequency, used to convert between microseconds and timer ticks */
+static uint32_t timer_ticks_per_us;
+
+/** The bus width and clock frequency set by the protocol layer, which are restored after a controller reset */
+static unsigned int configured_bus_width;
+static unsigned int configured_bus_freq;
+
+/** The EDMA3 channel used for the transfer in progress */
+static unsigned int active_dma_channel;
+
+/** The most recent data transfer set up by the protocol layer */
+static transfer_t transfer;
+
+/** The index and argument of the previous command sent by the protocol layer */
+static unsigned int previous_cmd_idx;
+static unsigned int previous_cmd_arg;
+
+/** The controller status which caused the most recent wait to fail */
+static unsigned int failed_status;
+
+/** The result of waiting for the most recent command */
+static wait_result_t command_result;
+
+/** The DMTimer count when the command currently in progress was first sent */
+static uint32_t command_start_ticks;
+
+static mmcsd_block_statistics_t block_stats;
+
+static inline uint32_t timer_ticks (void)
+{
+    return DMTimerCounterGet (MMCSD_BLOCK_TIMER_BASE);
+}
+
+/**
+ * @brief Record the latency of a successful command
+ * @param[in] cmd_idx The index of the command
+ */
+static void record_command_latency (const unsigned int cmd_idx)
+{
+    mmcsd_block_latency_t *const latency = &block_stats.commands[cmd_idx % MMCSD_BLOCK_NUM_COMMANDS];
+    const uint32_t latency_us = (timer_ticks () - command_start_ticks) / timer_ticks_per_us;
+
+    latency->count++;
+    latency->total_us += latency_us;
+    if (latency_us > latency->max_us)
+    {
+        latency->max_us = latency_us;
+    }
+}
+
+/**
+ * @brief Wait for the controller to signal completion, an error or for a timeout
+ * @param[in] complete_mask The status bit which indicates completion
+ * @param[in] timeout_us The timeout for the wait
+ * @param[in] poll When true the poll callback is called while waiting
+ * @return Indicates how the wait completed. On a failure the status is saved in failed_status.
+ */
+static wait_result_t wait_for_status (const unsigned int complete_mask, const uint32_t timeout_us, const bool poll)
+{
+    const uint32_t timeout_ticks = timeout_us * timer_ticks_per_us;
+    const uint32_t start_ticks = timer_ticks ();
+    unsigned int status;
+
+    for (;;)
+    {
+        status = HSMMCSDIntrStatusGet (block_ctrl.memBase, 0xFFFFFFFF);
+        if ((status & complete_mask) != 0)
+        {
+            HSMMCSDIntrStatusClear (block_ctrl.memBase, complete_mask);
+            return WAIT_COMPLETE;
+        }
+        if ((status & HS_MMCSD_STAT_ERR) != 0)
+        {
+            HSMMCSDIntrStatusClear (block_ctrl.memBase, status & (MMCSD_STAT_ERRORS | HS_MMCSD_STAT_ERR));
+            failed_status = status;
+            if ((status & MMCSD_STAT_ERRORS) != HS_MMCSD_STAT_CMDTIMEOUT)
+            {
+                block_stats.errors++;
+            }
+            return WAIT_ERROR;
+        }
+        if ((timer_ticks () - start_ticks) > timeout_ticks)
+        {
+            failed_status = status;
+            block_stats.timeouts++;
+            return WAIT_TIMEOUT;
+        }
+        if (poll && (block_poll_callback != NULL))
+        {
+            block_poll_callback ();
+        }
+    }
+}
+
+/**
+ * @brief Determine if the most recent failed wait can be retried
+ * @details A command response timeout reported by the controller, without any other error, is an expected response
+ *          from a card which doesn't support the command.
+ * @param[in] result The result of the failed wait
+ * @return Returns true if the failure should be retried
+ */
+static bool failure_is_retryable (const wait_result_t result)
+{
+    return (result == WAIT_TIMEOUT) || ((failed_status & MMCSD_STAT_ERRORS) != HS_MMCSD_STAT_CMDTIMEOUT);
+}
+
+/**
+ * @brief Configure the EDMA3 to transfer blocks between memory and the MMC/SD data register
+ * @details Uses AB-synchronised transfers, so each MMC/SD DMA request transfers one block. The data register is
+ *          accessed with a B index of zero, rather than the constant addressing mode.
+ * @param[in] rw_flag 1 for a read from the card, 0 for a write to the card
+ * @param[in] ptr The memory buffer
+ * @param[in] blk_size The block size in bytes
+ * @param[in] nblks The number of blocks
+ */
+static void mmcsd_block_dma_config (const unsigned char rw_flag, void *const ptr, const unsigned int blk_size,
+                                    const unsigned int nblks)
+{
+    const unsigned int data_reg = block_ctrl.memBase + MMCHS_DATA;
+    const unsigned int num_bytes = blk_size * nblks;
+    EDMA3CCPaRAMEntry param_set;
+
+    active_dma_channel = (rw_flag == 1) ? MMCSD_BLOCK_DMA_CHA_RX : MMCSD_BLOCK_DMA_CHA_TX;
+    param_set.opt = EDMA3CC_OPT_SYNCDIM | ((active_dma_channel << EDMA3CC_OPT_TCC_SHIFT) & EDMA3CC_OPT_TCC) |
+            EDMA3CC_OPT_TCINTEN;
+    param_set.srcAddr = (rw_flag == 1) ? data_reg : (unsigned int) ptr;
+    param_set.destAddr = (rw_flag == 1) ? (unsigned int) ptr : data_reg;
+    param_set.aCnt = sizeof (uint32_t);
+    param_set.bCnt = (unsigned short) (blk_size / sizeof (uint32_t));
+    param_set.cCnt = (unsigned short) nblks;
+    param_set.srcBIdx = (rw_flag == 1) ? 0 : sizeof (uint32_t);
+    param_set.destBIdx = (rw_flag == 1) ? sizeof (uint32_t) : 0;
+    param_set.srcCIdx = (rw_flag == 1) ? 0 : (short) blk_size;
+    param_set.destCIdx = (rw_flag == 1) ? (short) blk_size : 0;
+    param_set.linkAddr = 0xFFFF;
+    param_set.bCntReload = 0;
+
+    /* Write back any dirty cache lines covering the buffer before the transfer starts. For a read from the card the
+     * lines are also invalidated, so a dirty line can't later be evicted over the data written by the DMA. */
+    if (rw_flag == 1)
+    {
+        CacheDataCleanInvalidateBuff ((unsigned int) ptr, num_bytes);
+    }
+    else
+    {
+        CacheDataCleanBuff ((unsigned int) ptr, num_bytes);
+    }
+
+    EDMA3ClrIntr (MMCSD_BLOCK_DMA_BASE, active_dma_channel);
+    EDMA3SetPaRAM (MMCSD_BLOCK_DMA_BASE, active_dma_channel, &param_set);
+    EDMA3EnableTransfer (MMCSD_BLOCK_DMA_BASE, active_dma_channel, EDMA3_TRIG_MODE_EVENT);
+}
+
+/**
+ * @brief Arm the EDMA3 and controller for the saved data transfer
+ */
+static void arm_transfer (void)
+{
+    mmcsd_block_dma_config (transfer.rw_flag, transfer.ptr, transfer.blk_size, transfer.nblks);
+    block_ctrl.dmaEnable = 1;
+    HSMMCSDBlkLenSet (block_ctrl.memBase, transfer.blk_size);
+}
+
+/**
+ * @brief Recover the controller after a failure, before a retry
+ * @param[in] retry The retry number, starting from one
+ */
+static void recover_controller (const uint32_t retry)
+{
+    EDMA3DisableTransfer (MMCSD_BLOCK_DMA_BASE, active_dma_channel, EDMA3_TRIG_MODE_EVENT);
+    EDMA3ClrIntr (MMCSD_BLOCK_DMA_BASE, active_dma_channel);
+
+    if (retry == 1)
+    {
+        (void) HSMMCSDLinesReset (block_ctrl.memBase, HS_MMCSD_CMDLINE_RESET | HS_MMCSD_DATALINE_RESET);
+        block_stats.line_resets++;
+    }
+    else
+    {
+        /* The controller initialisation sets a 1-bit bus at the identification frequency */
+        (void) block_ctrl.ctrlInit (&block_ctrl);
+        if (configured_bus_width != 0)
+        {
+            HSMMCSDBusWidthConfig (&block_ctrl, configured_bus_width);
+        }
+        if (configured_bus_freq != 0)
+        {
+            (void) HSMMCSDBusFreqConfig (&block_ctrl, configured_bus_freq);
+        }
+        HSMMCSDIntrStatusEnable (block_ctrl.memBase, block_ctrl.intrMask);
+        block_stats.controller_resets++;
+    }
+    HSMMCSDIntrStatusClear (block_ctrl.memBase, 0xFFFFFFFF);
+}
+
+/**
+ * @brief Wait for a data transfer to complete
+ * @details Waits for both the MMC/SD transfer complete and the EDMA3 completion, so that the last block has been
+ *          written to memory for a read.
+ * @return Indicates how the wait completed
+ */
+static wait_result_t wait_for_transfer (void)
+{
+    const uint32_t timeout_us = MMCSD_BLOCK_DATA_TIMEOUT_US + (transfer.nblks * MMCSD_BLOCK_DATA_TIMEOUT_PER_BLOCK_US);
+    const uint32_t timeout_ticks = timeout_us * timer_ticks_per_us;
+    const unsigned int dma_complete_mask = 1u << active_dma_channel;
+    const uint32_t start_ticks = timer_ticks ();
+    wait_result_t result;
+
+    result = wait_for_status (HS_MMCSD_STAT_TRNFCOMP, timeout_us, true);
+    if (result != WAIT_COMPLETE)
+    {
+        return result;
+    }
+
+    while ((EDMA3GetIntrStatus (MMCSD_BLOCK_DMA_BASE) & dma_complete_mask) == 0)
+    {
+        if ((timer_ticks () - start_ticks) > timeout_ticks)
+        {
+            failed_status = 0;
+            block_stats.timeouts++;
+            return WAIT_TIMEOUT;
+        }
+        if (block_poll_callback != NULL)
+        {
+            block_poll_callback ();
+        }
+    }
+    EDMA3ClrIntr (MMCSD_BLOCK_DMA_BASE, active_dma_channel);
+
+    return WAIT_COMPLETE;
+}
+
+/**
+ * @brief Send a command without any retry, used to recover a failed data transfer
+ * @param[in] idx The command index
+ * @param[in] flags The SD_CMDRSP_* flags
+ * @param[in] arg The command argument
+ * @return Returns 1 if the command completed, or 0 on failure
+ */
+static unsigned int send_recovery_command (const unsigned int idx, const unsigned int flags, const unsigned int arg)
+{
+    mmcsdCmd cmd;
+
+    memset (&cmd, 0, sizeof (cmd));
+    cmd.idx = idx;
+    cmd.flags = flags;
+    cmd.arg = arg;
+
+    return HSMMCSDCmdSend (&block_ctrl, &cmd);
+}
+
+/**
+ * @brief Restart the saved data transfer after the controller has been recovered, and wait for it to complete
+ * @return Indicates how the transfer completed
+ */
+static wait_result_t restart_transfer (void)
+{
+    /* The card may still be sending or receiving a multi-block transfer */
+    block_ctrl.dmaEnable = 0;
+    if (transfer.nblks > 1)
+    {
+        (void) send_recovery_command (SD_CMD(12), SD_CMDRSP_BUSY, 0);
+    }
+    if (transfer.is_app_cmd && (send_recovery_command (MMCSD_APP_CMD, 0, transfer.app_cmd_arg) == 0))
+    {
+        return command_result;
+    }
+
+    arm_transfer ();
+    if (HSMMCSDCmdSend (&block_ctrl, &transfer.cmd) == 0)
+    {
+        return command_result;
+    }
+
+    return wait_for_transfer ();
+}
+
+/**
+ * @brief Called by the MMC/SD protocol layer to set up a data transfer before the command is sent
+ */
+static void mmcsd_block_xfer_setup (mmcsdCtrlInfo *ctrl, unsigned char rwFlag, void *ptr, unsigned int blkSize,
+                                    unsigned int nBlks)
+{
+    (void) ctrl;
+    transfer.rw_flag = rwFlag;
+    transfer.ptr = ptr;
+    transfer.blk_size = blkSize;
+    transfer.nblks = nBlks;
+    arm_transfer ();
+}
+
+/**
+ * @brief Called by the MMC/SD protocol layer to send a command and wait for the response
+ * @details Replaces HSMMCSDCmdSend() in order to retry a failed command. For a data command the data transfer
+ *          is re-armed before the command is re-sent.
+ * @return Returns 1 if the command completed, or 0 on failure
+ */
+static unsigned int mmcsd_block_cmd_send (mmcsdCtrlInfo *ctrl, mmcsdCmd *c)
+{
+    const bool is_app_cmd = (previous_cmd_idx == MMCSD_APP_CMD) && (c->idx != MMCSD_APP_CMD);
+    const bool has_data = (c->flags & SD_CMDRSP_DATA) != 0;
+    unsigned int status;
+    uint32_t retry;
+
+    if (has_data)
+    {
+        transfer.cmd = *c;
+        transfer.is_app_cmd = is_app_cmd;
+        transfer.app_cmd_arg = previous_cmd_arg;
+    }
+
+    command_start_ticks = timer_ticks ();
+    status = HSMMCSDCmdSend (ctrl, c);
+    retry = 0;
+    while ((status == 0) && failure_is_retryable (command_result) && (retry < MMCSD_BLOCK_MAX_RETRIES))
+    {
+        retry++;
+        block_stats.retries++;
+        recover_controller (retry);
+        if (is_app_cmd && (send_recovery_command (MMCSD_APP_CMD, 0, previous_cmd_arg) == 0))
+        {
+            continue;
+        }
+        if (has_data)
+        {
+            arm_transfer ();
+        }
+        status = HSMMCSDCmdSend (ctrl, c);
+    }
+
+    if (status == 0)
+    {
+        if (failure_is_retryable (command_result))
+        {
+            block_stats.failures++;
+        }
+        if (has_data)
+        {
+            EDMA3DisableTransfer (MMCSD_BLOCK_DMA_BASE, active_dma_channel, EDMA3_TRIG_MODE_EVENT);
+            ctrl->dmaEnable = 0;
+        }
+    }
+    else if (!has_data)
+    {
+        record_command_latency (c->idx);
+    }
+
+    previous_cmd_idx = c->idx;
+    previous_cmd_arg = c->arg;
+
+    return status;
+}
+
+/**
+ * @brief Called by HSMMCSDCmdSend() to wait for a command to complete
+ * @return Returns 1 if the command completed, or 0 on an error or timeout
+ */
+static unsigned int mmcsd_block_cmd_status_get (mmcsdCtrlInfo *ctrl)
+{
+    (void) ctrl;
+    command_result = wait_for_status (HS_MMCSD_STAT_CMDCOMP, MMCSD_BLOCK_CMD_TIMEOUT_US, false);
+
+    return (command_result == WAIT_COMPLETE) ? 1 : 0;
+}
+
+/**
+ * @brief Called by the MMC/SD protocol layer to wait for a data transfer to complete
+ * @details A failed transfer is retried by re-sending the data command. Once a read has completed the buffer is
+ *          invalidated in the data cache, and passed to the read callback.
+ * @return Returns 1 if the transfer completed, or 0 if the transfer failed once the retries were exhausted
+ */
+static unsigned int mmcsd_block_xfer_status_get (mmcsdCtrlInfo *ctrl)
+{
+    const unsigned int num_bytes = transfer.blk_size * transfer.nblks;
+    wait_result_t result;
+    uint32_t retry;
+
+    result = wait_for_transfer ();
+    retry = 0;
+    while ((result != WAIT_COMPLETE) && (retry < MMCSD_BLOCK_MAX_RETRIES))
+    {
+        retry++;
+        block_stats.retries++;
+        recover_controller (retry);
+        result = restart_transfer ();
+    }
+    ctrl->dmaEnable = 0;
+
+    if (result != WAIT_COMPLETE)
+    {
+        EDMA3DisableTransfer (MMCSD_BLOCK_DMA_BASE, active_dma_channel, EDMA3_TRIG_MODE_EVENT);
+        block_stats.failures++;
+        return 0;
+    }
+
+    /* Discard any cache lines loaded while the DMA was writing the buffer, e.g. by speculative accesses */
+    if (transfer.rw_flag == 1)
+    {
+        CacheDataInvalidateBuff ((unsigned int) transfer.ptr, num_bytes);
+        if (block_read_callback != NULL)
+        {
+            block_read_callback ((const uint8_t *) transfer.ptr, num_bytes);
+        }
+    }
+    record_command_latency (transfer.cmd.idx);
+
+    return 1;
+}
+
+/**
+ * @brief Called by the MMC/SD protocol layer to enable the controller status bits which are polled.
+ *        The status bits aren't signalled as an interrupt.
+ */
+static void mmcsd_block_intr_enable (mmcsdCtrlInfo *ctrl)
+{
+    HSMMCSDIntrStatusEnable (ctrl->memBase, ctrl->intrMask);
+}
+
+/**
+ * @brief Called by the MMC/SD protocol layer to set the bus width, which is recorded to be restored after a
+ *        controller reset
+ */
+static void mmcsd_block_bus_width_config (mmcsdCtrlInfo *ctrl, unsigned int busWidth)
+{
+    configured_bus_width = busWidth;
+    HSMMCSDBusWidthConfig (ctrl, busWidth);
+}
+
+/**
+ * @brief Called by the MMC/SD protocol layer to set the bus clock frequency, which is recorded to be restored after
+ *        a controller reset
+ */
+static int mmcsd_block_bus_freq_config (mmcsdCtrlInfo *ctrl, unsigned int busFreq)
+{
+    configured_bus_freq = busFreq;
+    return HSMMCSDBusFreqConfig (ctrl, busFreq);
+}
+
+/**
+ * @brief Initialise the MMC/SD controller, EDMA3 channels and timeout timer, ready for the card to be initialised
+ * @details The card is initialised by MMCSDCardInit(), which FatFs calls when the drive is first accessed.
+ * @param[in] poll_callback Called while waiting for data transfers, or NULL
+ * @param[in] read_callback Called as each read from the card completes, or NULL
+ */
+void mmcsd_block_init (const mmcsd_block_poll_callback poll_callback, const mmcsd_block_read_callback read_callback)
+{
+    block_poll_callback = poll_callback;
+    block_read_callback = read_callback;
+    memset (&block_stats, 0, sizeof (block_stats));
+    memset (&transfer, 0, sizeof (transfer));
+    configured_bus_width = 0;
+    configured_bus_freq = 0;
+    previous_cmd_idx = 0;
+    previous_cmd_arg = 0;
+
+    /* Free run the timer from the master oscillator */
+    timer_ticks_per_us = get_crystal_hz () / 1000000u;
+    DMTimer6ModuleClkConfig ();
+    DMTimerDisable (MMCSD_BLOCK_TIMER_BASE);
+    DMTimerReloadSet (MMCSD_BLOCK_TIMER_BASE, 0);
+    DMTimerCounterSet (MMCSD_BLOCK_TIMER_BASE, 0);
+    DMTimerModeConfigure (MMCSD_BLOCK_TIMER_BASE, DMTIMER_AUTORLD_NOCMP_ENABLE);
+    DMTimerEnable (MMCSD_BLOCK_TIMER_BASE);
+
+    EDMAModuleClkConfig ();
+    EDMA3Init (MMCSD_BLOCK_DMA_BASE, MMCSD_BLOCK_DMA_QUE_NUM);
+    EDMA3RequestChannel (MMCSD_BLOCK_DMA_BASE, EDMA3_CHANNEL_TYPE_DMA, MMCSD_BLOCK_DMA_CHA_TX, MMCSD_BLOCK_DMA_CHA_TX,
+                         MMCSD_BLOCK_DMA_QUE_NUM);
+    EDMA3RequestChannel (MMCSD_BLOCK_DMA_BASE, EDMA3_CHANNEL_TYPE_DMA, MMCSD_BLOCK_DMA_CHA_RX, MMCSD_BLOCK_DMA_CHA_RX,
+                         MMCSD_BLOCK_DMA_QUE_NUM);
+
+    memset (&block_ctrl, 0, sizeof (block_ctrl));
+    memset (&block_card, 0, sizeof (block_card));
+    block_ctrl.memBase = MMCSD_BLOCK_BASE;
+    block_ctrl.ctrlInit = HSMMCSDControllerInit;
+    block_ctrl.xferSetup = mmcsd_block_xfer_setup;
+    block_ctrl.cmdStatusGet = mmcsd_block_cmd_status_get;
+    block_ctrl.xferStatusGet = mmcsd_block_xfer_status_get;
+    block_ctrl.cardPresent = HSMMCSDCardPresent;
+    block_ctrl.cmdSend = mmcsd_block_cmd_send;
+    block_ctrl.busWidthConfig = mmcsd_block_bus_width_config;
+    block_ctrl.busFreqConfig = mmcsd_block_bus_freq_config;
+    block_ctrl.intrMask = HS_MMCSD_INTR_CMDCOMP | HS_MMCSD_INTR_CMDTIMEOUT | HS_MMCSD_INTR_DATATIMEOUT |
+            HS_MMCSD_INTR_TRNFCOMP;
+    block_ctrl.intrEnable = mmcsd_block_intr_enable;
+
+    /* Allow the protocol layer to switch the card to a 4-bit bus and high speed mode, once identified */
+    block_ctrl.busWidth = SD_BUS_WIDTH_1BIT | SD_BUS_WIDTH_4BIT;
+    block_ctrl.highspeed = 1;
+    block_ctrl.ocr = MMCSD_BLOCK_OCR;
+    block_ctrl.card = &block_card;
+    block_ctrl.ipClk = MMCSD_BLOCK_IN_FREQ;
+    block_ctrl.opClk = MMCSD_BLOCK_INIT_FREQ;
+    block_ctrl.cdPinNum = MMCSD_BLOCK_CARD_DETECT_PINNUM;
+    block_card.ctrl = &block_ctrl;
+
+    MMCSDCtrlInit (&block_ctrl);
+    MMCSDIntEnable (&block_ctrl);
+}
+
+/**
+ * @return The card, which is passed to FATFsMount()
+ */
+mmcsdCardInfo *mmcsd_block_card (void)
+{
+    return &block_card;
+}
+
+/**
+ * @return The number of data lines which the controller has been configured for
+ */
+unsigned int mmcsd_block_bus_width (void)
+{
+    return ((HWREG (block_ctrl.memBase + MMCHS_HCTL) & MMCHS_HCTL_DTW) != 0) ? 4 : 1;
+}
+
+/**
+ * @return The bus clock frequency in Hz which the controller has been configured for
+ */
+unsigned int mmcsd_block_bus_clock_hz (void)
+{
+    const unsigned int clkd = (HWREG (block_ctrl.memBase + MMCHS_SYSCTL) & MMCHS_SYSCTL_CLKD) >> MMCHS_SYSCTL_CLKD_SHIFT;
+
+    return (clkd > 1) ? (block_ctrl.ipClk / clkd) : block_ctrl.ipClk;
+}
+
+/**
+ * @brief Get the statistics accumulated since mmcsd_block_init()
+ * @param[out] stats The statistics
+ */
+void mmcsd_block_get_statistics (mmcsd_block_statistics_t *const stats)
+{
+    *stats = block_stats;
+}
+
+/**
+ * @brief Display the statistics on the console, with the latency of each command index which has been used
+ */
+void mmcsd_block_print_statistics (void)
+{
+    const mmcsd_block_latency_t *latency;
+    unsigned int cmd_idx;
+
+    UARTprintf ("MMC/SD %u timeouts, %u errors, %u retries, %u line resets, %u controller resets, %u failures\n",
+                (unsigned int) block_stats.timeouts, (unsigned int) block_stats.errors,
+                (unsigned int) block_stats.retries, (unsigned int) block_stats.line_resets,
+                (unsigned int) block_stats.controller_resets, (unsigned int) block_stats.failures);
+    for (cmd_idx = 0; cmd_idx < MMCSD_BLOCK_NUM_COMMANDS; cmd_idx++)
+    {
+        latency = &block_stats.commands[cmd_idx];
+        if (latency->count > 0)
+        {
+            UARTprintf ("CMD%u count %u mean %u us max %u us\n", cmd_idx, (unsigned int) latency->count,
+                        (unsigned int) (latency->total_us / latency->count), (unsigned int) latency->max_us);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * @file mmcsd_block.h
+ * @date 16 Oct 2026
+ * @brief Interface to the MMC/SD block layer, which bounds the time waiting for the controller and retries failures
+ */
+
+#ifndef MMCSD_BLOCK_H_
+#define MMCSD_BLOCK_H_
+
+#include <stdint.h>
+
+#include "mmcsd_proto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The number of MMC/SD command indices, for which the latency is recorded */
+#define MMCSD_BLOCK_NUM_COMMANDS 64u
+
+/* Called while waiting for a data transfer, to allow other processing to overlap the transfer */
+typedef void (*mmcsd_block_poll_callback) (void);
+
+/* Called when a read from the card has been written to memory, and invalidated in the data cache */
+typedef void (*mmcsd_block_read_callback) (const uint8_t *const buffer, const uint32_t num_bytes);
+
+/** The latency of one MMC/SD command index, from sending the command to the completion of any data transfer.
+ *  Includes the time for any retries. */
+typedef struct
+{
+    /** The number of commands which completed successfully */
+    uint32_t count;
+    /** The total and maximum latency of the successful commands */
+    uint32_t total_us;
+    uint32_t max_us;
+} mmcsd_block_latency_t;
+
+typedef struct
+{
+    /** The number of waits for the controller which exceeded the timeout */
+    uint32_t timeouts;
+    /** The number of errors reported by the controller, other than command response timeouts */
+    uint32_t errors;
+    /** The number of times a command or data transfer was retried */
+    uint32_t retries;
+    /** The number of resets of the controller command and data lines */
+    uint32_t line_resets;
+    /** The number of soft resets of the controller */
+    uint32_t controller_resets;
+    /** The number of commands or data transfers which failed once the retries were exhausted */
+    uint32_t failures;
+    mmcsd_block_latency_t commands[MMCSD_BLOCK_NUM_COMMANDS];
+} mmcsd_block_statistics_t;
+
+void mmcsd_block_init (const mmcsd_block_poll_callback poll_callback, const mmcsd_block_read_callback read_callback);
+mmcsdCardInfo *mmcsd_block_card (void);
+unsigned int mmcsd_block_bus_width (void);
+unsigned int mmcsd_block_bus_clock_hz (void);
+void mmcsd_block_get_statistics (mmcsd_block_statistics_t *const stats);
+void mmcsd_block_print_statistics (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MMCSD_BLOCK_H_ */
@@ -0,0 +1,107 @@
+/*
+ * @file mmu_page_table.c
+ * @date 16 Oct 2026
+ * @brief Enables the MMU using a page table generated at build time by host_tools/mmu_page_table
+ * @details The StarterWare MMUInit() and MMUMemRegionMap() fill in the 16K page table at run time, which means
+ *          clearing the table and then writing each section entry one at a time while the caches are disabled.
+ *          With a page table generated at build time the table is already in memory when the program is loaded,
+ *          so enabling the MMU only requires the CP15 configuration and the write of the translation table base.
+ *
+ *          The CP15 configuration is the same as that performed by MMUInit() and MMUEnable(). If the page tables were
+ *          generated as writable the policy of a region of the memory map can be changed at run time with
+ *          mmu_page_table_set_policy().
+ */
+
+#include <stddef.h>
+
+#include "cp15.h"
+#include "mmu_page_table.h"
+
+/* The type field of a first level page table entry */
+#define L1_TYPE_MASK     0x00000003u
+#define L1_TYPE_L2_TABLE 0x00000001u
+
+/* The address of the second level page table in a first level entry */
+#define L1_L2_TABLE_ADDR_MASK 0xFFFFFC00u
+
+/* The type field of a second level page table entry, where bit 0 is the XN bit of a small page */
+#define L2_TYPE_MASK       0x00000003u
+#define L2_TYPE_LARGE_PAGE 0x00000001u
+
+/**
+ * @brief Enable the MMU using a page table which has been generated at build time
+ * @details The caches are not enabled, which is left to the caller.
+ * @param[in] page_table The 16K aligned first level page table
+ */
+void mmu_page_table_enable (const uint32_t *const page_table)
+{
+    CP15TlbInvalidate ();
+
+    /* Use the access permissions in the page table for all domains */
+    CP15DomainAccessClientSet ();
+
+    /* The page table entries use the TEX, C and B bits directly, with AP[0] not used as an access flag */
+    CP15ControlFeatureDisable (CP15_CONTROL_TEXREMAP | CP15_CONTROL_ACCESSFLAG | CP15_CONTROL_ALIGN_CHCK);
+
+    /* Only use TTBR0, which covers the complete address space */
+    CP15TtbCtlTtb0Init ();
+    CP15Ttb0Set ((unsigned int) page_table);
+    CP15MMUEnable ();
+}
+
+/**
+ * @brief Change the policy of one region of the memory map in page tables which were generated as writable
+ * @details The region is changed using the same mapping sizes as the generated page tables. A section which is only
+ *          partly covered by the region can only be changed if it was mapped by a second level page table when the
+ *          page tables were generated, i.e. if the region or one of its neighbours in the section wasn't unmapped.
+ *
+ *          The caller is responsible for cleaning and disabling the caches before changing the policy of cached
+ *          memory, and for invalidating the TLB once the policy has been changed.
+ * @param[in,out] page_table The 16K aligned first level page table
+ * @param[in] region_id Which region of the memory map to change
+ * @param[in] policy The new policy for the region
+ */
+void mmu_page_table_set_policy (uint32_t *const page_table, const memory_map_region_id_t region_id,
+                                const memory_map_policy_t policy)
+{
+    const memory_map_region_t *const region = &memory_map_regions[region_id];
+    const uint64_t region_end = (uint64_t) region->start_addr + region->size;
+    uint64_t addr = region->start_addr;
+    uint64_t section_end;
+    uint64_t end_addr;
+    uint32_t section;
+    uint32_t *l2_table;
+    uint32_t l2_index;
+
+    while (addr < region_end)
+    {
+        section = (uint32_t) (addr / MEMORY_MAP_SECTION_SIZE);
+        section_end = ((uint64_t) section + 1u) * MEMORY_MAP_SECTION_SIZE;
+        end_addr = (region_end < section_end) ? region_end : section_end;
+
+        if ((page_table[section] & L1_TYPE_MASK) == L1_TYPE_L2_TABLE)
+        {
+            /* Change the pages of the region, keeping the page size the entry was generated with */
+            l2_table = (uint32_t *) (size_t) (page_table[section] & L1_L2_TABLE_ADDR_MASK);
+            while (addr < end_addr)
+            {
+                l2_index = (uint32_t) ((addr % MEMORY_MAP_SECTION_SIZE) / MEMORY_MAP_SMALL_PAGE_SIZE);
+                if ((l2_table[l2_index] & L2_TYPE_MASK) == L2_TYPE_LARGE_PAGE)
+                {
+                    l2_table[l2_index] = memory_map_large_page_entry ((uint32_t) addr, policy);
+                }
+                else
+                {
+                    l2_table[l2_index] = memory_map_small_page_entry ((uint32_t) addr, policy);
+                }
+                addr += MEMORY_MAP_SMALL_PAGE_SIZE;
+            }
+        }
+        else if (((addr % MEMORY_MAP_SECTION_SIZE) == 0) && (end_addr == section_end))
+        {
+            page_table[section] = memory_map_section_entry ((uint32_t) addr, policy);
+        }
+
+        addr = end_addr;
+    }
+}
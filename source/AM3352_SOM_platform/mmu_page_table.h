@@ -0,0 +1,29 @@
+/*
+ * @file mmu_page_table.h
+ * @date 16 Oct 2026
+ * @brief Interface to enable the MMU using page tables generated at build time by host_tools/mmu_page_table
+ */
+
+#ifndef MMU_PAGE_TABLE_H_
+#define MMU_PAGE_TABLE_H_
+
+#include <stdint.h>
+
+#include "memory_map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The number of 1MB section entries in the first level page table, which covers the 4GB address space */
+#define MMU_PAGE_TABLE_NUM_ENTRIES 4096u
+
+void mmu_page_table_enable (const uint32_t *const page_table);
+void mmu_page_table_set_policy (uint32_t *const page_table, const memory_map_region_id_t region_id,
+                                const memory_map_policy_t policy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MMU_PAGE_TABLE_H_ */
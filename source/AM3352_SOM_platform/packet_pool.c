@@ -0,0 +1,215 @@
+/*
+ * @file packet_pool.c
+ * @date 16 Oct 2026
+ * @brief Fixed size packet buffer pool, with O(1) lock-free allocation and reference counts
+ * @details The buffers are a static array placed in the .packet_pool section, which the linker script reserves as a
+ *          NOLOAD region. No buffer comes from the heap. Each buffer is PACKET_POOL_BUFFER_SIZE bytes and is aligned
+ *          to the cache line size, so no cache line is shared between buffers and the buffers can be handed to
+ *          DMA engines with the maintenance in dma_coherency.c.
+ *
+ *          The free buffers form a singly linked list of buffer indices. The head of the list is a single 32-bit
+ *          word which combines the index of the first free buffer with a tag which is incremented on every update.
+ *          The head is only updated by a compare-and-swap, so allocation and free are O(1) and lock-free, and may be
+ *          called from any context including interrupt handlers without masking interrupts. The tag prevents the
+ *          ABA problem where an interrupted allocation would otherwise swap in a stale next index.
+ *
+ *          Each buffer has a reference count, set to one when allocated. packet_pool_ref() adds a reference so that
+ *          the same frame may be queued for transmission on multiple ports when flooding, and the buffer is only
+ *          returned to the pool when packet_pool_free() has dropped the last reference.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "dma_coherency.h"
+#include "packet_pool.h"
+
+#ifndef PACKET_POOL_NUM_BUFFERS
+#define PACKET_POOL_NUM_BUFFERS 256u
+#endif
+
+#if (PACKET_POOL_NUM_BUFFERS < 1) || (PACKET_POOL_NUM_BUFFERS >= 0xFFFF)
+#error "PACKET_POOL_NUM_BUFFERS must be between 1 and 65534"
+#endif
+
+#if (PACKET_POOL_BUFFER_SIZE % DMA_CACHE_LINE_SIZE) != 0
+#error "PACKET_POOL_BUFFER_SIZE must be a multiple of the cache line size"
+#endif
+
+/* The buffer index which marks the end of the free list */
+#define FREE_LIST_NIL 0xFFFFu
+
+/* The fields of the free list head word */
+#define FREE_LIST_INDEX_MASK 0x0000FFFFu
+#define FREE_LIST_TAG_SHIFT  16
+#define FREE_LIST_TAG_INC    (1u << FREE_LIST_TAG_SHIFT)
+
+/** The packet buffers, placed in the region reserved by the linker script */
+static uint8_t pool_buffers[PACKET_POOL_NUM_BUFFERS][PACKET_POOL_BUFFER_SIZE]
+    __attribute__((section(".packet_pool"), aligned(DMA_CACHE_LINE_SIZE)));
+
+/** For each free buffer the index of the next free buffer, or FREE_LIST_NIL */
+static uint16_t next_free_index[PACKET_POOL_NUM_BUFFERS];
+
+/** The reference count of each buffer, which is zero while the buffer is free */
+static uint32_t buffer_refcounts[PACKET_POOL_NUM_BUFFERS];
+
+/** The head of the free list, as a tag in the upper 16 bits and the first free buffer index in the lower 16 bits */
+static uint32_t free_list_head;
+
+/** The number of free buffers, and the minimum since the low watermark was reset */
+static uint32_t num_free_buffers;
+static uint32_t low_watermark;
+
+static uint32_t alloc_failures;
+
+/**
+ * @brief Get the index of a buffer in the pool
+ * @param[in] buffer The start of a buffer allocated from the pool
+ * @return The buffer index
+ */
+static uint32_t buffer_index (const uint8_t *const buffer)
+{
+    return (uint32_t) (buffer - pool_buffers[0]) / PACKET_POOL_BUFFER_SIZE;
+}
+
+/**
+ * @brief Push a buffer onto the free list
+ * @param[in] index The index of the buffer which is free
+ */
+static void free_list_push (const uint32_t index)
+{
+    uint32_t old_head;
+    uint32_t new_head;
+
+    /* Counted before the buffer is visible on the free list. Otherwise an interrupting pop could take the buffer
+     * and decrement the count below the true number of free buffers, wrapping it to a huge value when zero. */
+    (void) __atomic_add_fetch (&num_free_buffers, 1u, __ATOMIC_SEQ_CST);
+
+    old_head = __atomic_load_n (&free_list_head, __ATOMIC_SEQ_CST);
+    do
+    {
+        next_free_index[index] = (uint16_t) (old_head & FREE_LIST_INDEX_MASK);
+        new_head = ((old_head & ~FREE_LIST_INDEX_MASK) + FREE_LIST_TAG_INC) | index;
+    } while (!__atomic_compare_exchange_n (&free_list_head, &old_head, new_head, false,
+            __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+}
+
+/**
+ * @brief Pop a buffer from the free list
+ * @return The index of the buffer removed from the free list, or FREE_LIST_NIL if the list is empty
+ */
+static uint32_t free_list_pop (void)
+{
+    uint32_t old_head = __atomic_load_n (&free_list_head, __ATOMIC_SEQ_CST);
+    uint32_t new_head;
+    uint32_t index;
+    uint32_t free_count;
+    uint32_t watermark;
+
+    do
+    {
+        index = old_head & FREE_LIST_INDEX_MASK;
+        if (index == FREE_LIST_NIL)
+        {
+            return FREE_LIST_NIL;
+        }
+        new_head = ((old_head & ~FREE_LIST_INDEX_MASK) + FREE_LIST_TAG_INC) | next_free_index[index];
+    } while (!__atomic_compare_exchange_n (&free_list_head, &old_head, new_head, false,
+            __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+
+    free_count = __atomic_sub_fetch (&num_free_buffers, 1u, __ATOMIC_SEQ_CST);
+    watermark = __atomic_load_n (&low_watermark, __ATOMIC_SEQ_CST);
+    while ((free_count < watermark) &&
+           !__atomic_compare_exchange_n (&low_watermark, &watermark, free_count, false,
+                   __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+    {
+    }
+
+    return index;
+}
+
+/**
+ * @brief Initialise the pool, with all buffers free
+ * @details Must be called before any other function, and while no buffers are in use
+ */
+void packet_pool_init (void)
+{
+    uint32_t index;
+
+    for (index = 0; index < PACKET_POOL_NUM_BUFFERS; index++)
+    {
+        next_free_index[index] = (uint16_t) ((index + 1u < PACKET_POOL_NUM_BUFFERS) ? (index + 1u) : FREE_LIST_NIL);
+        buffer_refcounts[index] = 0;
+    }
+    free_list_head = 0;
+    num_free_buffers = PACKET_POOL_NUM_BUFFERS;
+    low_watermark = PACKET_POOL_NUM_BUFFERS;
+    alloc_failures = 0;
+}
+
+/**
+ * @brief Allocate a buffer from the pool
+ * @details May be called from any context. The buffer is returned with a reference count of one.
+ * @return Returns the allocated buffer, or NULL if the pool is empty
+ */
+uint8_t *packet_pool_alloc (void)
+{
+    const uint32_t index = free_list_pop ();
+
+    if (index == FREE_LIST_NIL)
+    {
+        (void) __atomic_add_fetch (&alloc_failures, 1u, __ATOMIC_SEQ_CST);
+        return NULL;
+    }
+
+    __atomic_store_n (&buffer_refcounts[index], 1u, __ATOMIC_SEQ_CST);
+    return pool_buffers[index];
+}
+
+/**
+ * @brief Add a reference to an allocated buffer
+ * @details Used when the same buffer is handed to more than one owner, e.g. queued for transmission on multiple
+ *          ports. Each owner then calls packet_pool_free() once.
+ * @param[in] buffer The buffer, which must already hold a reference
+ */
+void packet_pool_ref (uint8_t *const buffer)
+{
+    (void) __atomic_add_fetch (&buffer_refcounts[buffer_index (buffer)], 1u, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Drop a reference to a buffer, returning the buffer to the pool when the last reference is dropped
+ * @details May be called from any context
+ * @param[in] buffer The buffer, which must have been allocated from the pool
+ */
+void packet_pool_free (uint8_t *const buffer)
+{
+    const uint32_t index = buffer_index (buffer);
+
+    if (__atomic_sub_fetch (&buffer_refcounts[index], 1u, __ATOMIC_SEQ_CST) == 0)
+    {
+        free_list_push (index);
+    }
+}
+
+/**
+ * @brief Get the pool statistics
+ * @param[out] stats Where to store the current statistics
+ */
+void packet_pool_get_statistics (packet_pool_statistics_t *const stats)
+{
+    stats->num_buffers = PACKET_POOL_NUM_BUFFERS;
+    stats->free_buffers = __atomic_load_n (&num_free_buffers, __ATOMIC_SEQ_CST);
+    stats->low_watermark = __atomic_load_n (&low_watermark, __ATOMIC_SEQ_CST);
+    stats->alloc_failures = __atomic_load_n (&alloc_failures, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Reset the low watermark to the current number of free buffers
+ * @details Allows the low watermark to be reported over an interval, rather than since initialisation
+ */
+void packet_pool_reset_low_watermark (void)
+{
+    __atomic_store_n (&low_watermark, __atomic_load_n (&num_free_buffers, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+}
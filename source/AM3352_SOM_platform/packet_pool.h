@@ -0,0 +1,44 @@
+/*
+ * @file packet_pool.h
+ * @date 16 Oct 2026
+ * @brief Interface to the fixed size packet buffer pool, used for the CPSW frames
+ */
+
+#ifndef PACKET_POOL_H_
+#define PACKET_POOL_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The size of each packet buffer, which is large enough for a maximum length frame with a VLAN tag.
+ *  A multiple of the cache line size. */
+#define PACKET_POOL_BUFFER_SIZE 1536u
+
+/** Statistics for the packet buffer pool */
+typedef struct
+{
+    /** The number of buffers in the pool */
+    uint32_t num_buffers;
+    /** The number of buffers currently free */
+    uint32_t free_buffers;
+    /** The minimum number of free buffers since the low watermark was reset */
+    uint32_t low_watermark;
+    /** The number of allocations which failed as the pool was empty */
+    uint32_t alloc_failures;
+} packet_pool_statistics_t;
+
+void packet_pool_init (void);
+uint8_t *packet_pool_alloc (void);
+void packet_pool_ref (uint8_t *const buffer);
+void packet_pool_free (uint8_t *const buffer);
+void packet_pool_get_statistics (packet_pool_statistics_t *const stats);
+void packet_pool_reset_low_watermark (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PACKET_POOL_H_ */
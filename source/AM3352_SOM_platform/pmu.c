@@ -0,0 +1,249 @@
+/*
+ * @file pmu.c
+ * @date 16 Oct 2026
+ * @brief Cortex-A8 Performance Monitoring Unit event counters
+ * @details Provides access to the four event counters in addition to the cycle counter, which is enabled
+ *          by enable_cycle_count() in sys_pmu.asm.
+ *
+ *          The hardware counters are 32 bits. When pmu_overflow_interrupt_enable() has been called the PMU
+ *          overflow interrupt increments a software high word for each counter, and pmu_counters_read() returns
+ *          64-bit values. Without the interrupt the values are only valid for up to one wrap of the 32-bit counters.
+ *
+ *          The cycle counter is never reset by this module, since pmu_get_cycle_count() is used as a free running
+ *          timestamp. Measurements are therefore made by taking the difference between two snapshots.
+ */
+
+#include "soc_AM335x.h"
+#include "interrupt.h"
+#include "AM3352_SOM.h"
+#include "pmu.h"
+
+/* The AINTC interrupt for the Cortex-A8 PMU, which is named BENCH in the AM335x TRM */
+#ifndef SYS_INT_BENCH
+#define SYS_INT_BENCH 3
+#endif
+
+/* Copies of the ARMv7 PMU register bit definitions */
+#define PMCR_E 0x00000001u /* Enable all counters */
+#define PMCR_P 0x00000002u /* Reset the event counters */
+#define PMU_CYCLE_COUNTER_BIT 0x80000000u
+#define PMU_EVENT_COUNTERS_MASK ((1u << PMU_NUM_EVENT_COUNTERS) - 1u)
+#define PMU_ALL_COUNTERS_MASK (PMU_CYCLE_COUNTER_BIT | PMU_EVENT_COUNTERS_MASK)
+
+/** The software high words of the cycle counter and the event counters, incremented by the overflow interrupt */
+static volatile uint32_t cycle_counter_high;
+static volatile uint32_t event_counter_high[PMU_NUM_EVENT_COUNTERS];
+
+/*
+ * PMU register access
+ */
+static inline uint32_t pmu_read_pmcr (void)
+{
+    uint32_t value;
+
+    __asm__ volatile ("mrc p15, 0, %0, c9, c12, 0" : "=r" (value));
+    return value;
+}
+
+static inline void pmu_write_pmcr (const uint32_t value)
+{
+    __asm__ volatile ("mcr p15, 0, %0, c9, c12, 0" : : "r" (value));
+}
+
+static inline void pmu_write_pmcntenset (const uint32_t value)
+{
+    __asm__ volatile ("mcr p15, 0, %0, c9, c12, 1" : : "r" (value));
+}
+
+static inline void pmu_write_pmcntenclr (const uint32_t value)
+{
+    __asm__ volatile ("mcr p15, 0, %0, c9, c12, 2" : : "r" (value));
+}
+
+static inline uint32_t pmu_read_pmovsr (void)
+{
+    uint32_t value;
+
+    __asm__ volatile ("mrc p15, 0, %0, c9, c12, 3" : "=r" (value));
+    return value;
+}
+
+static inline void pmu_write_pmovsr (const uint32_t value)
+{
+    __asm__ volatile ("mcr p15, 0, %0, c9, c12, 3" : : "r" (value));
+}
+
+static inline void pmu_write_pmselr (const uint32_t value)
+{
+    __asm__ volatile ("mcr p15, 0, %0, c9, c12, 5" : : "r" (value));
+    __asm__ volatile ("isb");
+}
+
+static inline void pmu_write_pmxevtyper (const uint32_t value)
+{
+    __asm__ volatile ("mcr p15, 0, %0, c9, c13, 1" : : "r" (value));
+}
+
+static inline uint32_t pmu_read_pmxevcntr (void)
+{
+    uint32_t value;
+
+    __asm__ volatile ("mrc p15, 0, %0, c9, c13, 2" : "=r" (value));
+    return value;
+}
+
+static inline void pmu_write_pmintenset (const uint32_t value)
+{
+    __asm__ volatile ("mcr p15, 0, %0, c9, c14, 1" : : "r" (value));
+}
+
+/**
+ * @brief Read one event counter
+ * @param[in] counter Which event counter to read
+ * @return The 32-bit event counter value
+ */
+static uint32_t pmu_read_event_counter (const uint32_t counter)
+{
+    pmu_write_pmselr (counter);
+    return pmu_read_pmxevcntr ();
+}
+
+/**
+ * @brief Interrupt handler for PMU counter overflow, which extends the counters to 64 bits
+ */
+static void pmu_overflow_isr (void)
+{
+    const uint32_t overflows = pmu_read_pmovsr ();
+    uint32_t counter;
+
+    pmu_write_pmovsr (overflows);
+    if ((overflows & PMU_CYCLE_COUNTER_BIT) != 0)
+    {
+        cycle_counter_high++;
+    }
+    for (counter = 0; counter < PMU_NUM_EVENT_COUNTERS; counter++)
+    {
+        if ((overflows & (1u << counter)) != 0)
+        {
+            event_counter_high[counter]++;
+        }
+    }
+}
+
+/**
+ * @brief Extend a 32-bit counter value to 64 bits using its software high word
+ * @details Handles the counter overflowing while being read, and the counter having overflowed but the interrupt
+ *          not yet having been serviced (e.g. when called with interrupts disabled).
+ *          The overflow flag is only taken as applying to the low word read when the low word is in the lower half of
+ *          its range, i.e. has recently wrapped.
+ * @param[in] high The software high word of the counter
+ * @param[in] overflow_bit The bit for the counter in the overflow flag status register
+ * @param[in] counter The event counter number, or PMU_NUM_EVENT_COUNTERS for the cycle counter
+ * @return The 64-bit counter value
+ */
+static uint64_t pmu_extend_counter (volatile uint32_t *const high, const uint32_t overflow_bit, const uint32_t counter)
+{
+    uint32_t high_before;
+    uint32_t low;
+    uint32_t overflowed;
+
+    do
+    {
+        high_before = *high;
+        low = (counter < PMU_NUM_EVENT_COUNTERS) ? pmu_read_event_counter (counter) : pmu_get_cycle_count ();
+        overflowed = pmu_read_pmovsr () & overflow_bit;
+    } while (high_before != *high);
+
+    if ((overflowed != 0) && (low < 0x80000000u))
+    {
+        high_before++;
+    }
+
+    return ((uint64_t) high_before << 32) | low;
+}
+
+/**
+ * @brief Enable the PMU overflow interrupt, so that the counters are extended to 64 bits
+ * @details The caller is responsible for enabling IRQs in the CPU
+ */
+void pmu_overflow_interrupt_enable (void)
+{
+    pmu_write_pmovsr (PMU_ALL_COUNTERS_MASK);
+    IntRegister (SYS_INT_BENCH, pmu_overflow_isr);
+    IntPrioritySet (SYS_INT_BENCH, 0, AINTC_HOSTINT_ROUTE_IRQ);
+    IntSystemEnable (SYS_INT_BENCH);
+    pmu_write_pmintenset (PMU_ALL_COUNTERS_MASK);
+}
+
+/**
+ * @brief Program the events counted by the event counters
+ * @details The event counters are stopped and reset to zero. The cycle counter is unaffected.
+ * @param[in] event_set The events to count, one per event counter
+ */
+void pmu_event_counters_configure (const pmu_event_set_t *const event_set)
+{
+    uint32_t counter;
+
+    pmu_event_counters_stop ();
+    for (counter = 0; counter < PMU_NUM_EVENT_COUNTERS; counter++)
+    {
+        pmu_write_pmselr (counter);
+        pmu_write_pmxevtyper (event_set->events[counter]);
+    }
+
+    pmu_write_pmcr (pmu_read_pmcr () | PMCR_E | PMCR_P);
+    pmu_write_pmovsr (PMU_EVENT_COUNTERS_MASK);
+    for (counter = 0; counter < PMU_NUM_EVENT_COUNTERS; counter++)
+    {
+        event_counter_high[counter] = 0;
+    }
+}
+
+/**
+ * @brief Start all the event counters counting, as a set
+ */
+void pmu_event_counters_start (void)
+{
+    pmu_write_pmcntenset (PMU_EVENT_COUNTERS_MASK);
+}
+
+/**
+ * @brief Stop all the event counters counting, as a set. The cycle counter is unaffected.
+ */
+void pmu_event_counters_stop (void)
+{
+    pmu_write_pmcntenclr (PMU_EVENT_COUNTERS_MASK);
+}
+
+/**
+ * @brief Read a snapshot of the cycle counter and the event counters
+ * @param[out] counters The 64-bit counter values
+ */
+void pmu_counters_read (pmu_counters_t *const counters)
+{
+    uint32_t counter;
+
+    counters->cycles = pmu_extend_counter (&cycle_counter_high, PMU_CYCLE_COUNTER_BIT, PMU_NUM_EVENT_COUNTERS);
+    for (counter = 0; counter < PMU_NUM_EVENT_COUNTERS; counter++)
+    {
+        counters->events[counter] = pmu_extend_counter (&event_counter_high[counter], 1u << counter, counter);
+    }
+}
+
+/**
+ * @brief Calculate the difference between two counter snapshots
+ * @param[in] start The snapshot at the start of the measurement
+ * @param[in] end The snapshot at the end of the measurement
+ * @param[out] difference The counts during the measurement
+ */
+void pmu_counters_difference (const pmu_counters_t *const start, const pmu_counters_t *const end,
+                              pmu_counters_t *const difference)
+{
+    uint32_t counter;
+
+    difference->cycles = end->cycles - start->cycles;
+    for (counter = 0; counter < PMU_NUM_EVENT_COUNTERS; counter++)
+    {
+        difference->events[counter] = end->events[counter] - start->events[counter];
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * @file pmu.h
+ * @date 16 Oct 2026
+ * @brief Interface to the Cortex-A8 Performance Monitoring Unit event counters
+ */
+
+#ifndef PMU_H_
+#define PMU_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The number of configurable event counters in the Cortex-A8 PMU */
+#define PMU_NUM_EVENT_COUNTERS 4u
+
+/** The events which can be counted. The common ARMv7 events, followed by the Cortex-A8 specific events. */
+typedef enum
+{
+    PMU_EVENT_SOFTWARE_INCREMENT              = 0x00,
+    PMU_EVENT_L1I_CACHE_REFILL                = 0x01,
+    PMU_EVENT_ITLB_REFILL                     = 0x02,
+    PMU_EVENT_L1D_CACHE_REFILL                = 0x03,
+    PMU_EVENT_L1D_CACHE_ACCESS                = 0x04,
+    PMU_EVENT_DTLB_REFILL                     = 0x05,
+    PMU_EVENT_DATA_READ                       = 0x06,
+    PMU_EVENT_DATA_WRITE                      = 0x07,
+    PMU_EVENT_INSTRUCTION_EXECUTED            = 0x08,
+    PMU_EVENT_EXCEPTION_TAKEN                 = 0x09,
+    PMU_EVENT_EXCEPTION_RETURN                = 0x0A,
+    PMU_EVENT_CONTEXTIDR_WRITE                = 0x0B,
+    PMU_EVENT_SOFTWARE_PC_CHANGE              = 0x0C,
+    PMU_EVENT_IMMEDIATE_BRANCH                = 0x0D,
+    PMU_EVENT_PROCEDURE_RETURN                = 0x0E,
+    PMU_EVENT_UNALIGNED_ACCESS                = 0x0F,
+    PMU_EVENT_BRANCH_MISPREDICTED             = 0x10,
+    PMU_EVENT_CYCLE                           = 0x11,
+    PMU_EVENT_BRANCH_PREDICTABLE              = 0x12,
+    PMU_EVENT_WRITE_BUFFER_FULL               = 0x40,
+    PMU_EVENT_L2_STORE_MERGED                 = 0x41,
+    PMU_EVENT_L2_BUFFERABLE_STORE             = 0x42,
+    PMU_EVENT_L2_ACCESS                       = 0x43,
+    PMU_EVENT_L2_CACHE_MISS                   = 0x44,
+    PMU_EVENT_AXI_READ                        = 0x45,
+    PMU_EVENT_AXI_WRITE                       = 0x46,
+    PMU_EVENT_REPLAY                          = 0x47,
+    PMU_EVENT_UNALIGNED_ACCESS_REPLAY         = 0x48,
+    PMU_EVENT_L1D_HASH_MISS                   = 0x49,
+    PMU_EVENT_L1I_HASH_MISS                   = 0x4A,
+    PMU_EVENT_L1D_PAGE_COLOURING_ALIAS        = 0x4B,
+    PMU_EVENT_L1_NEON_DATA                    = 0x4C,
+    PMU_EVENT_L1_NEON_CACHEABLE_DATA          = 0x4D,
+    PMU_EVENT_L2_NEON                         = 0x4E,
+    PMU_EVENT_L2_NEON_HIT                     = 0x4F,
+    PMU_EVENT_L1I_ACCESS                      = 0x50,
+    PMU_EVENT_RETURN_STACK_MISPREDICTION      = 0x51,
+    PMU_EVENT_BRANCH_DIRECTION_MISPREDICTION  = 0x52,
+    PMU_EVENT_PREDICTABLE_TAKEN_BRANCH        = 0x53,
+    PMU_EVENT_PREDICTABLE_EXECUTED_TAKEN      = 0x54,
+    PMU_EVENT_OPERATIONS_ISSUED               = 0x55,
+    PMU_EVENT_CYCLES_NO_INSTRUCTION           = 0x56,
+    PMU_EVENT_CYCLES_INSTRUCTION_ISSUED       = 0x57,
+    PMU_EVENT_NEON_MRC_DATA_STALL             = 0x58,
+    PMU_EVENT_NEON_QUEUE_FULL_STALL           = 0x59,
+    PMU_EVENT_NEON_AND_INTEGER_NOT_IDLE       = 0x5A
+} pmu_event;
+
+/** A set of events, one per event counter */
+typedef struct
+{
+    pmu_event events[PMU_NUM_EVENT_COUNTERS];
+} pmu_event_set_t;
+
+/** A snapshot of the cycle counter and the event counters, extended to 64 bits */
+typedef struct
+{
+    uint64_t cycles;
+    uint64_t events[PMU_NUM_EVENT_COUNTERS];
+} pmu_counters_t;
+
+void pmu_overflow_interrupt_enable (void);
+void pmu_event_counters_configure (const pmu_event_set_t *const event_set);
+void pmu_event_counters_start (void);
+void pmu_event_counters_stop (void);
+void pmu_counters_read (pmu_counters_t *const counters);
+void pmu_counters_difference (const pmu_counters_t *const start, const pmu_counters_t *const end,
+                              pmu_counters_t *const difference);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PMU_H_ */
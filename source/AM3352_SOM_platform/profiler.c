@@ -0,0 +1,240 @@
+/*
+ * @file profiler.c
+ * @date 16 Oct 2026
+ * @brief Statistical profiler, which samples the interrupted program counter from a DMTimer interrupt
+ * @details DMTimer4 overflows at the sample rate, and the interrupt handler increments the histogram bucket for the
+ *          program counter which was interrupted. There is one 32-bit bucket for each 32-bit word of code, so each
+ *          bucket counts the samples for one ARM instruction. The histogram is dumped as text on the console, and
+ *          host_tools/profile_symbolize converts the dump into a flat profile by function using the ELF file.
+ *
+ *          Unlike the ETB trace this can be left running, and the overhead is one short interrupt per sample.
+ *          Limitations:
+ *          - The sample interrupt is at priority zero, so can't interrupt other priority zero interrupt handlers.
+ *            Time spent in those handlers is attributed to the instruction at which IRQs were re-enabled.
+ *          - Time spent in WFI is attributed to the WFI instruction.
+ *
+ *          The linker script must define the following symbols:
+ *          - __text_start__ and __text_end__ around the code to be profiled.
+ *          - __profile_histogram_start__ for a NOLOAD region the same size as the code, to hold the histogram.
+ *
+ *          timestamp_init() must be called before profiler_init(), since the DMTimer is clocked from the same
+ *          crystal as the timestamp.
+ */
+
+#include <stdio.h>
+
+#include "soc_AM335x.h"
+#include "hw_types.h"
+#include "interrupt.h"
+#include "dmtimer.h"
+#include "AM3352_SOM.h"
+#include "timestamp.h"
+#include "profiler.h"
+
+#define PROFILER_TIMER_BASE SOC_DMTIMER_4_REGS
+#define PROFILER_TIMER_INT  SYS_INT_TINT4
+
+/* The number of bytes of code counted by each histogram bucket, as a shift */
+#define PROFILER_BUCKET_SHIFT 2u
+
+/* Copies of the layout of the IRQ stack frame saved by IRQHandler in the StarterWare
+ * system_config/armv7a/am335x/gcc/exceptionhandler.S, as 32-bit word offsets from the IRQ mode stack pointer
+ * when the interrupt handler is called. The saved LR is the interrupted program counter plus 4. */
+#define IRQ_FRAME_LR_OFFSET   7u
+#define IRQ_FRAME_LR_ADJUST   4u
+
+/* Copies of the ARM processor modes */
+#define CPSR_MODE_IRQ 0x12u
+
+/* Symbols defined by the linker script */
+extern uint32_t __text_start__[];
+extern uint32_t __text_end__[];
+extern uint32_t __profile_histogram_start__[];
+
+/** The histogram of samples, indexed by the offset of the interrupted program counter from __text_start__ */
+static volatile uint32_t *const histogram = __profile_histogram_start__;
+
+/** The number of buckets in the histogram */
+static uint32_t num_buckets;
+
+/** The sample rate */
+static uint32_t profiler_sample_hz;
+
+static volatile profiler_statistics_t profiler_stats;
+
+/**
+ * @brief Get the program counter which was interrupted by the current IRQ
+ * @details The IRQ handler has switched to system mode, so the saved program counter is read from the IRQ mode
+ *          stack by briefly switching to IRQ mode. This relies upon IRQs being disabled in the interrupt handler,
+ *          which is the case for a priority zero interrupt, so the IRQ mode stack can't change.
+ * @return The interrupted program counter
+ */
+static uint32_t get_interrupted_pc (void)
+{
+    const uint32_t *irq_sp;
+    uint32_t saved_cpsr;
+
+    __asm__ volatile ("mrs %1, cpsr\n\t"
+                      "cps %2\n\t"
+                      "mov %0, sp\n\t"
+                      "msr cpsr_c, %1" : "=r" (irq_sp), "=&r" (saved_cpsr) : "i" (CPSR_MODE_IRQ) : "memory");
+
+    return irq_sp[IRQ_FRAME_LR_OFFSET] - IRQ_FRAME_LR_ADJUST;
+}
+
+/**
+ * @brief Interrupt handler for the DMTimer overflow, which takes one sample
+ */
+static void profiler_sample_isr (void)
+{
+    const uint32_t offset = get_interrupted_pc () - (uint32_t) __text_start__;
+    const uint32_t bucket = offset >> PROFILER_BUCKET_SHIFT;
+
+    DMTimerIntStatusClear (PROFILER_TIMER_BASE, DMTIMER_INT_OVF_IT_FLAG);
+    if (bucket < num_buckets)
+    {
+        histogram[bucket]++;
+    }
+    else
+    {
+        profiler_stats.outside_text_samples++;
+    }
+    profiler_stats.samples++;
+}
+
+/**
+ * @brief Initialise the profiler, with an empty histogram and sampling started
+ * @details The caller is responsible for having initialised the interrupt controller and for enabling IRQs in the CPU.
+ *          A sample rate which isn't a multiple of the rate of any periodic activity avoids the samples aliasing.
+ * @param[in] sample_hz The rate at which the program counter is sampled
+ */
+void profiler_init (const uint32_t sample_hz)
+{
+    const uint32_t reload = 0u - (timestamp_timer_hz () / sample_hz);
+
+    num_buckets = ((uint32_t) __text_end__ - (uint32_t) __text_start__) >> PROFILER_BUCKET_SHIFT;
+    profiler_sample_hz = sample_hz;
+
+    DMTimer4ModuleClkConfig ();
+    DMTimerDisable (PROFILER_TIMER_BASE);
+    DMTimerIntDisable (PROFILER_TIMER_BASE, DMTIMER_INT_OVF_EN_FLAG);
+    DMTimerIntStatusClear (PROFILER_TIMER_BASE, DMTIMER_INT_OVF_IT_FLAG);
+    DMTimerReloadSet (PROFILER_TIMER_BASE, reload);
+    DMTimerCounterSet (PROFILER_TIMER_BASE, reload);
+    DMTimerModeConfigure (PROFILER_TIMER_BASE, DMTIMER_AUTORLD_NOCMP_ENABLE);
+    profiler_clear ();
+
+    IntRegister (PROFILER_TIMER_INT, profiler_sample_isr);
+    IntPrioritySet (PROFILER_TIMER_INT, 0, AINTC_HOSTINT_ROUTE_IRQ);
+    IntSystemEnable (PROFILER_TIMER_INT);
+    DMTimerIntEnable (PROFILER_TIMER_BASE, DMTIMER_INT_OVF_EN_FLAG);
+    profiler_start ();
+}
+
+/**
+ * @brief Start taking samples
+ */
+void profiler_start (void)
+{
+    DMTimerEnable (PROFILER_TIMER_BASE);
+}
+
+/**
+ * @brief Stop taking samples, e.g. so the histogram doesn't change while it is dumped
+ */
+void profiler_stop (void)
+{
+    DMTimerDisable (PROFILER_TIMER_BASE);
+}
+
+/**
+ * @brief Clear the histogram and statistics. Must be called with the profiler stopped.
+ */
+void profiler_clear (void)
+{
+    uint32_t bucket;
+
+    for (bucket = 0; bucket < num_buckets; bucket++)
+    {
+        histogram[bucket] = 0;
+    }
+    profiler_stats.samples = 0;
+    profiler_stats.outside_text_samples = 0;
+}
+
+/**
+ * @brief Write one line of the profile dump to the console, if it fits in the console buffer
+ * @param[in] line The line to write
+ * @param[in] line_len The length of the line, from snprintf()
+ * @return Returns true if the line was written
+ */
+static bool write_dump_line (const char *const line, const int line_len)
+{
+    if ((line_len <= 0) || (UARTConsoleTxSpaceGet () < (unsigned int) line_len))
+    {
+        return false;
+    }
+
+    (void) UARTConsoleWrite ((const unsigned char *) line, (unsigned int) line_len);
+    return true;
+}
+
+/**
+ * @brief Dump the histogram as text on the console, for host_tools/profile_symbolize
+ * @details The dump is a header line, a line with the address and count for each non-zero bucket and an end line,
+ *          each starting with PROFILER_DUMP_PREFIX. To avoid blocking or discarding console output, only the lines
+ *          which fit in the console buffer are written; the caller should call again later to continue the dump.
+ *          The profiler should be stopped while the dump is in progress.
+ *
+ *          Must only be called from the main-line code, which is the single producer for the console buffer.
+ * @param[in,out] next_bucket Where to continue the dump. Must be set to zero by the caller to start a dump.
+ *                            Zero is the header line, and N is bucket N-1.
+ * @return Returns true when the dump is complete
+ */
+bool profiler_dump (uint32_t *const next_bucket)
+{
+    char line[64];
+    int line_len;
+    uint32_t bucket;
+
+    if (*next_bucket == 0)
+    {
+        line_len = snprintf (line, sizeof (line), PROFILER_DUMP_PREFIX " start %u %u %u\n",
+                             (unsigned int) profiler_sample_hz, (unsigned int) profiler_stats.samples,
+                             (unsigned int) profiler_stats.outside_text_samples);
+        if (!write_dump_line (line, line_len))
+        {
+            return false;
+        }
+        (*next_bucket)++;
+    }
+
+    for (bucket = *next_bucket - 1; bucket < num_buckets; bucket++)
+    {
+        if (histogram[bucket] != 0)
+        {
+            line_len = snprintf (line, sizeof (line), PROFILER_DUMP_PREFIX " %08x %u\n",
+                                 (unsigned int) ((uint32_t) __text_start__ + (bucket << PROFILER_BUCKET_SHIFT)),
+                                 (unsigned int) histogram[bucket]);
+            if (!write_dump_line (line, line_len))
+            {
+                *next_bucket = bucket + 1;
+                return false;
+            }
+        }
+    }
+    *next_bucket = num_buckets + 1;
+
+    line_len = snprintf (line, sizeof (line), PROFILER_DUMP_PREFIX " end\n");
+    return write_dump_line (line, line_len);
+}
+
+/**
+ * @brief Get the profiler statistics
+ * @param[out] stats The current statistics
+ */
+void profiler_get_statistics (profiler_statistics_t *const stats)
+{
+    stats->samples = profiler_stats.samples;
+    stats->outside_text_samples = profiler_stats.outside_text_samples;
+}
@@ -0,0 +1,40 @@
+/*
+ * @file profiler.h
+ * @date 16 Oct 2026
+ * @brief Interface to a statistical profiler, which samples the interrupted program counter from a DMTimer interrupt
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Prefix for the lines of the profile dump in the console output, used by host_tools/profile_symbolize */
+#define PROFILER_DUMP_PREFIX "profile:"
+
+/** Statistics maintained by the profiler */
+typedef struct
+{
+    /** The total number of samples taken */
+    uint32_t samples;
+    /** The number of samples where the interrupted program counter was outside of the code, so not in the histogram */
+    uint32_t outside_text_samples;
+} profiler_statistics_t;
+
+void profiler_init (const uint32_t sample_hz);
+void profiler_start (void);
+void profiler_stop (void);
+void profiler_clear (void);
+bool profiler_dump (uint32_t *const next_bucket);
+void profiler_get_statistics (profiler_statistics_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROFILER_H_ */
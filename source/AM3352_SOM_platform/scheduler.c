@@ -0,0 +1,334 @@
+/*
+ * @file scheduler.c
+ * @date 16 Oct 2026
+ * @brief Tickless run-to-completion scheduler, in which tasks are run by events or deadlines
+ * @details Each task is a function which runs to completion. A task is made ready by either:
+ *          - An event flag, set by scheduler_task_signal() which may be called from interrupt handlers.
+ *          - A deadline on the timestamp, either one-shot or periodic.
+ *          The highest priority ready task, i.e. the one created first, is run next. Deadlines and event flags
+ *          are re-checked after each task has run.
+ *
+ *          There is no periodic tick. When no task is ready the DMTimer3 compare is programmed for the earliest
+ *          deadline and the processor waits for an interrupt with WFI, so that an idle system doesn't contend
+ *          for the interconnect. Periodic deadlines advance by the period from the previous deadline, rather than
+ *          from when the task ran, so that the task doesn't drift.
+ *
+ *          timestamp_init() must be called before scheduler_init(), since the deadlines are on the timestamp.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "soc_AM335x.h"
+#include "hw_types.h"
+#include "interrupt.h"
+#include "dmtimer.h"
+#include "AM3352_SOM.h"
+#include "timestamp.h"
+#include "scheduler.h"
+
+#define SCHEDULER_TIMER_BASE SOC_DMTIMER_3_REGS
+#define SCHEDULER_TIMER_INT  SYS_INT_TINT3
+
+/* The maximum time the DMTimer compare is programmed for. Later deadlines cause an early wake, after which the
+   compare is re-programmed. Must be less than the DMTimer wrap period of 2^32 ticks. */
+#define MAX_COMPARE_NS (60ull * TIMESTAMP_NS_PER_SEC)
+
+/* The minimum number of DMTimer ticks from the current count the compare is programmed for, so that the compare
+   isn't missed as the counter passes it while the compare register write is posted */
+#define MIN_COMPARE_TICKS 2u
+
+/** The state of one task */
+typedef struct
+{
+    /** The function called each time the task is run */
+    scheduler_task_function function;
+    /** When true deadline_ns is the time at which the task is next run */
+    bool deadline_armed;
+    /** The timestamp at which the task is next run */
+    uint64_t deadline_ns;
+    /** When non-zero the period at which the task is run, otherwise the deadline is one-shot */
+    uint64_t period_ns;
+} scheduler_task_t;
+
+static scheduler_task_t tasks[SCHEDULER_MAX_TASKS];
+static uint32_t num_tasks;
+
+/** Event flags, one bit per task, set by scheduler_task_signal() from any context */
+static volatile uint32_t signalled_tasks;
+
+/** Tasks which are ready to run, only accessed by the scheduler */
+static uint32_t ready_tasks;
+
+/** Set when the DMTimer compare has been programmed for armed_deadline_ns, cleared by the compare interrupt */
+static volatile bool compare_armed;
+static uint64_t armed_deadline_ns;
+
+static scheduler_statistics_t scheduler_stats;
+static volatile uint32_t deadline_interrupts;
+
+/**
+ * @brief Interrupt handler for the DMTimer compare, which wakes the scheduler from WFI
+ * @details The deadlines are checked by the scheduler, so this only has to record the compare has fired
+ */
+static void scheduler_deadline_isr (void)
+{
+    DMTimerIntStatusClear (SCHEDULER_TIMER_BASE, DMTIMER_INT_MAT_IT_FLAG);
+    compare_armed = false;
+    deadline_interrupts++;
+}
+
+/**
+ * @brief Initialise the scheduler, with no tasks
+ * @details Starts DMTimer3 free running from the same clock as the timestamp, to provide the deadline compare.
+ *          The caller is responsible for having initialised the interrupt controller.
+ */
+void scheduler_init (void)
+{
+    num_tasks = 0;
+    signalled_tasks = 0;
+    ready_tasks = 0;
+    compare_armed = false;
+    deadline_interrupts = 0;
+    memset (&scheduler_stats, 0, sizeof (scheduler_stats));
+
+    DMTimer3ModuleClkConfig ();
+    DMTimerDisable (SCHEDULER_TIMER_BASE);
+    DMTimerIntDisable (SCHEDULER_TIMER_BASE, DMTIMER_INT_MAT_EN_FLAG);
+    DMTimerIntStatusClear (SCHEDULER_TIMER_BASE, DMTIMER_INT_MAT_IT_FLAG);
+    DMTimerReloadSet (SCHEDULER_TIMER_BASE, 0);
+    DMTimerCounterSet (SCHEDULER_TIMER_BASE, 0);
+    DMTimerModeConfigure (SCHEDULER_TIMER_BASE, DMTIMER_AUTORLD_CMP_ENABLE);
+    DMTimerEnable (SCHEDULER_TIMER_BASE);
+
+    IntRegister (SCHEDULER_TIMER_INT, scheduler_deadline_isr);
+    IntPrioritySet (SCHEDULER_TIMER_INT, 0, AINTC_HOSTINT_ROUTE_IRQ);
+    IntSystemEnable (SCHEDULER_TIMER_INT);
+    DMTimerIntEnable (SCHEDULER_TIMER_BASE, DMTIMER_INT_MAT_EN_FLAG);
+}
+
+/**
+ * @brief Create a task, which is initially not ready and has no deadline
+ * @details Must be called before scheduler_run(). Tasks have a priority in the order they are created.
+ * @param[in] function The function called each time the task is run
+ * @return The identity of the task, or SCHEDULER_MAX_TASKS if the maximum number of tasks has been reached
+ */
+scheduler_task_id scheduler_task_create (scheduler_task_function function)
+{
+    scheduler_task_t *task;
+
+    if (num_tasks == SCHEDULER_MAX_TASKS)
+    {
+        return SCHEDULER_MAX_TASKS;
+    }
+
+    task = &tasks[num_tasks];
+    task->function = function;
+    task->deadline_armed = false;
+    task->deadline_ns = 0;
+    task->period_ns = 0;
+
+    return num_tasks++;
+}
+
+/**
+ * @brief Set the event flag for a task, so that it is run once by the scheduler
+ * @details May be called from any context, including interrupt handlers. Setting the flag multiple times before
+ *          the task runs only causes the task to be run once.
+ * @param[in] task_id The task to run
+ */
+void scheduler_task_signal (const scheduler_task_id task_id)
+{
+    (void) __atomic_fetch_or (&signalled_tasks, 1u << task_id, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Run a task once at a deadline, replacing any existing deadline for the task
+ * @details Must be called from a task, or before scheduler_run()
+ * @param[in] task_id The task to run
+ * @param[in] deadline_ns The timestamp at which to run the task
+ */
+void scheduler_task_run_at (const scheduler_task_id task_id, const uint64_t deadline_ns)
+{
+    scheduler_task_t *const task = &tasks[task_id];
+
+    task->deadline_ns = deadline_ns;
+    task->period_ns = 0;
+    task->deadline_armed = true;
+}
+
+/**
+ * @brief Run a task periodically, with the first run one period from now
+ * @details Must be called from a task, or before scheduler_run()
+ * @param[in] task_id The task to run
+ * @param[in] period_ns The period at which to run the task
+ */
+void scheduler_task_run_periodic (const scheduler_task_id task_id, const uint64_t period_ns)
+{
+    scheduler_task_t *const task = &tasks[task_id];
+
+    task->deadline_ns = timestamp_get_ns () + period_ns;
+    task->period_ns = period_ns;
+    task->deadline_armed = true;
+}
+
+/**
+ * @brief Make ready the tasks whose deadline has been reached, and find the earliest remaining deadline
+ * @details A periodic task which has missed more than one period has its next deadline set one period from now,
+ *          rather than being run repeatedly to catch up.
+ * @param[in] now_ns The current timestamp
+ * @param[out] earliest_deadline_ns The earliest remaining deadline
+ * @return Returns true if there is a remaining deadline
+ */
+static bool expire_deadlines (const uint64_t now_ns, uint64_t *const earliest_deadline_ns)
+{
+    bool have_deadline = false;
+    scheduler_task_id task_id;
+
+    for (task_id = 0; task_id < num_tasks; task_id++)
+    {
+        scheduler_task_t *const task = &tasks[task_id];
+
+        if (task->deadline_armed)
+        {
+            if (task->deadline_ns <= now_ns)
+            {
+                ready_tasks |= 1u << task_id;
+                if (task->period_ns != 0)
+                {
+                    task->deadline_ns += task->period_ns;
+                    if (task->deadline_ns <= now_ns)
+                    {
+                        task->deadline_ns = now_ns + task->period_ns;
+                    }
+                }
+                else
+                {
+                    task->deadline_armed = false;
+                }
+            }
+
+            if (task->deadline_armed && (!have_deadline || (task->deadline_ns < *earliest_deadline_ns)))
+            {
+                *earliest_deadline_ns = task->deadline_ns;
+                have_deadline = true;
+            }
+        }
+    }
+
+    return have_deadline;
+}
+
+/**
+ * @brief Program the DMTimer compare to interrupt at a deadline
+ * @details The compare is only re-programmed if the deadline has changed, or the compare has fired, to avoid L4
+ *          writes each time the scheduler goes idle.
+ * @param[in] deadline_ns The deadline to interrupt at
+ * @return Returns true if the compare has been programmed, or false if the deadline has already been reached
+ */
+static bool program_deadline_compare (const uint64_t deadline_ns)
+{
+    const uint64_t now_ns = timestamp_get_ns ();
+    uint64_t delta_ns;
+    uint32_t ticks;
+    uint32_t start_count;
+
+    if (deadline_ns <= now_ns)
+    {
+        return false;
+    }
+    if (compare_armed && (deadline_ns == armed_deadline_ns))
+    {
+        return true;
+    }
+
+    delta_ns = deadline_ns - now_ns;
+    if (delta_ns > MAX_COMPARE_NS)
+    {
+        delta_ns = MAX_COMPARE_NS;
+    }
+    ticks = (uint32_t) (((delta_ns * timestamp_timer_hz ()) + (TIMESTAMP_NS_PER_SEC - 1u)) / TIMESTAMP_NS_PER_SEC);
+    if (ticks < MIN_COMPARE_TICKS)
+    {
+        ticks = MIN_COMPARE_TICKS;
+    }
+
+    start_count = DMTimerCounterGet (SCHEDULER_TIMER_BASE);
+    DMTimerCompareSet (SCHEDULER_TIMER_BASE, start_count + ticks);
+
+    /* Check the counter didn't pass the compare value before it was written. If it did the compare won't fire, so
+     * leave compare_armed clear to re-program it on the next attempt rather than sleep without a deadline interrupt. */
+    if ((DMTimerCounterGet (SCHEDULER_TIMER_BASE) - start_count) >= ticks)
+    {
+        compare_armed = false;
+        return false;
+    }
+
+    compare_armed = true;
+    armed_deadline_ns = deadline_ns;
+
+    return true;
+}
+
+/**
+ * @brief Wait in WFI until an interrupt occurs, when no task is ready
+ * @details IRQs are disabled while checking if the scheduler can sleep, so that an event flag set by an interrupt
+ *          handler after the check still wakes the processor from WFI.
+ * @param[in] have_deadline True if there is a deadline to wake at
+ * @param[in] deadline_ns The earliest deadline
+ */
+static void scheduler_sleep (const bool have_deadline, const uint64_t deadline_ns)
+{
+    uint64_t sleep_start_ns;
+
+    IntMasterIRQDisable ();
+    if ((signalled_tasks == 0) && (!have_deadline || program_deadline_compare (deadline_ns)))
+    {
+        sleep_start_ns = timestamp_get_ns ();
+        __asm__ volatile ("dsb\n\t"
+                          "wfi" : : : "memory");
+        timestamp_resynchronise ();
+        scheduler_stats.idle_ns += timestamp_get_ns () - sleep_start_ns;
+        scheduler_stats.sleeps++;
+    }
+    IntMasterIRQEnable ();
+}
+
+/**
+ * @brief Run the tasks, in priority order, as they become ready. Never returns.
+ */
+void scheduler_run (void)
+{
+    scheduler_task_id task_id;
+    uint64_t earliest_deadline_ns = 0;
+    bool have_deadline;
+
+    for (;;)
+    {
+        ready_tasks |= __atomic_exchange_n (&signalled_tasks, 0, __ATOMIC_SEQ_CST);
+        have_deadline = expire_deadlines (timestamp_get_ns (), &earliest_deadline_ns);
+
+        if (ready_tasks != 0)
+        {
+            task_id = (scheduler_task_id) __builtin_ctz (ready_tasks);
+            ready_tasks &= ~(1u << task_id);
+            scheduler_stats.task_runs[task_id]++;
+            tasks[task_id].function ();
+        }
+        else
+        {
+            scheduler_sleep (have_deadline, earliest_deadline_ns);
+        }
+    }
+}
+
+/**
+ * @brief Get the scheduler statistics
+ * @details Must be called from a task
+ * @param[out] stats The current statistics
+ */
+void scheduler_get_statistics (scheduler_statistics_t *const stats)
+{
+    *stats = scheduler_stats;
+    stats->deadline_interrupts = deadline_interrupts;
+}
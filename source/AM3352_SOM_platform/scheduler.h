@@ -0,0 +1,50 @@
+/*
+ * @file scheduler.h
+ * @date 16 Oct 2026
+ * @brief Interface to a tickless run-to-completion scheduler, in which tasks are run by events or deadlines
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The maximum number of tasks, limited by the number of bits in the event flags */
+#define SCHEDULER_MAX_TASKS 32u
+
+/** Identifies a task. Tasks created first have the highest priority. */
+typedef uint32_t scheduler_task_id;
+
+/** The function for a task, which runs to completion each time the task is run */
+typedef void (*scheduler_task_function) (void);
+
+/** Statistics maintained by the scheduler */
+typedef struct
+{
+    /** The number of times each task has been run */
+    uint32_t task_runs[SCHEDULER_MAX_TASKS];
+    /** The number of times the scheduler has entered WFI as no task was ready */
+    uint32_t sleeps;
+    /** The total time spent in WFI */
+    uint64_t idle_ns;
+    /** The number of deadline compare interrupts */
+    uint32_t deadline_interrupts;
+} scheduler_statistics_t;
+
+void scheduler_init (void);
+scheduler_task_id scheduler_task_create (scheduler_task_function function);
+void scheduler_task_signal (const scheduler_task_id task_id);
+void scheduler_task_run_at (const scheduler_task_id task_id, const uint64_t deadline_ns);
+void scheduler_task_run_periodic (const scheduler_task_id task_id, const uint64_t period_ns);
+void scheduler_run (void) __attribute__((noreturn));
+void scheduler_get_statistics (scheduler_statistics_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCHEDULER_H_ */
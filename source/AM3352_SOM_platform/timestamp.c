@@ -0,0 +1,306 @@
+/*
+ * @file timestamp.c
+ * @date 16 Oct 2026
+ * @brief Monotonic 64-bit nanosecond timestamp, derived from a DMTimer and the PMU cycle counter
+ * @details DMTimer2 free runs from the master oscillator and overflows once per second. The overflow interrupt
+ *          counts seconds, which gives the long term time base, and takes a snapshot of the cycle counter against
+ *          the DMTimer time. timestamp_get_ns() interpolates from the most recent snapshot using the cycle counter,
+ *          which avoids a slow L4 peripheral read and gives CPU clock resolution.
+ *
+ *          The ratio of nanoseconds to cycles is re-calibrated on every overflow from the cycle counter ticks
+ *          measured over the previous second, and is steered so that the interpolated time converges on the
+ *          DMTimer time by the next overflow. If the interpolated time has run ahead of the DMTimer the snapshot
+ *          keeps the interpolated time, so the timestamp never goes backwards.
+ *
+ *          The overflow interrupt writes the snapshot not currently in use and then publishes it by incrementing
+ *          a generation count, so timestamp_get_ns() never waits for the writer and may be called from main-line
+ *          code, IRQ handlers or FIQ handlers.
+ *
+ *          The cycle counter stops while the processor is in WFI, so code which uses WFI must call
+ *          timestamp_resynchronise() on waking. An interval which contained a re-synchronisation isn't used
+ *          to calibrate the cycle counter.
+ *
+ *          Requirements on the caller:
+ *          - enable_cycle_count() must be called before timestamp_init(), since it resets the cycle counter.
+ *          - IRQs must be enabled in the CPU, and not masked for longer than one second, so that no overflow is
+ *            missed. Reads made while the interrupt is pending remain valid until the cycle counter wraps.
+ */
+
+#include <stdbool.h>
+
+#include "soc_AM335x.h"
+#include "hw_types.h"
+#include "interrupt.h"
+#include "dmtimer.h"
+#include "AM3352_SOM.h"
+#include "timestamp.h"
+
+#define TIMESTAMP_TIMER_BASE SOC_DMTIMER_2_REGS
+#define TIMESTAMP_TIMER_INT  SYS_INT_TINT2
+
+/* The number of fractional bits in the nanoseconds per cycle ratio.
+   Allows for a cycle counter frequency down to 250 MHz before the ratio no longer fits in 32 bits. */
+#define NS_PER_CYCLE_FRACTION_BITS 30u
+
+/* The period over which the initial ratio of nanoseconds per cycle is calibrated, before the first overflow */
+#define INITIAL_CALIBRATION_DIVISOR 100u
+
+/** A point at which the timestamp and cycle counter were sampled, from which later timestamps are interpolated */
+typedef struct
+{
+    /** The timestamp at base_cycles */
+    uint64_t base_ns;
+    /** The cycle counter value at which the snapshot was taken */
+    uint32_t base_cycles;
+    /** The nanoseconds per cycle, with NS_PER_CYCLE_FRACTION_BITS fractional bits */
+    uint32_t ns_per_cycle;
+} timestamp_snapshot_t;
+
+/** Double buffered snapshots. The one in use is indexed by the least significant bit of snapshot_generation. */
+static volatile timestamp_snapshot_t snapshots[2];
+static volatile uint32_t snapshot_generation;
+
+/** The frequency of the DMTimer, determined from the crystal frequency */
+static uint32_t timer_hz;
+
+/** The DMTimer count loaded on each overflow, so that the timer overflows once per second */
+static uint32_t timer_reload;
+
+/** The number of DMTimer overflows, i.e. whole seconds */
+static uint32_t timer_seconds;
+
+/** The DMTimer time and cycle counter at the previous overflow, used to calibrate the cycle counter */
+static uint64_t previous_timer_ns;
+static uint32_t previous_timer_cycles;
+
+/** The most recent measurement of the cycle counter frequency */
+static volatile uint32_t cycle_counter_hz;
+
+/** The most recent measurement of the nanoseconds per cycle, with NS_PER_CYCLE_FRACTION_BITS fractional bits */
+static uint32_t calibrated_ns_per_cycle;
+
+/** Set when timestamp_resynchronise() has been called since the last DMTimer overflow */
+static volatile bool resynchronised_since_overflow;
+
+/**
+ * @brief Read the cycle counter inline, rather than calling pmu_get_cycle_count(), to minimise the time to read
+ *        a timestamp
+ */
+static inline uint32_t read_cycle_counter (void)
+{
+    uint32_t value;
+
+    __asm__ volatile ("mrc p15, 0, %0, c9, c13, 0" : "=r" (value));
+    return value;
+}
+
+/**
+ * @brief Convert the current DMTimer count into nanoseconds since timestamp_init()
+ * @param[in] seconds The number of DMTimer overflows
+ * @param[in] count The DMTimer count
+ * @return The DMTimer time in nanoseconds
+ */
+static uint64_t timer_count_to_ns (const uint32_t seconds, const uint32_t count)
+{
+    const uint32_t ticks_into_second = count - timer_reload;
+
+    return ((uint64_t) seconds * TIMESTAMP_NS_PER_SEC) +
+            (((uint64_t) ticks_into_second * TIMESTAMP_NS_PER_SEC) / timer_hz);
+}
+
+/**
+ * @brief Interpolate a timestamp from a snapshot
+ * @param[in] snapshot The snapshot to interpolate from
+ * @param[in] cycles The cycle counter value to obtain the timestamp for
+ * @return The timestamp in nanoseconds
+ */
+static inline uint64_t interpolate_ns (const volatile timestamp_snapshot_t *const snapshot, const uint32_t cycles)
+{
+    return snapshot->base_ns +
+            (((uint64_t) (cycles - snapshot->base_cycles) * snapshot->ns_per_cycle) >> NS_PER_CYCLE_FRACTION_BITS);
+}
+
+/**
+ * @brief Publish a new snapshot, which will be used by subsequent calls to timestamp_get_ns()
+ * @details Must be called with IRQs disabled, or from the overflow interrupt, so that there is only one writer.
+ *          If the timestamp interpolated from the current snapshot is ahead of timer_ns the new snapshot keeps
+ *          the interpolated time, so that the timestamp never goes backwards.
+ * @param[in] timer_ns The DMTimer time at cycles
+ * @param[in] cycles The cycle counter value at which the DMTimer was sampled
+ * @param[in] target_ns If non-zero the timestamp which the snapshot should reach after period_cycles, used to steer
+ *                      the ratio of nanoseconds to cycles. If zero the calibrated ratio is used.
+ * @param[in] period_cycles The number of cycles over which to reach target_ns
+ */
+static void publish_snapshot (const uint64_t timer_ns, const uint32_t cycles,
+                              uint64_t target_ns, const uint32_t period_cycles)
+{
+    const volatile timestamp_snapshot_t *const current = &snapshots[snapshot_generation & 1u];
+    volatile timestamp_snapshot_t *const next = &snapshots[(snapshot_generation + 1u) & 1u];
+    const uint64_t interpolated_ns = interpolate_ns (current, cycles);
+    const uint64_t base_ns = (interpolated_ns > timer_ns) ? interpolated_ns : timer_ns;
+
+    next->base_ns = base_ns;
+    next->base_cycles = cycles;
+    if (target_ns != 0)
+    {
+        /* Limit the correction to half of the nominal rate */
+        if (target_ns < (base_ns + (TIMESTAMP_NS_PER_SEC / 2u)))
+        {
+            target_ns = base_ns + (TIMESTAMP_NS_PER_SEC / 2u);
+        }
+        next->ns_per_cycle = (uint32_t) (((target_ns - base_ns) << NS_PER_CYCLE_FRACTION_BITS) / period_cycles);
+    }
+    else
+    {
+        next->ns_per_cycle = calibrated_ns_per_cycle;
+    }
+    snapshot_generation++;
+}
+
+/**
+ * @brief Interrupt handler for the DMTimer overflow, which publishes a new snapshot once per second
+ */
+static void timestamp_overflow_isr (void)
+{
+    uint32_t count;
+    uint32_t cycles;
+    uint64_t timer_ns;
+    uint32_t elapsed_cycles;
+
+    DMTimerIntStatusClear (TIMESTAMP_TIMER_BASE, DMTIMER_INT_OVF_IT_FLAG);
+    timer_seconds++;
+    count = DMTimerCounterGet (TIMESTAMP_TIMER_BASE);
+    cycles = read_cycle_counter ();
+    timer_ns = timer_count_to_ns (timer_seconds, count);
+    elapsed_cycles = cycles - previous_timer_cycles;
+
+    if (resynchronised_since_overflow)
+    {
+        /* The cycle counter stopped for part of the last second, so can't be used for calibration */
+        publish_snapshot (timer_ns, cycles, 0, 0);
+    }
+    else
+    {
+        /* Re-measure the cycle counter frequency over the last second, and steer the ratio so that if the cycle
+           counter frequency is unchanged the interpolated time matches the DMTimer time at the next overflow */
+        cycle_counter_hz = (uint32_t) (((uint64_t) elapsed_cycles * TIMESTAMP_NS_PER_SEC) / (timer_ns - previous_timer_ns));
+        calibrated_ns_per_cycle = (uint32_t) (((timer_ns - previous_timer_ns) << NS_PER_CYCLE_FRACTION_BITS) / elapsed_cycles);
+        publish_snapshot (timer_ns, cycles, timer_ns + TIMESTAMP_NS_PER_SEC, elapsed_cycles);
+    }
+    previous_timer_ns = timer_ns;
+    previous_timer_cycles = cycles;
+    resynchronised_since_overflow = false;
+}
+
+/**
+ * @brief Re-synchronise the timestamp to the DMTimer after the cycle counter may have stopped
+ * @details The Cortex-A8 cycle counter doesn't count while the processor is in WFI, so this must be called after
+ *          waking from WFI before timestamp_get_ns() is used. Must be called with IRQs disabled.
+ *          Takes account of a DMTimer overflow which has occurred but not yet been serviced by the interrupt.
+ */
+void timestamp_resynchronise (void)
+{
+    const uint32_t count = DMTimerCounterGet (TIMESTAMP_TIMER_BASE);
+    const uint32_t cycles = read_cycle_counter ();
+    const uint32_t overflow_pending = DMTimerIntRawStatusGet (TIMESTAMP_TIMER_BASE) & DMTIMER_INT_OVF_IT_FLAG;
+    uint32_t seconds = timer_seconds;
+
+    if ((overflow_pending != 0) && ((count - timer_reload) < (timer_hz / 2u)))
+    {
+        seconds++;
+    }
+    publish_snapshot (timer_count_to_ns (seconds, count), cycles, 0, 0);
+    resynchronised_since_overflow = true;
+}
+
+/**
+ * @brief Start the timestamp from zero
+ * @details Starts DMTimer2 free running and measures the cycle counter over a short period to give the initial
+ *          calibration, which is refined at each DMTimer overflow.
+ *          The caller is responsible for having initialised the interrupt controller and for enabling IRQs in the CPU.
+ */
+void timestamp_init (void)
+{
+    volatile timestamp_snapshot_t *const initial = &snapshots[0];
+    uint32_t count;
+    uint32_t cycles;
+    uint32_t start_cycles;
+    uint64_t start_ns;
+    uint64_t timer_ns;
+
+    timer_hz = get_crystal_hz ();
+    timer_reload = 0u - timer_hz;
+    timer_seconds = 0;
+
+    DMTimer2ModuleClkConfig ();
+    DMTimerDisable (TIMESTAMP_TIMER_BASE);
+    DMTimerIntDisable (TIMESTAMP_TIMER_BASE, DMTIMER_INT_OVF_EN_FLAG);
+    DMTimerIntStatusClear (TIMESTAMP_TIMER_BASE, DMTIMER_INT_OVF_IT_FLAG);
+    DMTimerReloadSet (TIMESTAMP_TIMER_BASE, timer_reload);
+    DMTimerCounterSet (TIMESTAMP_TIMER_BASE, timer_reload);
+    DMTimerModeConfigure (TIMESTAMP_TIMER_BASE, DMTIMER_AUTORLD_NOCMP_ENABLE);
+
+    DMTimerEnable (TIMESTAMP_TIMER_BASE);
+    count = DMTimerCounterGet (TIMESTAMP_TIMER_BASE);
+    start_cycles = read_cycle_counter ();
+    start_ns = timer_count_to_ns (0, count);
+    do
+    {
+        count = DMTimerCounterGet (TIMESTAMP_TIMER_BASE);
+        cycles = read_cycle_counter ();
+    } while ((count - timer_reload) < (timer_hz / INITIAL_CALIBRATION_DIVISOR));
+    timer_ns = timer_count_to_ns (0, count);
+
+    cycle_counter_hz = (uint32_t) (((uint64_t) (cycles - start_cycles) * TIMESTAMP_NS_PER_SEC) / (timer_ns - start_ns));
+    previous_timer_ns = timer_ns;
+    previous_timer_cycles = cycles;
+    initial->base_ns = timer_ns;
+    initial->base_cycles = cycles;
+    calibrated_ns_per_cycle = (uint32_t) (((timer_ns - start_ns) << NS_PER_CYCLE_FRACTION_BITS) / (cycles - start_cycles));
+    initial->ns_per_cycle = calibrated_ns_per_cycle;
+    snapshot_generation = 0;
+    resynchronised_since_overflow = false;
+
+    IntRegister (TIMESTAMP_TIMER_INT, timestamp_overflow_isr);
+    IntPrioritySet (TIMESTAMP_TIMER_INT, 0, AINTC_HOSTINT_ROUTE_IRQ);
+    IntSystemEnable (TIMESTAMP_TIMER_INT);
+    DMTimerIntEnable (TIMESTAMP_TIMER_BASE, DMTIMER_INT_OVF_EN_FLAG);
+}
+
+/**
+ * @brief Read the timestamp
+ * @details May be called from any context. Retries if a new snapshot was published while being read.
+ * @return The number of nanoseconds since timestamp_init()
+ */
+uint64_t timestamp_get_ns (void)
+{
+    uint32_t generation;
+    uint32_t cycles;
+    uint64_t ns;
+
+    do
+    {
+        generation = snapshot_generation;
+        cycles = read_cycle_counter ();
+        ns = interpolate_ns (&snapshots[generation & 1u], cycles);
+    } while (generation != snapshot_generation);
+
+    return ns;
+}
+
+/**
+ * @return The frequency of the DMTimer used as the time base, in Hz
+ */
+uint32_t timestamp_timer_hz (void)
+{
+    return timer_hz;
+}
+
+/**
+ * @return The most recently measured frequency of the cycle counter, in Hz.
+ *         Measured over one second once the first DMTimer overflow has occurred, and over a short period before that.
+ */
+uint32_t timestamp_cycle_counter_hz (void)
+{
+    return cycle_counter_hz;
+}
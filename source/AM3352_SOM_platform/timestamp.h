@@ -0,0 +1,28 @@
+/*
+ * @file timestamp.h
+ * @date 16 Oct 2026
+ * @brief Interface to a monotonic 64-bit nanosecond timestamp, derived from a DMTimer and the PMU cycle counter
+ */
+
+#ifndef TIMESTAMP_H_
+#define TIMESTAMP_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIMESTAMP_NS_PER_SEC 1000000000u
+
+void timestamp_init (void);
+uint64_t timestamp_get_ns (void);
+void timestamp_resynchronise (void);
+uint32_t timestamp_timer_hz (void);
+uint32_t timestamp_cycle_counter_hz (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMESTAMP_H_ */
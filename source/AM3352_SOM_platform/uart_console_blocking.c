@@ -78,6 +78,8 @@ static void UartFIFOConfigure(unsigned int txTrigLevel,
                               unsigned int rxTrigLevel);
 static void UartBaudRateSet(unsigned int baudRate);
 void UARTConsolePutc(unsigned char data);
+unsigned int UARTConsoleWrite(const unsigned char *const buf, const unsigned int len);
+unsigned int UARTConsoleTxSpaceGet(void);
 unsigned char UARTConsoleGetc(void);
 void UARTConsoleInit(void);
 
@@ -220,6 +222,38 @@ void UARTConsolePutc(unsigned char data)
      UARTCharPut(UART_CONSOLE_BASE, data);
 }
 
+/**
+ * \brief   This function writes characters to the serial console.
+ *
+ * \param   buf     The characters to be written to the serial console
+ * \param   len     The number of characters to be written
+ *
+ * \return  The number of characters written, which is always len.
+ */
+unsigned int UARTConsoleWrite(const unsigned char *const buf, const unsigned int len)
+{
+    unsigned int index;
+
+    for (index = 0; index < len; index++)
+    {
+        UARTCharPut(UART_CONSOLE_BASE, buf[index]);
+    }
+
+    return len;
+}
+
+/**
+ * \brief   This function returns the number of characters which can be written
+ *          to the serial console without any being discarded.
+ *
+ * \return  The maximum value, since writes block until all characters
+ *          have been written.
+ */
+unsigned int UARTConsoleTxSpaceGet(void)
+{
+    return 0xFFFFFFFFu;
+}
+
 /**
  * \brief   This function puts a character on the serial console.
  *
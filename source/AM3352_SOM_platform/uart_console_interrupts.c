@@ -4,16 +4,35 @@
  * @author Chester Gillon
  * @brief Contains UART console output functions which use interrupts to transmit from a buffer
  * @details This allows the output of characters to be queued without having to block waiting for the previous
+ *
+ *          The software buffer is a single-producer/single-consumer ring, with the main-line code as the producer and
+ *          UART_isr as the consumer. Each side only writes its own index, so no interrupt masking is required.
+ *
+ *          When compiled with UART_CONSOLE_TX_EDMA defined, the consumer is the EDMA3 instead of UART_isr.
+ *          Contiguous spans of the ring are transferred by an EDMA3 channel triggered by the UART transmit DMA request,
+ *          and the EDMA3 completion interrupt starts the transfer of the next span. The CPU doesn't write any characters
+ *          to the UART transmit FIFO. Each span is written back from the data cache before the EDMA3 transfer is started,
+ *          so the console can be used by a program which runs with the caches enabled.
+ *
+ *          The CPU cycles spent in the console output functions and interrupt handlers are accumulated, to allow the
+ *          CPU overhead of the interrupt and EDMA3 transmit modes to be compared.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
-#include <stdlib.h>
+#include <string.h>
 
 #include "interrupt.h"
 #include "uart_irda_cir.h"
 #include "soc_AM335x.h"
 #include "AM3352_SOM.h"
 #include "hw_types.h"
+#include "hw_uart_irda_cir.h"
+#ifdef UART_CONSOLE_TX_EDMA
+#include "edma.h"
+#include "hw_edma3cc.h"
+#include "dma_coherency.h"
+#endif
 
 /* Select constants for the specified UART console port */
 #if UART_CONSOLE_PORT == 0
@@ -32,19 +51,85 @@
     #error "Unknown UART_CONSOLE_PORT"
 #endif
 
+#ifdef UART_CONSOLE_TX_EDMA
+/* The EDMA3 channel which is triggered by the transmit DMA request of the UART console port.
+ * The channel number is also used as the transfer completion code. */
+#if UART_CONSOLE_PORT == 0
+    #define UART_CONSOLE_TX_EDMA_CHANNEL     (26u)
+#elif UART_CONSOLE_PORT == 1
+    #define UART_CONSOLE_TX_EDMA_CHANNEL     (28u)
+#elif UART_CONSOLE_PORT == 2
+    #define UART_CONSOLE_TX_EDMA_CHANNEL     (30u)
+#else
+    #error "EDMA3 transmit not supported for UART_CONSOLE_PORT"
+#endif
+
+/** The EDMA3 event queue used for the console transmit */
+#define UART_CONSOLE_TX_EDMA_EVENT_QUEUE     (0u)
+#endif
+
 /** The baud rate used for the console port */
 #define BAUD_RATE                            (115200)
 
 #define UART_MODULE_INPUT_CLK                (48000000)
 
-/** Allows buffering of data which takes approx one second to transmit */
-#define UART_BUFFER_SIZE (BAUD_RATE / 10)
+/** Allows buffering of data which takes approx 1.4 seconds to transmit.
+ *  Must be a power of two, so that the ring indices can be masked rather than requiring a division. */
+#define UART_BUFFER_SIZE 16384u
+#define UART_BUFFER_INDEX_MASK (UART_BUFFER_SIZE - 1u)
+
+#if (UART_BUFFER_SIZE & UART_BUFFER_INDEX_MASK) != 0
+#error "UART_BUFFER_SIZE must be a power of two"
+#endif
+
+/** Circular buffer used to store characters waiting to be transmitted by the console port.
+ *  The indices are free running, and are masked when used to index uart_tx_buffer[].
+ *  The number of characters in the buffer is (uart_tx_buffer_write_index - uart_tx_buffer_read_index).
+ *  uart_tx_buffer_write_index is only written by the main-line code, and uart_tx_buffer_read_index only by UART_isr. */
+static uint8_t uart_tx_buffer[UART_BUFFER_SIZE];
+static volatile uint32_t uart_tx_buffer_read_index;
+static volatile uint32_t uart_tx_buffer_write_index;
 
-/** Circular buffer used to store characters waiting to be transmitted by the console port */
-static uint8_t *uart_tx_buffer;
-static uint32_t uart_tx_buffer_num_chars;
-static uint32_t uart_tx_buffer_read_index;
-static uint32_t uart_tx_buffer_write_index;
+#ifdef UART_CONSOLE_TX_EDMA
+/** Set while an EDMA3 transfer of a span of the buffer is in progress. Only written by the EDMA3 interrupt handler. */
+static volatile bool uart_tx_dma_active;
+
+/** The number of characters in the span being transferred by the EDMA3 */
+static uint32_t uart_tx_dma_span;
+#endif
+
+/** The CPU overhead of the console output */
+static volatile uart_console_statistics_t uart_console_stats;
+
+/**
+ * @brief Data Memory Barrier, to order the accesses to the ring contents with respect to the ring indices
+ *        and the UART registers
+ */
+static inline void data_memory_barrier (void)
+{
+    __asm__ volatile ("dmb" : : : "memory");
+}
+
+/**
+ * @brief Enable or disable the UART transmit holding register empty interrupt
+ * @details The StarterWare UARTIntEnable() and UARTIntDisable() functions temporarily switch the UART to a
+ *          configuration mode to access the upper bits of the IER, which isn't safe to be interrupted by UART_isr.
+ *          The THR interrupt enable is in the lower bits of IER, which can be written in operational mode.
+ *          Only the THR interrupt enable is changed by either the main-line code or UART_isr, so if UART_isr interrupts
+ *          the main-line read-modify-write the net result is that the THR interrupt is enabled by the main-line.
+ * @param[in] enable Whether to enable the THR interrupt
+ */
+static inline void uart_thr_interrupt_set (const bool enable)
+{
+    if (enable)
+    {
+        HWREG (UART_CONSOLE_BASE + UART_IER) |= UART_INT_THR;
+    }
+    else
+    {
+        HWREG (UART_CONSOLE_BASE + UART_IER) &= ~UART_INT_THR;
+    }
+}
 
 /*
 ** A wrapper function performing FIFO configurations.
@@ -132,11 +217,13 @@ static void UARTStdioInitExpClk(unsigned int baudRate,
     UARTOperatingModeSelect(UART_CONSOLE_BASE, UART16x_OPER_MODE);
 }
 
+#ifndef UART_CONSOLE_TX_EDMA
 /**
  * @brief UART ISR which transfers characters from a software circular buffer to the console UART transmit FIFO
  */
 static void UART_isr (void)
 {
+    const uint32_t start_cycles = pmu_get_cycle_count ();
     unsigned int intId = 0;
 
     /* Checking ths source of UART interrupt. */
@@ -145,35 +232,135 @@ static void UART_isr (void)
     switch(intId)
     {
         case UART_INTID_TX_THRES_REACH:
+        {
+            uint32_t read_index = uart_tx_buffer_read_index;
+            const uint32_t write_index = uart_tx_buffer_write_index;
+
+            /* Ensure the characters are read from the buffer after the write index which published them */
+            data_memory_barrier ();
+
             /* Fill the UART transmit FIFO with characters from the buffer */
-            while ((uart_tx_buffer_num_chars > 0) &&
+            while ((read_index != write_index) &&
                    (UARTTxFIFOFullStatusGet (UART_CONSOLE_BASE) == UART_TX_FIFO_NOT_FULL))
             {
-                UARTFIFOWrite (UART_CONSOLE_BASE, &uart_tx_buffer[uart_tx_buffer_read_index], 1);
-                uart_tx_buffer_num_chars--;
-                uart_tx_buffer_read_index = (uart_tx_buffer_read_index + 1) % UART_BUFFER_SIZE;
+                UARTFIFOWrite (UART_CONSOLE_BASE, &uart_tx_buffer[read_index & UART_BUFFER_INDEX_MASK], 1);
+                read_index++;
             }
 
-            if (uart_tx_buffer_num_chars == 0)
+            /* Ensure the characters have been read before the space is released to the main-line */
+            data_memory_barrier ();
+            uart_tx_buffer_read_index = read_index;
+
+            if (read_index == write_index)
             {
-                /* Disable transmit interrupt when there are no more characters to transmit */
-                UARTIntDisable (UART_CONSOLE_BASE, UART_INT_THR);
+                /* Disable transmit interrupt when there are no more characters to transmit.
+                 * The main-line may have added characters after the write index was sampled, and seen the THR
+                 * interrupt as still enabled, so re-check after disabling the interrupt. */
+                uart_thr_interrupt_set (false);
+                data_memory_barrier ();
+                if (uart_tx_buffer_write_index != read_index)
+                {
+                    uart_thr_interrupt_set (true);
+                }
             }
             break;
+        }
 
         default:
             break;
     }
+
+    uart_console_stats.isr_cpu_cycles += pmu_get_cycle_count () - start_cycles;
+}
+#else
+/**
+ * @brief Start an EDMA3 transfer of the next contiguous span of characters in the buffer, if any
+ * @details Only called from uart_edma_isr, which is the only writer of uart_tx_dma_active.
+ *          The EDMA3 channel transfers one character per UART transmit DMA request, as the UART transmit FIFO trigger
+ *          level is one space. The UART DMA request is only enabled once the EDMA3 channel is ready, so that the
+ *          request generates a new event.
+ */
+static void uart_tx_dma_start (void)
+{
+    const uint32_t read_index = uart_tx_buffer_read_index;
+    const uint32_t write_index = uart_tx_buffer_write_index;
+    uint32_t start_offset;
+    EDMA3CCPaRAMEntry param_set;
+
+    /* Ensure the characters are read from the buffer after the write index which published them */
+    data_memory_barrier ();
+
+    if (read_index != write_index)
+    {
+        start_offset = read_index & UART_BUFFER_INDEX_MASK;
+        uart_tx_dma_span = write_index - read_index;
+        if (uart_tx_dma_span > (UART_BUFFER_SIZE - start_offset))
+        {
+            uart_tx_dma_span = UART_BUFFER_SIZE - start_offset;
+        }
+
+        dma_coherency_before_device_read (&uart_tx_buffer[start_offset], uart_tx_dma_span);
+
+        param_set.opt = EDMA3CC_OPT_TCINTEN |
+                ((UART_CONSOLE_TX_EDMA_CHANNEL << EDMA3CC_OPT_TCC_SHIFT) & EDMA3CC_OPT_TCC);
+        param_set.srcAddr = (unsigned int) &uart_tx_buffer[start_offset];
+        param_set.destAddr = UART_CONSOLE_BASE + UART_THR;
+        param_set.aCnt = 1;
+        param_set.bCnt = (unsigned short) uart_tx_dma_span;
+        param_set.cCnt = 1;
+        param_set.srcBIdx = 1;
+        param_set.destBIdx = 0;
+        param_set.srcCIdx = 0;
+        param_set.destCIdx = 0;
+        param_set.linkAddr = 0xFFFF;
+        param_set.bCntReload = 0;
+        EDMA3SetPaRAM (SOC_EDMA30CC_0_REGS, UART_CONSOLE_TX_EDMA_CHANNEL, &param_set);
+        EDMA3EnableTransfer (SOC_EDMA30CC_0_REGS, UART_CONSOLE_TX_EDMA_CHANNEL, EDMA3_TRIG_MODE_EVENT);
+
+        uart_tx_dma_active = true;
+        UARTDMAEnable (UART_CONSOLE_BASE, UART_DMA_MODE_1_ENABLE);
+    }
 }
 
+/**
+ * @brief EDMA3 completion interrupt handler for the UART console transmit
+ * @details Called when the EDMA3 has completed the transfer of a span, or when the main-line has raised the interrupt
+ *          by software to start a transfer when the EDMA3 was idle.
+ */
+static void uart_edma_isr (void)
+{
+    const uint32_t start_cycles = pmu_get_cycle_count ();
+
+    IntSoftwareIntClear (SYS_INT_EDMACOMPINT);
+    if ((EDMA3GetIntrStatus (SOC_EDMA30CC_0_REGS) & (1u << UART_CONSOLE_TX_EDMA_CHANNEL)) != 0)
+    {
+        /* Stop the UART DMA requests before releasing the span of the buffer which has been transferred */
+        EDMA3ClrIntr (SOC_EDMA30CC_0_REGS, UART_CONSOLE_TX_EDMA_CHANNEL);
+        UARTDMADisable (UART_CONSOLE_BASE);
+        EDMA3DisableTransfer (SOC_EDMA30CC_0_REGS, UART_CONSOLE_TX_EDMA_CHANNEL, EDMA3_TRIG_MODE_EVENT);
+        data_memory_barrier ();
+        uart_tx_buffer_read_index += uart_tx_dma_span;
+        uart_tx_dma_active = false;
+    }
+
+    if (!uart_tx_dma_active)
+    {
+        /* The main-line may have added characters after sampling uart_tx_dma_active as still set,
+         * so uart_tx_dma_start() re-reads the write index after uart_tx_dma_active has been cleared. */
+        data_memory_barrier ();
+        uart_tx_dma_start ();
+    }
+
+    uart_console_stats.isr_cpu_cycles += pmu_get_cycle_count () - start_cycles;
+}
+#endif
+
 /**
  * @brief Initialise the specified UART instance for the console output, using interrupts
  */
 void UARTConsoleInit (void)
 {
     /* Initialise the transmit buffer to be empty */
-    uart_tx_buffer = malloc (UART_BUFFER_SIZE);
-    uart_tx_buffer_num_chars = 0;
     uart_tx_buffer_read_index = 0;
     uart_tx_buffer_write_index = 0;
 
@@ -195,49 +382,138 @@ void UARTConsoleInit (void)
 
     UARTStdioInitExpClk (BAUD_RATE, 1, 1);
 
+    uart_console_stats.bytes_written = 0;
+    uart_console_stats.bytes_discarded = 0;
+    uart_console_stats.write_cpu_cycles = 0;
+    uart_console_stats.isr_cpu_cycles = 0;
+
+#ifdef UART_CONSOLE_TX_EDMA
+    /* Install the EDMA3 completion interrupt handler, with the UART transmit DMA request initially disabled */
+    uart_tx_dma_active = false;
+    EDMAModuleClkConfig ();
+    EDMA3Init (SOC_EDMA30CC_0_REGS, UART_CONSOLE_TX_EDMA_EVENT_QUEUE);
+    (void) EDMA3RequestChannel (SOC_EDMA30CC_0_REGS, EDMA3_CHANNEL_TYPE_DMA, UART_CONSOLE_TX_EDMA_CHANNEL,
+                                UART_CONSOLE_TX_EDMA_CHANNEL, UART_CONSOLE_TX_EDMA_EVENT_QUEUE);
+    IntRegister (SYS_INT_EDMACOMPINT, uart_edma_isr);
+    IntPrioritySet (SYS_INT_EDMACOMPINT, 0, AINTC_HOSTINT_ROUTE_IRQ);
+    IntSystemEnable (SYS_INT_EDMACOMPINT);
+#else
     /* Install the UART transmit interrupt handler, but initially no UART interrupt sources enabled */
     IntRegister (UART_CONSOLE_INT, UART_isr);
     IntPrioritySet (UART_CONSOLE_INT, 0, AINTC_HOSTINT_ROUTE_IRQ);
     IntSystemEnable (UART_CONSOLE_INT);
+#endif
 }
 
 /**
- * @brief This function puts a character on the serial console, without blocking the caller
+ * @brief Write characters to the serial console, without blocking the caller
  * @details To avoid blocking the caller performs the following in preference
- *          a) Write the character directly into UART transmit FIFO when there is space in the FIFO
-  *            and no characters in the software buffer.
-  *         b) Store the character in the software buffer, which will be output by the UART ISR
-  *         c) Discard the character if the software buffer is full.
-  *
-  *         The UART interrupt is temporarily disabled which updating the software buffer.
- * @param[in] data The character to output on the serial console
+ *          a) When not using EDMA3 transmit, write characters directly into UART transmit FIFO while there is space
+ *             in the FIFO and no characters in the software buffer.
+ *          b) Copy the remaining characters into the software buffer, which will be output by the UART ISR
+ *          c) Discard the characters which don't fit in the software buffer.
+ *
+ *          Must only be called from the main-line code, which is the single producer for the software buffer.
+ * @param[in] buf The characters to output on the serial console
+ * @param[in] len The number of characters to output
+ * @return The number of characters accepted for output, which is less than len if the software buffer became full
  */
-void UARTConsolePutc (unsigned char data)
+unsigned int UARTConsoleWrite (const unsigned char *const buf, const unsigned int len)
 {
-    IntSystemDisable (UART_CONSOLE_INT);
-
-    if (uart_tx_buffer_num_chars == UART_BUFFER_SIZE)
+    const uint32_t start_cycles = pmu_get_cycle_count ();
+    const uint32_t write_index = uart_tx_buffer_write_index;
+    const uint32_t read_index = uart_tx_buffer_read_index;
+    uint32_t num_written = 0;
+    uint32_t num_free;
+    uint32_t num_to_buffer;
+
+    /* Ensure any characters read by UART_isr have been read before the space is re-used */
+    data_memory_barrier ();
+
+#ifndef UART_CONSOLE_TX_EDMA
+    if (write_index == read_index)
     {
-        /* The software transmit buffer is full, so the character has to be discarded */
+        /* The software transmit buffer is empty, so characters can be written to the UART transmit FIFO */
+        while ((num_written < len) && (UARTTxFIFOFullStatusGet (UART_CONSOLE_BASE) == UART_TX_FIFO_NOT_FULL))
+        {
+            UARTFIFOWrite (UART_CONSOLE_BASE, (unsigned char *) &buf[num_written], 1);
+            num_written++;
+        }
     }
-    else if ((uart_tx_buffer_num_chars == 0) && (UARTTxFIFOFullStatusGet (UART_CONSOLE_BASE) == UART_TX_FIFO_NOT_FULL))
+#endif
+
+    /* Copy the remaining characters into the software transmit buffer, as two spans if the copy wraps */
+    num_free = UART_BUFFER_SIZE - (write_index - read_index);
+    num_to_buffer = len - num_written;
+    if (num_to_buffer > num_free)
     {
-        /* The software transmit buffer is empty and the UART transmit FIFO is not full,
-         * so the character can be written to the UART transmit FIFO */
-        UARTFIFOWrite (UART_CONSOLE_BASE, &data, 1);
+        num_to_buffer = num_free;
     }
-    else
+    if (num_to_buffer > 0)
     {
-        /* Add the character to the software transmit buffer */
-        uart_tx_buffer[uart_tx_buffer_write_index] = data;
-        uart_tx_buffer_write_index = (uart_tx_buffer_write_index + 1) % UART_BUFFER_SIZE;
-        uart_tx_buffer_num_chars++;
-
-        if (uart_tx_buffer_num_chars == 1)
+        const uint32_t start_offset = write_index & UART_BUFFER_INDEX_MASK;
+        const uint32_t first_span = (num_to_buffer < (UART_BUFFER_SIZE - start_offset)) ?
+                num_to_buffer : (UART_BUFFER_SIZE - start_offset);
+
+        memcpy (&uart_tx_buffer[start_offset], &buf[num_written], first_span);
+        memcpy (&uart_tx_buffer[0], &buf[num_written + first_span], num_to_buffer - first_span);
+        num_written += num_to_buffer;
+
+        /* Publish the characters to the consumer, and then ensure the consumer is running */
+        data_memory_barrier ();
+        uart_tx_buffer_write_index = write_index + num_to_buffer;
+        data_memory_barrier ();
+#ifdef UART_CONSOLE_TX_EDMA
+        if (!uart_tx_dma_active)
         {
-            UARTIntEnable (UART_CONSOLE_BASE, UART_INT_THR);
+            IntSoftwareIntSet (SYS_INT_EDMACOMPINT);
         }
+#else
+        uart_thr_interrupt_set (true);
+#endif
     }
 
-    IntSystemEnable (UART_CONSOLE_INT);
+    uart_console_stats.bytes_written += num_written;
+    uart_console_stats.bytes_discarded += len - num_written;
+    uart_console_stats.write_cpu_cycles += pmu_get_cycle_count () - start_cycles;
+
+    return num_written;
+}
+
+/**
+ * @brief Get the space available in the software transmit buffer
+ * @details Must only be called from the main-line code. A call to UARTConsoleWrite() for up to the returned number of
+ *          characters will accept all the characters, since UART_isr can only increase the space.
+ * @return The number of characters which can be written without any being discarded
+ */
+unsigned int UARTConsoleTxSpaceGet (void)
+{
+    return UART_BUFFER_SIZE - (uart_tx_buffer_write_index - uart_tx_buffer_read_index);
+}
+
+/**
+ * @brief This function puts a character on the serial console, without blocking the caller
+ * @details See UARTConsoleWrite() for how the character is output.
+ * @param[in] data The character to output on the serial console
+ */
+void UARTConsolePutc (unsigned char data)
+{
+    (void) UARTConsoleWrite (&data, 1);
+}
+
+/**
+ * @brief Get the statistics for the CPU overhead of the console output
+ * @param[out] stats Where to store the statistics
+ */
+void UARTConsoleGetStatistics (uart_console_statistics_t *const stats)
+{
+#ifdef UART_CONSOLE_TX_EDMA
+    stats->tx_mode = "EDMA";
+#else
+    stats->tx_mode = "ISR";
+#endif
+    stats->bytes_written = uart_console_stats.bytes_written;
+    stats->bytes_discarded = uart_console_stats.bytes_discarded;
+    stats->write_cpu_cycles = uart_console_stats.write_cpu_cycles;
+    stats->isr_cpu_cycles = uart_console_stats.isr_cpu_cycles;
 }
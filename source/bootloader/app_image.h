@@ -0,0 +1,55 @@
+/*
+ * @file app_image.h
+ * @date 16 Oct 2026
+ * @brief Format of the application images loaded by the bootloader, which contain a CRC32 of the image
+ * @details Only depends upon the standard headers, so is also used by host_tools/app_image which generates the
+ *          images from the output of tiimage.
+ *
+ *          An image is an app_image_header_t followed by stored_size bytes, which are either:
+ *          - The image stored uncompressed.
+ *          - When APP_IMAGE_FLAG_LZ4 is set, the image LZ4 compressed in the block format defined by lz4_image.h.
+ *          The image_crc is the CRC32 (see crc32.c) of the image_size bytes written to load_addr, so is checked after
+ *          any decompression.
+ *
+ *          The bootloader also accepts the images generated by tiimage, which only have the image size and load
+ *          address in the header, but can't verify them.
+ */
+
+#ifndef APP_IMAGE_H_
+#define APP_IMAGE_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Identifies an image with an app_image_header_t. The first word of an image from tiimage is the image size, which
+ * can't be this large. */
+#define APP_IMAGE_MAGIC 0x676D4941u /* "AImg" */
+
+/* Set in the flags when the image is LZ4 compressed */
+#define APP_IMAGE_FLAG_LZ4 0x00000001u
+
+/** The header at the start of an application image. All fields are little endian. */
+typedef struct
+{
+    /** Set to APP_IMAGE_MAGIC */
+    uint32_t magic;
+    /** The address the image is written to, and the entry point */
+    uint32_t load_addr;
+    /** The size of the image written to the load address */
+    uint32_t image_size;
+    /** The number of bytes in the file which follow the header */
+    uint32_t stored_size;
+    /** APP_IMAGE_FLAG_* bits */
+    uint32_t flags;
+    /** The CRC32 of the image written to the load address */
+    uint32_t image_crc;
+} app_image_header_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_IMAGE_H_ */
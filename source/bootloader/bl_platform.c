@@ -59,6 +59,9 @@
 #include "board.h"
 #include "device.h"
 #include "string.h"
+#include "boot_timing.h"
+#include "boot_cache.h"
+#include "boot_timeline.h"
 #ifdef evmAM335x
     #include "hw_tps65910.h"
 #elif  (defined beaglebone)
@@ -73,6 +76,7 @@
     #include "bl_spi.h"
 #elif defined(MMCSD)
     #include "bl_mmcsd.h"
+    #include "mmcsd_fast_copy.h"
 #elif defined(NAND)
     #include "bl_nand.h"
     #include "nandlib.h"
@@ -491,6 +495,18 @@ tOPPConfig oppTable[] =
   static GPMCNANDTimingInfo_t nandTimingInfo;
 #endif
 
+/*
+** The MPU PLL multiplier set by PLLInit(). The PLL reference is the 24MHz
+** master oscillator divided by MPUPLL_N + 1, and MPUPLL_M2 is one, so the
+** MPU clock in MHz equals the multiplier.
+*/
+#ifdef AM3352_SOM
+#define MPU_PLL_MULT            (MPUPLL_M_800_MHZ)
+#else
+#define MPU_PLL_MULT            (oppTable[oppMaxIdx].pllMult)
+#endif
+#define MPU_PLL_REFERENCE_HZ    (1000000u)
+
 
 /******************************************************************************
 **                     Local variable Definitions
@@ -901,11 +917,7 @@ void PowerDomainTransitionInit(void)
  */
 void PLLInit(void)
 {
-#ifdef AM3352_SOM
-    MPUPLLInit(MPUPLL_M_800_MHZ);
-#else
-    MPUPLLInit(oppTable[oppMaxIdx].pllMult);
-#endif
+    MPUPLLInit(MPU_PLL_MULT);
     CorePLLInit();
     PerPLLInit();
     DDRPLLInit(freqMultDDR);
@@ -1980,6 +1992,8 @@ void UARTSetup(void)
 */
 void BlPlatformConfig(void)
 {
+    boot_timing_start ();
+    boot_timeline_start ();
 #ifdef AM3352_SOM
     /* Hard code as no identification EEPROM */
     deviceType = "AM3352 SOM";
@@ -2032,15 +2046,25 @@ void BlPlatformConfig(void)
     }
 #endif
 
+    /* The MPU clock left by the boot ROM isn't known, so measure it */
+    boot_timeline_set_cycle_hz (boot_timing_cycle_counter_hz ());
+    boot_timeline_mark (BOOT_PHASE_BL_EARLY_CONFIG);
+
     /* Set the PLL0 to generate 300MHz for ARM */
     PLLInit();
 
+    /* The MPU PLL is bypassed while it re-locks, so measure the average */
+    boot_timeline_set_cycle_hz (boot_timing_cycle_counter_hz ());
+    boot_timeline_mark (BOOT_PHASE_BL_PLL_INIT);
+    boot_timeline_set_cycle_hz (MPU_PLL_MULT * MPU_PLL_REFERENCE_HZ);
+
     /* Enable the control module */
     HWREG(SOC_CM_WKUP_REGS + CM_WKUP_CONTROL_CLKCTRL) =
             CM_WKUP_CONTROL_CLKCTRL_MODULEMODE_ENABLE;
 
     /* EMIF Initialization */
     EMIFInit();
+    boot_timeline_mark (BOOT_PHASE_BL_EMIF_INIT);
 
     /* DDR Initialization */
 
@@ -2070,7 +2094,15 @@ void BlPlatformConfig(void)
         DDR2Init();
     }
 #endif
+    boot_timeline_mark (BOOT_PHASE_BL_DDR3_INIT);
     UARTSetup();
+    boot_timeline_mark (BOOT_PHASE_BL_UART_SETUP);
+
+#if BOOT_CACHED_COPY
+    /* Run the image copy with the MMU and caches enabled, now the DDR is initialised */
+    boot_cache_enable ();
+    boot_timeline_mark (BOOT_PHASE_BL_CACHE_ENABLE);
+#endif
 }
 
 /*
@@ -2110,6 +2142,12 @@ static void DDRVTTEnable(void)
 */
 void BlPlatformConfigPostBoot( void )
 {
+#if BOOT_CACHED_COPY
+    /* Leave the MMU and caches disabled for the application, with the image written to memory */
+    boot_cache_disable ();
+#endif
+    UARTprintf ("Boot to jump time %u us\n", (unsigned int) boot_timing_get_us ());
+    boot_timeline_mark (BOOT_PHASE_BL_EXIT);
 }
 
 /*
@@ -2151,10 +2189,7 @@ unsigned int BlPlatformSPIImageCopy()
 
 unsigned int BlPlatformMMCSDImageCopy()
 {
-    HSMMCSDInit();
-    HSMMCSDImageCopy();
-
-    return (TRUE);
+    return mmcsd_fast_image_copy ();
 }
 
 #endif
@@ -0,0 +1,117 @@
+/*
+ * @file boot_cache.c
+ * @date 16 Oct 2026
+ * @brief Enables the MMU and caches in the bootloader for the image copy
+ * @details With the MMU disabled all data accesses are treated as strongly ordered, which means the bootloader runs
+ *          uncached and any unaligned access generates a data abort. The image copy enables the MMU with a flat
+ *          (virtual address == physical address) section mapping of the memory used by the bootloader:
+ *          - The internal SRAM containing the bootloader, the L3 OCMC RAM and the DDR as normal memory with write back
+ *            caching, so that unaligned accesses are allowed.
+ *          - The peripherals between the OCMC RAM and DDR as device memory, marked execute never.
+ *          Addresses outside of these regions, such as the ROM and GPMC, are left unmapped so an access generates an
+ *          abort.
+ *
+ *          The page table is only needed until the application is started, so is placed at the end of the L3 OCMC
+ *          RAM rather than using 16K of the bootloader internal SRAM. An application image can't be loaded over the
+ *          page table while the MMU is enabled, which the image copy checks with boot_cache_page_table_overlaps().
+ *
+ *          The caller is responsible for cache maintenance around DMA transfers while the caches are enabled.
+ *
+ *          Only used when BOOT_CACHED_COPY is non-zero. Everything before boot_cache_enable() at the end of
+ *          BlPlatformConfig(), including the C runtime start, still runs with the MMU disabled. So the bootloader
+ *          remains linked with c_nano and ff.c built with -mno-unaligned-access, to avoid unaligned accesses.
+ */
+
+#include "mmu.h"
+#include "cache.h"
+#include "cp15.h"
+#include "boot_cache.h"
+
+/* The number of 1MB section entries in the first level page table, which covers the 4GB address space */
+#define PAGE_TABLE_NUM_ENTRIES 4096u
+
+/** The first level page table, in a NOLOAD section placed by the linker script at the end of the OCMC RAM.
+ *  Cleared by MMUInit(). */
+static unsigned int page_table[PAGE_TABLE_NUM_ENTRIES]
+__attribute__((aligned(MMU_PAGETABLE_ALIGN_SIZE)))
+__attribute__((section(".mmu_page_table")));
+
+/* The cache policy for RAM, which is write back for both the inner (L1 and L2) and outer caches */
+#define BOOT_RAM_MEMTYPE MMU_MEMTYPE_NORMAL_NON_SHAREABLE(MMU_CACHE_WB_WA, MMU_CACHE_WB_WA)
+
+/* The MMU regions used, each of which is a number of 1MB sections */
+#define START_ADDR_SRAM            (0x40200000)
+#define START_ADDR_OCMC            (0x40300000)
+#define START_ADDR_DEV             (0x44000000)
+#define START_ADDR_DDR             (0x80000000)
+#define NUM_SECTIONS_SRAM          (1)
+#define NUM_SECTIONS_OCMC          (1)
+#define NUM_SECTIONS_DEV           (960)
+#define NUM_SECTIONS_DDR           (512)
+
+/**
+ * @brief Build the page table, and then enable the MMU, instruction cache and data cache
+ * @details Must be called after BlPlatformConfig() has initialised the DDR.
+ */
+void boot_cache_enable (void)
+{
+    REGION regions[] =
+    {
+        {
+            MMU_PGTYPE_SECTION, START_ADDR_SRAM, NUM_SECTIONS_SRAM,
+            BOOT_RAM_MEMTYPE, MMU_REGION_NON_SECURE, MMU_AP_PRV_RW_USR_RW, page_table
+        },
+        {
+            MMU_PGTYPE_SECTION, START_ADDR_OCMC, NUM_SECTIONS_OCMC,
+            BOOT_RAM_MEMTYPE, MMU_REGION_NON_SECURE, MMU_AP_PRV_RW_USR_RW, page_table
+        },
+        {
+            MMU_PGTYPE_SECTION, START_ADDR_DEV, NUM_SECTIONS_DEV,
+            MMU_MEMTYPE_DEVICE_SHAREABLE, MMU_REGION_NON_SECURE, MMU_AP_PRV_RW_USR_RW | MMU_SECTION_EXEC_NEVER,
+            page_table
+        },
+        {
+            MMU_PGTYPE_SECTION, START_ADDR_DDR, NUM_SECTIONS_DDR,
+            BOOT_RAM_MEMTYPE, MMU_REGION_NON_SECURE, MMU_AP_PRV_RW_USR_RW, page_table
+        }
+    };
+    unsigned int region_index;
+
+    /* The page table is written with the data cache disabled, so is in memory for the table walks */
+    MMUInit (page_table);
+    for (region_index = 0; region_index < (sizeof (regions) / sizeof (regions[0])); region_index++)
+    {
+        MMUMemRegionMap (&regions[region_index]);
+    }
+    MMUEnable (page_table);
+    CacheEnable (CACHE_ALL);
+}
+
+/**
+ * @brief Disable the caches and MMU, ready to jump to the application
+ * @details The data cache is cleaned to memory before being disabled, so the application image written by the CPU
+ *          is in memory. The instruction cache and TLB are invalidated, so the application starts with the same state
+ *          as when the bootloader was started by the ROM and no stale instructions from the load address can be
+ *          executed.
+ */
+void boot_cache_disable (void)
+{
+    CacheDisable (CACHE_ALL);
+    CP15MMUDisable ();
+    CacheInstInvalidateAll ();
+    CP15TlbInvalidate ();
+}
+
+/**
+ * @brief Check if a region of memory overlaps the page table
+ * @param[in] start_addr The start address of the region
+ * @param[in] num_bytes The size of the region
+ * @return Returns true if the region overlaps the page table, and so can't be written while the MMU is enabled
+ */
+bool boot_cache_page_table_overlaps (const uint32_t start_addr, const uint32_t num_bytes)
+{
+    const uint32_t table_start = (uint32_t) page_table;
+    const uint32_t table_end = table_start + sizeof (page_table);
+
+    return (start_addr < table_end) && ((start_addr + num_bytes) > table_start);
+}
@@ -0,0 +1,34 @@
+/*
+ * @file boot_cache.h
+ * @date 16 Oct 2026
+ * @brief Interface to the bootloader MMU and cache enable, used for the image copy
+ */
+
+#ifndef BOOT_CACHE_H_
+#define BOOT_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* When non-zero BlPlatformConfig() enables the MMU and caches for the image copy, as selected by the
+ * BOOTLOADER_CACHED_COPY CMake option. When zero the bootloader runs with the MMU disabled throughout. */
+#ifndef BOOT_CACHED_COPY
+#define BOOT_CACHED_COPY 1
+#endif
+
+/* The Cortex-A8 L1 data cache line size, for aligning buffers which are written by DMA */
+#define BOOT_CACHE_LINE_SIZE 64u
+
+void boot_cache_enable (void);
+void boot_cache_disable (void);
+bool boot_cache_page_table_overlaps (const uint32_t start_addr, const uint32_t num_bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_CACHE_H_ */
@@ -0,0 +1,71 @@
+/*
+ * @file boot_timing.c
+ * @date 16 Oct 2026
+ * @brief Bootloader timing, measured from the start of the bootloader
+ * @details DMTimer2 free runs from the master oscillator, which is independent of the PLLs which are re-programmed
+ *          by the bootloader. The bootloader runs without interrupts, and the 32-bit count doesn't wrap until
+ *          after about 3 minutes. The application may re-use DMTimer2 once it has started.
+ *
+ *          The timer is also the reference used to measure the frequency of the PMU cycle counter for the boot timeline
+ *          phases during which the MPU clock isn't known.
+ */
+
+#include "soc_AM335x.h"
+#include "hw_types.h"
+#include "dmtimer.h"
+#include "AM3352_SOM.h"
+#include "boot_timing.h"
+
+#define BOOT_TIMER_BASE SOC_DMTIMER_2_REGS
+
+/* The frequency of the master oscillator crystal which clocks the timer, read from the SYSBOOT pins */
+static uint32_t boot_timer_hz;
+
+/* The timer count and cycle counter at the previous boot_timing_cycle_counter_hz() call */
+static uint32_t previous_ticks;
+static uint32_t previous_cycles;
+
+/**
+ * @brief Start the boot timer from zero. Called at the start of the bootloader, immediately before
+ *        boot_timeline_start() resets the cycle counter.
+ */
+void boot_timing_start (void)
+{
+    boot_timer_hz = get_crystal_hz ();
+    previous_ticks = 0;
+    previous_cycles = 0;
+    DMTimer2ModuleClkConfig ();
+    DMTimerDisable (BOOT_TIMER_BASE);
+    DMTimerReloadSet (BOOT_TIMER_BASE, 0);
+    DMTimerCounterSet (BOOT_TIMER_BASE, 0);
+    DMTimerModeConfigure (BOOT_TIMER_BASE, DMTIMER_AUTORLD_NOCMP_ENABLE);
+    DMTimerEnable (BOOT_TIMER_BASE);
+}
+
+/**
+ * @brief Get the time since boot_timing_start()
+ * @return The time in microseconds
+ */
+uint32_t boot_timing_get_us (void)
+{
+    /* Not a whole number of ticks per microsecond with a 19.2 MHz crystal */
+    return (uint32_t) (((uint64_t) DMTimerCounterGet (BOOT_TIMER_BASE) * 1000000u) / boot_timer_hz);
+}
+
+/**
+ * @brief Measure the average frequency of the PMU cycle counter since the previous call, or since the start
+ * @details Used for the boot timeline phases during which the MPU clock changes.
+ * @return The average cycle counter frequency in Hz, or zero if no timer ticks have elapsed
+ */
+uint32_t boot_timing_cycle_counter_hz (void)
+{
+    const uint32_t ticks = DMTimerCounterGet (BOOT_TIMER_BASE);
+    const uint32_t cycles = pmu_get_cycle_count ();
+    const uint32_t elapsed_ticks = ticks - previous_ticks;
+    const uint32_t elapsed_cycles = cycles - previous_cycles;
+
+    previous_ticks = ticks;
+    previous_cycles = cycles;
+
+    return (elapsed_ticks > 0) ? (uint32_t) (((uint64_t) elapsed_cycles * boot_timer_hz) / elapsed_ticks) : 0;
+}
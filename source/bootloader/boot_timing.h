@@ -0,0 +1,24 @@
+/*
+ * @file boot_timing.h
+ * @date 16 Oct 2026
+ * @brief Interface to the bootloader timing, measured from the start of the bootloader
+ */
+
+#ifndef BOOT_TIMING_H_
+#define BOOT_TIMING_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void boot_timing_start (void);
+uint32_t boot_timing_get_us (void);
+uint32_t boot_timing_cycle_counter_hz (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_TIMING_H_ */
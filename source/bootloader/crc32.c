@@ -0,0 +1,114 @@
+/*
+ * @file crc32.c
+ * @date 16 Oct 2026
+ * @brief CRC32, as used by zlib and Ethernet, calculated using the slice-by-8 algorithm
+ * @details Slice-by-8 processes 8 bytes per iteration using 8 lookup tables of 256 entries, which removes the
+ *          dependency of each table lookup on the previous lookup in the byte at a time algorithm. The 8kB of tables
+ *          fits in the Cortex-A8 L1 data cache, and are generated on the first call rather than occupying space in
+ *          the bootloader image.
+ *
+ *          Only depends upon the standard library, so is also used by host_tools/app_image to calculate the CRC of
+ *          the application images. Assumes a little endian CPU, which is the case for both the AM335x and x86 hosts.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "crc32.h"
+
+/* The reversed CRC32 polynomial */
+#define CRC32_POLYNOMIAL 0xEDB88320u
+
+#define CRC32_NUM_SLICES 8u
+
+static uint32_t crc32_tables[CRC32_NUM_SLICES][256];
+static bool crc32_tables_initialised;
+
+/**
+ * @brief Generate the slice-by-8 lookup tables
+ * @details Table 0 is the standard byte at a time table. Table N gives the CRC of a byte followed by N zero bytes.
+ */
+static void crc32_init_tables (void)
+{
+    uint32_t value;
+    uint32_t crc;
+    uint32_t bit;
+    uint32_t slice;
+
+    for (value = 0; value < 256; value++)
+    {
+        crc = value;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = ((crc & 1) != 0) ? ((crc >> 1) ^ CRC32_POLYNOMIAL) : (crc >> 1);
+        }
+        crc32_tables[0][value] = crc;
+    }
+
+    for (value = 0; value < 256; value++)
+    {
+        crc = crc32_tables[0][value];
+        for (slice = 1; slice < CRC32_NUM_SLICES; slice++)
+        {
+            crc = crc32_tables[0][crc & 0xFFu] ^ (crc >> 8);
+            crc32_tables[slice][value] = crc;
+        }
+    }
+
+    crc32_tables_initialised = true;
+}
+
+/**
+ * @brief Update a CRC32 with a block of data
+ * @details The CRC of a sequence of blocks is calculated by passing the result for one block to the call for the next,
+ *          starting from zero for the first block; the same convention as the zlib crc32() function.
+ * @param[in] crc The CRC of the preceding data, or zero at the start
+ * @param[in] data The data to add to the CRC
+ * @param[in] len The number of bytes of data
+ * @return The updated CRC
+ */
+uint32_t crc32_update (const uint32_t crc, const void *const data, const uint32_t len)
+{
+    const uint8_t *bytes = data;
+    uint32_t remaining = len;
+    uint32_t state = ~crc;
+    uint32_t low_word;
+    uint32_t high_word;
+
+    if (!crc32_tables_initialised)
+    {
+        crc32_init_tables ();
+    }
+
+    /* Process bytes until word aligned, so the main loop uses aligned loads */
+    while ((remaining > 0) && (((uintptr_t) bytes & (sizeof (uint32_t) - 1)) != 0))
+    {
+        state = crc32_tables[0][(state ^ *bytes++) & 0xFFu] ^ (state >> 8);
+        remaining--;
+    }
+
+    while (remaining >= CRC32_NUM_SLICES)
+    {
+        memcpy (&low_word, bytes, sizeof (low_word));
+        memcpy (&high_word, &bytes[sizeof (low_word)], sizeof (high_word));
+        low_word ^= state;
+        state = crc32_tables[7][low_word & 0xFFu] ^
+                crc32_tables[6][(low_word >> 8) & 0xFFu] ^
+                crc32_tables[5][(low_word >> 16) & 0xFFu] ^
+                crc32_tables[4][low_word >> 24] ^
+                crc32_tables[3][high_word & 0xFFu] ^
+                crc32_tables[2][(high_word >> 8) & 0xFFu] ^
+                crc32_tables[1][(high_word >> 16) & 0xFFu] ^
+                crc32_tables[0][high_word >> 24];
+        bytes += CRC32_NUM_SLICES;
+        remaining -= CRC32_NUM_SLICES;
+    }
+
+    while (remaining > 0)
+    {
+        state = crc32_tables[0][(state ^ *bytes++) & 0xFFu] ^ (state >> 8);
+        remaining--;
+    }
+
+    return ~state;
+}
@@ -0,0 +1,22 @@
+/*
+ * @file crc32.h
+ * @date 16 Oct 2026
+ * @brief Interface to the CRC32 used to verify application images
+ */
+
+#ifndef CRC32_H_
+#define CRC32_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t crc32_update (const uint32_t crc, const void *const data, const uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC32_H_ */
@@ -0,0 +1,136 @@
+/*
+ * @file lz4_image.c
+ * @date 16 Oct 2026
+ * @brief Decoder for the blocks of LZ4 compressed application images
+ * @details The input is validated as it is decoded, so a corrupt block fails to decode rather than writing outside
+ *          of the image. Only depends upon the standard library, so is also used by host_tools/app_image to
+ *          verify the compressed image.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "lz4_image.h"
+
+/* LZ4 block format definitions */
+#define LZ4_MIN_MATCH 4u
+#define LZ4_TOKEN_LENGTH_MASK 0x0Fu
+#define LZ4_TOKEN_LITERAL_SHIFT 4u
+#define LZ4_LENGTH_EXTENDED 15u
+#define LZ4_LENGTH_BYTE_CONTINUE 255u
+
+/**
+ * @brief Read the extension bytes of a literal or match length
+ * @param[in,out] ip The position in the input, advanced past the extension bytes
+ * @param[in] ip_end The end of the input
+ * @param[in,out] length The length from the token, to which the extension bytes are added
+ * @return Returns false if the input ended before the end of the length
+ */
+static bool read_extended_length (const uint8_t **const ip, const uint8_t *const ip_end, uint32_t *const length)
+{
+    uint32_t extension_byte;
+
+    do
+    {
+        if (*ip >= ip_end)
+        {
+            return false;
+        }
+        extension_byte = *(*ip)++;
+        *length += extension_byte;
+    } while (extension_byte == LZ4_LENGTH_BYTE_CONTINUE);
+
+    return true;
+}
+
+/**
+ * @brief Decode one compressed block of an image
+ * @param[in] src The block data, in the LZ4 block format
+ * @param[in] src_len The number of bytes of block data
+ * @param[out] dst Where to write the decompressed block
+ * @param[in] dst_len The expected number of decompressed bytes
+ * @param[in] dst_start The start of the decompressed image. Matches may reference the previously decompressed data
+ *                      from dst_start onwards.
+ * @return Returns true if the block was decoded to exactly dst_len bytes, or false if the block is corrupt
+ */
+bool lz4_image_decode_block (const uint8_t *const src, const uint32_t src_len,
+                             uint8_t *const dst, const uint32_t dst_len, const uint8_t *const dst_start)
+{
+    const uint8_t *ip = src;
+    const uint8_t *const ip_end = src + src_len;
+    uint8_t *op = dst;
+    uint8_t *const op_end = dst + dst_len;
+    uint32_t token;
+    uint32_t length;
+    uint32_t offset;
+    const uint8_t *match;
+
+    while (ip < ip_end)
+    {
+        token = *ip++;
+
+        /* Copy the literals */
+        length = token >> LZ4_TOKEN_LITERAL_SHIFT;
+        if ((length == LZ4_LENGTH_EXTENDED) && !read_extended_length (&ip, ip_end, &length))
+        {
+            return false;
+        }
+        if ((length > (uint32_t) (ip_end - ip)) || (length > (uint32_t) (op_end - op)))
+        {
+            return false;
+        }
+        memcpy (op, ip, length);
+        ip += length;
+        op += length;
+
+        /* The final sequence of a block only has literals */
+        if (ip == ip_end)
+        {
+            break;
+        }
+
+        /* Copy the match, which may overlap the output when the offset is less than the length */
+        if ((ip_end - ip) < 2)
+        {
+            return false;
+        }
+        offset = (uint32_t) ip[0] | ((uint32_t) ip[1] << 8);
+        ip += 2;
+        if ((offset == 0) || (offset > (uint32_t) (op - dst_start)))
+        {
+            return false;
+        }
+        length = token & LZ4_TOKEN_LENGTH_MASK;
+        if ((length == LZ4_LENGTH_EXTENDED) && !read_extended_length (&ip, ip_end, &length))
+        {
+            return false;
+        }
+        length += LZ4_MIN_MATCH;
+        if (length > (uint32_t) (op_end - op))
+        {
+            return false;
+        }
+
+        match = op - offset;
+        if (offset >= length)
+        {
+            memcpy (op, match, length);
+            op += length;
+        }
+        else if (offset == 1)
+        {
+            memset (op, *match, length);
+            op += length;
+        }
+        else
+        {
+            while (length > 0)
+            {
+                *op++ = *match++;
+                length--;
+            }
+        }
+    }
+
+    return op == op_end;
+}
@@ -0,0 +1,48 @@
+/*
+ * @file lz4_image.h
+ * @date 16 Oct 2026
+ * @brief Format of the LZ4 compressed application images loaded by the bootloader
+ * @details Only depends upon the standard headers, so is also used by host_tools/app_image which generates the
+ *          compressed images.
+ *
+ *          A compressed image is an app_image_header_t with APP_IMAGE_FLAG_LZ4 set, followed by a sequence of blocks.
+ *          Each block is a 32-bit little endian block header followed by the block data:
+ *          - The block header contains the number of bytes of block data, with LZ4_IMAGE_BLOCK_STORED set if the
+ *            block data is stored uncompressed because it didn't compress.
+ *          - A compressed block is in the LZ4 block format.
+ *          - Each block decompresses to LZ4_IMAGE_BLOCK_SIZE bytes, apart from the final block which may be shorter.
+ *          The blocks are linked, i.e. matches in a block may reference the decompressed data of previous blocks.
+ *          This means the compression ratio isn't reduced by splitting the image into blocks, while only one block at
+ *          a time has to be buffered by the bootloader since the image is decompressed directly to its load address.
+ */
+
+#ifndef LZ4_IMAGE_H_
+#define LZ4_IMAGE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The maximum number of decompressed bytes in one block */
+#define LZ4_IMAGE_BLOCK_SIZE 4096u
+
+/* Set in a block header when the block data is stored uncompressed */
+#define LZ4_IMAGE_BLOCK_STORED 0x80000000u
+
+/* The size of a block header */
+#define LZ4_IMAGE_BLOCK_HEADER_SIZE sizeof (uint32_t)
+
+/* The maximum size of a block including the header, since a block which doesn't compress is stored */
+#define LZ4_IMAGE_MAX_BLOCK_BYTES (LZ4_IMAGE_BLOCK_HEADER_SIZE + LZ4_IMAGE_BLOCK_SIZE)
+
+bool lz4_image_decode_block (const uint8_t *const src, const uint32_t src_len,
+                             uint8_t *const dst, const uint32_t dst_len, const uint8_t *const dst_start);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LZ4_IMAGE_H_ */
@@ -0,0 +1,491 @@
+/*
+ * @file mmcsd_fast_copy.c
+ * @date 16 Oct 2026
+ * @brief Copies the application image from the SD card using multi-block EDMA reads on a 4-bit high speed bus
+ * @details Replaces the StarterWare HSMMCSDInit() and HSMMCSDImageCopy() in the bootloader, to reduce the boot time:
+ *          - The card is switched to a 4-bit bus and high speed (50 MHz) mode, when the card supports it.
+ *          - The image is read by FatFs directly into the load address. Since the image starts after the header, only
+ *            the first sector is read via a buffer. The remaining reads are then sector aligned in the
+ *            file, which allows FatFs to read up to a cluster at once with a CMD18 multi-block read.
+ *          - The SD card is accessed through the platform mmcsd_block layer, in which the EDMA3 transfers one
+ *            block per MMC/SD DMA request with completion polled rather than using interrupts. The block layer
+ *            applies a timeout to every wait for the controller and retries failures, so a card or controller which
+ *            stops responding delays the boot by a bounded time rather than hanging it.
+ *          - Optionally the image is LZ4 compressed by host_tools/app_image, to reduce the amount read from the SD
+ *            card. The image is decompressed to the load address as it is read.
+ *          - The CRC32 in the header added by host_tools/app_image is verified before the image is started. The CRC
+ *            is calculated while polling for the completion of the SD card transfers, for the part of the image
+ *            which has already been written to the load address, so most of the CRC calculation is hidden.
+ *          - When BOOT_CACHED_COPY is non-zero the copy runs with the MMU and caches enabled by boot_cache_enable(),
+ *            so the data cache is maintained around each EDMA3 transfer by the block layer.
+ *
+ *          The time taken and transfer rate are reported on the console, followed by the block layer retries and
+ *          the latency of each MMC/SD command.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mmcsd_proto.h"
+#include "ff.h"
+#include "uartStdio.h"
+#include "bl.h"
+#include "bl_copy.h"
+#include "bl_platform.h"
+#include "boot_timing.h"
+#include "boot_timeline.h"
+#include "boot_cache.h"
+#include "app_image.h"
+#include "crc32.h"
+#include "lz4_image.h"
+#include "mmcsd_block.h"
+#include "mmcsd_fast_copy.h"
+
+/* The application image file, as generated by the tiimage custom commands */
+#define IMAGE_FILE_NAME "app"
+
+/* The FatFs drive number of the SD card */
+#define MMCSD_DRIVE_NUM 0u
+
+/* The size of the reads of a compressed image, which is a multiple of the sector size */
+#define COMPRESSED_READ_SIZE 4096u
+
+/* The number of bytes added to the image CRC on each poll of a transfer status, which is small enough to not delay
+ * noticing the transfer completion */
+#define CRC_POLL_BYTES 256u
+
+/** The load address and sizes of the copied image */
+typedef struct
+{
+    uint32_t load_addr;
+    /** The number of bytes written to the load address */
+    uint32_t image_size;
+    /** The number of bytes read from the image file */
+    uint32_t file_size;
+} image_copy_t;
+
+/* Defined in third_party/fatfs/port/fat_mmcsd.c, which doesn't have a header */
+extern void FATFsMount (unsigned int driveNum, void *ptr, char *path);
+
+static FIL image_file;
+
+/** The calculation of the image CRC, for the part of the image which has been written to the load address */
+typedef struct
+{
+    /** When false, the image has no CRC so isn't calculated */
+    bool enabled;
+    /** The next image byte to add to the CRC */
+    const uint8_t *next;
+    /** The image has been written up to, but not including, this address */
+    const uint8_t *written;
+    /** The end of the image */
+    const uint8_t *end;
+    /** The CRC of the image up to next */
+    uint32_t crc;
+} image_crc_t;
+
+static image_crc_t image_crc;
+
+/** The first sector of the image file, which contains the header followed by the start of the image.
+ *  Cache line aligned, so no other data shares the cache lines written by the DMA. */
+static uint8_t first_sector[MMCSD_BLK_SIZE] __attribute__((aligned(BOOT_CACHE_LINE_SIZE)));
+
+/** Holds the part of a compressed image which has been read but not yet decompressed. Has space for one read after
+ *  the partial block left over from the previous read. */
+static uint8_t compressed_buffer[COMPRESSED_READ_SIZE + LZ4_IMAGE_MAX_BLOCK_BYTES]
+__attribute__((aligned(BOOT_CACHE_LINE_SIZE)));
+
+/**
+ * @brief Start calculating the CRC of an image
+ * @param[in] start The load address of the image
+ * @param[in] size The number of bytes in the image
+ */
+static void image_crc_start (const uint8_t *const start, const uint32_t size)
+{
+    image_crc.enabled = true;
+    image_crc.next = start;
+    image_crc.written = start;
+    image_crc.end = start + size;
+    image_crc.crc = 0;
+}
+
+/**
+ * @brief Record that the image has been written up to an address, so the CRC can be calculated up to that address
+ * @details The image is written in order, so writes which don't continue from the previously written part, e.g. a
+ *          read of the FAT, are ignored.
+ * @param[in] start The start of the data which has been written
+ * @param[in] num_bytes The number of bytes which have been written
+ */
+static void image_crc_written (const uint8_t *const start, const uint32_t num_bytes)
+{
+    if (image_crc.enabled && (start == image_crc.written) && (num_bytes <= (uint32_t) (image_crc.end - start)))
+    {
+        image_crc.written = start + num_bytes;
+    }
+}
+
+/**
+ * @brief Add some of the written part of the image to the CRC, while waiting for a transfer to complete
+ */
+static void image_crc_poll (void)
+{
+    uint32_t num_bytes;
+
+    if (image_crc.enabled && (image_crc.next < image_crc.written))
+    {
+        num_bytes = (uint32_t) (image_crc.written - image_crc.next);
+        if (num_bytes > CRC_POLL_BYTES)
+        {
+            num_bytes = CRC_POLL_BYTES;
+        }
+        image_crc.crc = crc32_update (image_crc.crc, image_crc.next, num_bytes);
+        image_crc.next += num_bytes;
+    }
+}
+
+/**
+ * @brief Complete the CRC calculation once all of the image has been written
+ * @return The CRC of the image
+ */
+static uint32_t image_crc_finish (void)
+{
+    image_crc.crc = crc32_update (image_crc.crc, image_crc.next, (uint32_t) (image_crc.end - image_crc.next));
+    image_crc.next = image_crc.end;
+    image_crc.enabled = false;
+
+    return image_crc.crc;
+}
+
+/**
+ * @brief Check that an image can be written to its load address
+ * @param[in] load_addr The load address of the image
+ * @param[in] image_size The number of bytes in the image
+ * @return Returns true if the image can be written, or false if an error has been reported
+ */
+static bool image_load_addr_valid (const uint32_t load_addr, const uint32_t image_size)
+{
+#if BOOT_CACHED_COPY
+    if (boot_cache_page_table_overlaps (load_addr, image_size))
+    {
+        UARTprintf ("%s load address 0x%x size %u overlaps the bootloader MMU page table\n", IMAGE_FILE_NAME,
+                    (unsigned int) load_addr, (unsigned int) image_size);
+        return false;
+    }
+#endif
+    if (boot_timeline_overlaps (load_addr, image_size))
+    {
+        UARTprintf ("%s load address 0x%x size %u overlaps the boot timeline\n", IMAGE_FILE_NAME,
+                    (unsigned int) load_addr, (unsigned int) image_size);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Copy an uncompressed image from the SD card to its load address
+ * @param[in] first_sector_bytes The number of bytes of the image file in first_sector
+ * @param[in] header_size The number of bytes of header before the image in the file
+ * @param[in,out] copy On entry the load address and image size from the header. On exit the file size is set.
+ * @return Returns true if the image was copied, or false if an error has been reported
+ */
+static bool copy_uncompressed_image (const uint32_t first_sector_bytes, const uint32_t header_size,
+                                     image_copy_t *const copy)
+{
+    FRESULT fresult;
+    UINT bytes_read;
+    uint32_t first_sector_image_bytes;
+    uint32_t remaining_bytes;
+    uint8_t *const load_addr = (uint8_t *) copy->load_addr;
+
+    if (!image_load_addr_valid (copy->load_addr, copy->image_size))
+    {
+        return false;
+    }
+
+    first_sector_image_bytes = first_sector_bytes - header_size;
+    if (first_sector_image_bytes > copy->image_size)
+    {
+        first_sector_image_bytes = copy->image_size;
+    }
+    memcpy (load_addr, &first_sector[header_size], first_sector_image_bytes);
+    image_crc_written (load_addr, first_sector_image_bytes);
+
+    /* The file position is now sector aligned, so FatFs reads whole sectors straight into the load address */
+    remaining_bytes = copy->image_size - first_sector_image_bytes;
+    if (remaining_bytes > 0)
+    {
+        fresult = f_read (&image_file, &load_addr[first_sector_image_bytes], remaining_bytes, &bytes_read);
+        if ((fresult != FR_OK) || (bytes_read != remaining_bytes))
+        {
+            UARTprintf ("Failed to read %s : FatFs error %d, read %u of %u bytes\n", IMAGE_FILE_NAME, (int) fresult,
+                        (unsigned int) bytes_read, (unsigned int) remaining_bytes);
+            return false;
+        }
+    }
+
+    copy->file_size = header_size + copy->image_size;
+
+    return true;
+}
+
+/**
+ * @brief Copy an LZ4 compressed image from the SD card, decompressing to its load address while it is read
+ * @details The compressed blocks are read through compressed_buffer in fixed size reads, which keeps the file
+ *          position sector aligned so FatFs reads whole sectors straight into the buffer. Each block is decompressed
+ *          once it is completely in the buffer.
+ * @param[in] first_sector_bytes The number of bytes of the image file in first_sector
+ * @param[in] header The image header
+ * @param[in,out] copy On entry the load address and image size from the header. On exit the file size is set.
+ * @return Returns true if the image was copied, or false if an error has been reported
+ */
+static bool copy_compressed_image (const uint32_t first_sector_bytes, const app_image_header_t *const header,
+                                   image_copy_t *const copy)
+{
+    FRESULT fresult;
+    UINT bytes_read;
+    uint32_t buffered_bytes;
+    uint32_t buffer_offset;
+    uint32_t available_bytes;
+    uint32_t file_remaining;
+    uint32_t read_len;
+    uint32_t block_header;
+    uint32_t block_bytes;
+    uint32_t block_output_bytes;
+    uint32_t output_remaining;
+    uint8_t *const load_addr = (uint8_t *) copy->load_addr;
+    uint8_t *output;
+
+    if (!image_load_addr_valid (copy->load_addr, copy->image_size))
+    {
+        return false;
+    }
+
+    buffered_bytes = first_sector_bytes - sizeof (*header);
+    if (buffered_bytes > header->stored_size)
+    {
+        buffered_bytes = header->stored_size;
+    }
+    memcpy (compressed_buffer, &first_sector[sizeof (*header)], buffered_bytes);
+    buffer_offset = 0;
+    file_remaining = header->stored_size - buffered_bytes;
+    output = load_addr;
+    output_remaining = copy->image_size;
+
+    while (output_remaining > 0)
+    {
+        available_bytes = buffered_bytes - buffer_offset;
+        block_bytes = 0;
+        if (available_bytes >= LZ4_IMAGE_BLOCK_HEADER_SIZE)
+        {
+            memcpy (&block_header, &compressed_buffer[buffer_offset], sizeof (block_header));
+            block_bytes = block_header & ~LZ4_IMAGE_BLOCK_STORED;
+            if (block_bytes > LZ4_IMAGE_BLOCK_SIZE)
+            {
+                UARTprintf ("%s has a corrupt block header at offset %u\n", IMAGE_FILE_NAME,
+                            (unsigned int) (output - load_addr));
+                return false;
+            }
+        }
+
+        if (available_bytes < (LZ4_IMAGE_BLOCK_HEADER_SIZE + block_bytes))
+        {
+            /* Move the partial block to the start of the buffer, and read the next part of the file after it */
+            if (file_remaining == 0)
+            {
+                UARTprintf ("%s is truncated\n", IMAGE_FILE_NAME);
+                return false;
+            }
+            memmove (compressed_buffer, &compressed_buffer[buffer_offset], available_bytes);
+            buffer_offset = 0;
+            buffered_bytes = available_bytes;
+            read_len = (file_remaining < COMPRESSED_READ_SIZE) ? file_remaining : COMPRESSED_READ_SIZE;
+            fresult = f_read (&image_file, &compressed_buffer[buffered_bytes], read_len, &bytes_read);
+            if ((fresult != FR_OK) || (bytes_read != read_len))
+            {
+                UARTprintf ("Failed to read %s : FatFs error %d, read %u of %u bytes\n", IMAGE_FILE_NAME,
+                            (int) fresult, (unsigned int) bytes_read, (unsigned int) read_len);
+                return false;
+            }
+            buffered_bytes += read_len;
+            file_remaining -= read_len;
+        }
+        else
+        {
+            block_output_bytes = (output_remaining < LZ4_IMAGE_BLOCK_SIZE) ? output_remaining : LZ4_IMAGE_BLOCK_SIZE;
+            buffer_offset += LZ4_IMAGE_BLOCK_HEADER_SIZE;
+            if ((block_header & LZ4_IMAGE_BLOCK_STORED) != 0)
+            {
+                if (block_bytes != block_output_bytes)
+                {
+                    UARTprintf ("%s has a corrupt stored block at offset %u\n", IMAGE_FILE_NAME,
+                                (unsigned int) (output - load_addr));
+                    return false;
+                }
+                memcpy (output, &compressed_buffer[buffer_offset], block_bytes);
+            }
+            else if (!lz4_image_decode_block (&compressed_buffer[buffer_offset], block_bytes, output,
+                                              block_output_bytes, load_addr))
+            {
+                UARTprintf ("%s has a corrupt compressed block at offset %u\n", IMAGE_FILE_NAME,
+                            (unsigned int) (output - load_addr));
+                return false;
+            }
+            image_crc_written (output, block_output_bytes);
+            buffer_offset += block_bytes;
+            output += block_output_bytes;
+            output_remaining -= block_output_bytes;
+        }
+    }
+
+    copy->file_size = sizeof (*header) + header->stored_size;
+
+    return true;
+}
+
+/**
+ * @brief Copy the application image from the SD card to its load address, once the block layer has been initialised
+ * @param[in] start_us The boot time at which the SD card initialisation started
+ * @return Returns TRUE if the image was copied and verified, or FALSE if an error has been reported
+ */
+static unsigned int copy_image (const uint32_t start_us)
+{
+    uint32_t opened_us;
+    uint32_t copied_us;
+    uint32_t verified_us;
+    uint32_t copy_us;
+    FRESULT fresult;
+    UINT bytes_read;
+    uint32_t magic;
+    app_image_header_t header;
+    ti_header tiimage_header;
+    image_copy_t copy;
+    uint32_t image_crc_value;
+    bool copied;
+
+    /* Opening the file causes FatFs to initialise the card */
+    fresult = f_open (&image_file, IMAGE_FILE_NAME, FA_READ);
+    if (fresult != FR_OK)
+    {
+        UARTprintf ("Failed to open %s on SD card : FatFs error %d\n", IMAGE_FILE_NAME, (int) fresult);
+        return FALSE;
+    }
+    opened_us = boot_timing_get_us ();
+    boot_timeline_mark (BOOT_PHASE_BL_SD_CARD_INIT);
+
+    fresult = f_read (&image_file, first_sector, sizeof (first_sector), &bytes_read);
+    if ((fresult != FR_OK) || (bytes_read < sizeof (tiimage_header)))
+    {
+        UARTprintf ("Failed to read %s header : FatFs error %d\n", IMAGE_FILE_NAME, (int) fresult);
+        return FALSE;
+    }
+
+    memcpy (&magic, first_sector, sizeof (magic));
+    if (magic == APP_IMAGE_MAGIC)
+    {
+        if (bytes_read < sizeof (header))
+        {
+            UARTprintf ("%s is too short for the image header\n", IMAGE_FILE_NAME);
+            return FALSE;
+        }
+        memcpy (&header, first_sector, sizeof (header));
+        copy.load_addr = header.load_addr;
+        copy.image_size = header.image_size;
+        image_crc_start ((const uint8_t *) header.load_addr, header.image_size);
+        if ((header.flags & APP_IMAGE_FLAG_LZ4) != 0)
+        {
+            copied = copy_compressed_image (bytes_read, &header, &copy);
+        }
+        else if (header.stored_size != header.image_size)
+        {
+            UARTprintf ("%s has stored size %u for image size %u\n", IMAGE_FILE_NAME,
+                        (unsigned int) header.stored_size, (unsigned int) header.image_size);
+            copied = false;
+        }
+        else
+        {
+            copied = copy_uncompressed_image (bytes_read, sizeof (header), &copy);
+        }
+    }
+    else
+    {
+        memcpy (&tiimage_header, first_sector, sizeof (tiimage_header));
+        copy.load_addr = tiimage_header.load_addr;
+        copy.image_size = tiimage_header.image_size;
+        copied = copy_uncompressed_image (bytes_read, sizeof (tiimage_header), &copy);
+    }
+    if (!copied)
+    {
+        return FALSE;
+    }
+    (void) f_close (&image_file);
+    copied_us = boot_timing_get_us ();
+    boot_timeline_mark (BOOT_PHASE_BL_IMAGE_COPY);
+
+    /* Complete the CRC of the part of the image written after the last transfer */
+    if (magic == APP_IMAGE_MAGIC)
+    {
+        image_crc_value = image_crc_finish ();
+        verified_us = boot_timing_get_us ();
+        boot_timeline_mark (BOOT_PHASE_BL_IMAGE_VERIFY);
+        if (image_crc_value != header.image_crc)
+        {
+            UARTprintf ("%s CRC 0x%08x doesn't match header CRC 0x%08x\n", IMAGE_FILE_NAME,
+                        (unsigned int) image_crc_value, (unsigned int) header.image_crc);
+            return FALSE;
+        }
+    }
+    else
+    {
+        verified_us = copied_us;
+        UARTprintf ("Warning: %s has no CRC, so hasn't been verified\n", IMAGE_FILE_NAME);
+    }
+    entryPoint = (unsigned int) copy.load_addr;
+
+    copy_us = verified_us - opened_us;
+    if (copy_us == 0)
+    {
+        copy_us = 1;
+    }
+    UARTprintf ("SD card initialised in %u us, %u-bit bus at %u Hz\n", (unsigned int) (opened_us - start_us),
+                mmcsd_block_bus_width (), mmcsd_block_bus_clock_hz ());
+    if ((magic == APP_IMAGE_MAGIC) && ((header.flags & APP_IMAGE_FLAG_LZ4) != 0))
+    {
+        UARTprintf ("Decompressed %u bytes from %u bytes of LZ4 image\n", (unsigned int) copy.image_size,
+                    (unsigned int) copy.file_size);
+    }
+    if (magic == APP_IMAGE_MAGIC)
+    {
+        UARTprintf ("Verified CRC 0x%08x, %u us after the copy\n", (unsigned int) header.image_crc,
+                    (unsigned int) (verified_us - copied_us));
+    }
+    UARTprintf ("Copied %u bytes to 0x%x in %u us = %u.%02u MB/s\n", (unsigned int) copy.image_size,
+                (unsigned int) copy.load_addr, (unsigned int) copy_us,
+                (unsigned int) (copy.image_size / copy_us),
+                (unsigned int) (((uint64_t) copy.image_size * 100u / copy_us) % 100u));
+
+    return TRUE;
+}
+
+/**
+ * @brief Copy the application image from the SD card to its load address
+ * @details The image is normally in the format generated by host_tools/app_image, which is verified using the CRC
+ *          and may be LZ4 compressed. An image generated by tiimage without a CRC is also accepted, with a warning.
+ *          Sets entryPoint to the load address of the image.
+ * @return Returns TRUE if the image was copied and verified, or FALSE if an error has been reported
+ */
+unsigned int mmcsd_fast_image_copy (void)
+{
+    const uint32_t start_us = boot_timing_get_us ();
+    unsigned int copied;
+
+    /* The image CRC is calculated while waiting for transfers, for the reads which have completed */
+    mmcsd_block_init (image_crc_poll, image_crc_written);
+    FATFsMount (MMCSD_DRIVE_NUM, mmcsd_block_card (), "0:/");
+
+    copied = copy_image (start_us);
+    mmcsd_block_print_statistics ();
+
+    return copied;
+}
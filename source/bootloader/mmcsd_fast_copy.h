@@ -0,0 +1,20 @@
+/*
+ * @file mmcsd_fast_copy.h
+ * @date 16 Oct 2026
+ * @brief Interface to copy the application image from the SD card using multi-block EDMA reads
+ */
+
+#ifndef MMCSD_FAST_COPY_H_
+#define MMCSD_FAST_COPY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+unsigned int mmcsd_fast_image_copy (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MMCSD_FAST_COPY_H_ */
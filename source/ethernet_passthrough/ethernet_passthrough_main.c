@@ -18,7 +18,20 @@
 #include <cpsw.h>
 #include <rtc.h>
 #include <interrupt.h>
+#include <cache.h>
+#include <cp15.h>
 #include <hw/hw_types.h>
+#include <cpsw_cpdma.h>
+#include <dma_coherency.h>
+#include <packet_pool.h>
+#include <mmu_page_table.h>
+#include <dlog.h>
+#include <pmu.h>
+#include <timestamp.h>
+#include <scheduler.h>
+#include <mdio_async.h>
+#include <profiler.h>
+#include <boot_timeline.h>
 
 /* Copies of macros from drivers/rtc.c which are not part of the API */
 #define MASK_HOUR            (0xFF000000u)
@@ -31,6 +44,70 @@
 
 #define LEN_MAC_ADDRESS 6
 
+/* Selects how frames are forwarded between CPSW port 1 and port 2:
+ * - When non-zero the ALE is bypassed, so that all received frames are sent to the host port, and software forwards
+ *   each frame to the other port using a directed packet. The buffer containing the frame is passed from the RX queue
+ *   to the TX queue without being copied.
+ * - When zero the ALE forwards frames between the ports, and floods a copy of each frame to the host port. */
+#ifndef SOFTWARE_BRIDGE
+#define SOFTWARE_BRIDGE 0
+#endif
+
+/* The number of buckets in the software bridge latency histogram. Bucket N counts latencies in the range
+ * [2^N .. 2^(N+1)-1] CPU cycles, with bucket 0 also counting a latency of zero. */
+#define LATENCY_HISTOGRAM_BUCKETS 32
+
+/* When non-zero, each statistics reporting interval uses the next setting from cpdma_benchmark_settings[]
+ * and reports the frames/s and CPU cycles per frame achieved with the setting. */
+#ifndef CPDMA_BENCHMARK
+#define CPDMA_BENCHMARK 0
+#endif
+
+/* When non-zero the MMU and caches are enabled, using the page tables generated from the memory map with the policies
+ * selected in the CMakeLists.txt. When zero the program runs with the MMU disabled, which means all memory accesses
+ * are uncached. */
+#ifndef CACHES_ENABLED
+#define CACHES_ENABLED 1
+#endif
+
+/* The policy of the DDR containing the program and packet buffers when cached, which is the ddr policy selected in the
+ * CMakeLists.txt */
+#ifndef CACHED_DDR_POLICY
+#define CACHED_DDR_POLICY MEMORY_POLICY_NORMAL_WB
+#endif
+
+/* When non-zero, each statistics reporting interval alternates the DDR between cached and non-cacheable
+ * and reports the frames/s and CPU cycles per frame achieved with each policy. */
+#ifndef CACHE_BENCHMARK
+#define CACHE_BENCHMARK 0
+#endif
+
+#if CACHE_BENCHMARK && !CACHES_ENABLED
+#error "CACHE_BENCHMARK requires CACHES_ENABLED"
+#endif
+
+/* When non-zero the CPDMA RX completion interrupt is routed to FIQ, so that received frames are forwarded by the
+ * software bridge from the FIQ handler. This pre-empts the console and timer IRQs, and removes the delay until the
+ * CPDMA poll task runs, which is shown by the software bridge latency histogram. */
+#ifndef RX_FIQ
+#define RX_FIQ 0
+#endif
+
+/* When non-zero the sampling profiler is run, and the histogram is dumped on the console after each statistics report
+ * for host_tools/profile_symbolize. Sampling is stopped while the histogram is dumped. */
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 0
+#endif
+
+/* The profiler sample rate, which is a prime so that the samples don't alias with periodic activity */
+#define PROFILER_SAMPLE_HZ 9973
+
+/* The interval at which the profile dump is continued, while waiting for space in the console buffer */
+#define PROFILE_DUMP_RETRY_MS 20
+
+/* The interval in seconds between reporting the statistics */
+#define STATISTICS_INTERVAL_SECS 10
+
 /* MDIO input and output frequencies in Hz */
 #define MDIO_FREQ_INPUT                          125000000
 #define MDIO_FREQ_OUTPUT                         1000000
@@ -101,6 +178,26 @@ typedef struct
     unsigned int tx_octets;
 } cpsw_statistics_t;
 
+/** Histogram of the software bridge latency, measured in CPU cycles from the start of the RX interrupt until
+ *  the frame has been queued for transmission */
+typedef struct
+{
+    /** The number of frames in each bucket, using log2 bucket sizes */
+    uint32_t counts[LATENCY_HISTOGRAM_BUCKETS];
+    /** The minimum and maximum latency measured */
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+} latency_histogram_t;
+
+/** One setting of the CPDMA engine batch size and interrupt pacing */
+typedef struct
+{
+    /** The maximum number of descriptors processed in each queue per poll */
+    uint32_t budget;
+    /** The maximum number of interrupts per millisecond, or zero for interrupt pacing disabled */
+    uint32_t max_interrupts_per_ms;
+} cpdma_setting_t;
+
 /** Possible values for the link speed of one Ethernet phy */
 typedef enum
 {
@@ -134,6 +231,94 @@ typedef struct
     phy_derived_link_speed link_speed;
 } phy_status_t;
 
+/** The phy register being read by the phy link task */
+typedef enum
+{
+    PHY_READ_IDLE,
+    PHY_READ_LINK_STATUS,
+    PHY_READ_BASIC_STATUS,
+    PHY_READ_PARTNER_ABILITY,
+    PHY_READ_1000BT_STATUS
+} phy_read_state;
+
+/** The state of the phy link task, which reads the status of one phy at a time using non-blocking MDIO reads */
+typedef struct
+{
+    /** The phy register read in progress */
+    phy_read_state state;
+    /** The phy whose status is being read */
+    uint32_t phy_address;
+    /** Bitmask of the phy addresses which have had a link change, and are waiting to have their status read */
+    uint32_t pending_phys;
+    /** The status being read */
+    phy_status_t status;
+} phy_reader_t;
+
+#if CACHES_ENABLED
+/* Defined in the source file generated at build time by host_tools/mmu_page_table, from the platform memory map with
+ * the policies selected in the CMakeLists.txt. Writable so that the cache benchmark can change the DDR policy. */
+extern uint32_t mmu_page_table[MMU_PAGE_TABLE_NUM_ENTRIES];
+#endif
+
+#if CPDMA_BENCHMARK
+/** The settings which are cycled through in benchmark mode */
+static const cpdma_setting_t cpdma_benchmark_settings[] =
+{
+    { 1, 0}, { 4, 0}, {16, 0}, {64, 0},
+    { 1, 8}, { 4, 8}, {16, 8}, {64, 8},
+    {16, 2}, {16, 32}, {64, 32}, {64, 63}
+};
+#define NUM_CPDMA_BENCHMARK_SETTINGS (sizeof (cpdma_benchmark_settings) / sizeof (cpdma_benchmark_settings[0]))
+
+/** The PMU events counted in benchmark mode, reported per received frame */
+static const pmu_event_set_t cpdma_benchmark_pmu_events =
+{
+    .events = {PMU_EVENT_L1D_CACHE_REFILL, PMU_EVENT_L2_CACHE_MISS, PMU_EVENT_DTLB_REFILL, PMU_EVENT_BRANCH_MISPREDICTED}
+};
+#endif
+
+/** The latency of frames forwarded by the software bridge, updated by software_bridge_rx_handler() */
+static latency_histogram_t bridge_latency;
+
+/** The status of the Ethernet phys, updated by the phy link task */
+static phy_status_t current_phys_status[NUM_PHY_ADDRESSES];
+static phy_status_t previous_phys_status[NUM_PHY_ADDRESSES];
+
+/** The statistics from the previous report, used by the statistics task to report changes */
+static cpsw_statistics_t previous_stats;
+static cpsw_cpdma_statistics_t previous_cpdma_stats;
+static packet_pool_statistics_t previous_pool_stats;
+static latency_histogram_t previous_latency;
+static uart_console_statistics_t previous_console_stats;
+static scheduler_statistics_t previous_scheduler_stats;
+#if CPDMA_BENCHMARK
+static uint32_t benchmark_index;
+static pmu_counters_t previous_pmu_counters;
+#endif
+#if CACHE_BENCHMARK
+/** True when the DDR is cached for the current interval of the cache benchmark */
+static bool cache_benchmark_cached;
+static dma_coherency_statistics_t previous_coherency_stats;
+#endif
+
+/** The task which processes the CPDMA queues, which is signalled by the CPDMA completion interrupts */
+static scheduler_task_id cpdma_poll_task_id;
+
+/** The task which reads the phy status after a link change, which is signalled by the MDIO interrupt */
+static scheduler_task_id phy_link_task_id;
+
+/** The state of the phy link task */
+static phy_reader_t phy_reader;
+
+#if PROFILER_ENABLED
+/** The task which dumps the profile, which is signalled by the statistics task */
+static scheduler_task_id profile_dump_task_id;
+
+/** Where to continue the profile dump, and true while the dump is in progress */
+static uint32_t profile_dump_next_bucket;
+static bool profile_dump_in_progress;
+#endif
+
 /**
  * @brief This function is used to initialize and configure UART Module.
  */
@@ -170,110 +355,13 @@ static void RTC_setup (void)
     RTCRun(SOC_RTC_0_REGS);
 }
 
-/*
-** This function converts a 8 bit number to its ASCII equivalent value.
-** The 8 bit number is passed as a parameter to this function.
-*/
-
-static unsigned int intToASCII(unsigned char byte)
-{
-    unsigned int retVal = 0;
-    unsigned char lsn = 0, msn = 0;
-    lsn = (byte & 0x0F);
-    msn = (byte & 0xF0) >> 0x04;
-
-    retVal = (lsn + 0x30);
-    retVal |= ((msn + 0x30) << 0x08);
-
-    return retVal;
-}
-
 /**
- * @brief Convert one BCD time field from the RTC to an integer
- * @param[in] rtc_bcd RTC BCD field to convert
- * @return Returns rtc_bcd converted to integer
+ * @brief Determine the link speed of an Ethernet phy from the status registers read from the phy
+ * @param[in,out] status The status read from the phy, for which link_speed is set
+ * @param[in] status_available True if the phy registers were read successfully
  */
-static unsigned int bcd_to_int (unsigned int rtc_bcd)
-{
-    const unsigned int lsn =  rtc_bcd & 0x0f;
-    const unsigned int msn = (rtc_bcd & 0xf0) >> 4;
-
-    return (msn * 10) + lsn;
-}
-
-/**
- * @brief Get the integer seconds field from a RTC time value
- * @param[in] rtc_time The time read from the RTC
- * @return Returns the seconds from rtc_time as an integer
- */
-static unsigned int get_rtc_seconds (unsigned int rtc_time)
-{
-    return bcd_to_int ((rtc_time & MASK_SECOND) >> SECOND_SHIFT);
-}
-
-/*
-** This function prints the current time read from the RTC registers.
-*/
-
-static void time_resolve (unsigned int timeValue)
+static void derive_phy_link_speed (phy_status_t *const status, const bool status_available)
 {
-    unsigned char timeArray[3] = {0};
-    unsigned char bytePrint[2] = {0};
-    unsigned int count = 0, i = 0;
-    unsigned int asciiTime = 0;
-
-    timeArray[0] = (unsigned char)((timeValue & MASK_HOUR) >> HOUR_SHIFT);
-    timeArray[1] = (unsigned char)((timeValue & MASK_MINUTE) >> MINUTE_SHIFT);
-    timeArray[2] = (unsigned char)((timeValue & MASK_SECOND) >> SECOND_SHIFT);
-
-    while(count < 3)
-    {
-        i = 0;
-        asciiTime = intToASCII(timeArray[count]);
-        bytePrint[0] = (unsigned char)((asciiTime & 0x0000FF00) >> 0x08);
-        bytePrint[1] = (unsigned char)(asciiTime & 0x000000FF);
-        while(i < 2)
-        {
-            ConsoleUtilsPrintf("%c", (bytePrint[i]));
-            i++;
-        }
-        count++;
-        if(count != 3)
-        {
-            ConsoleUtilsPrintf("%c", ':');
-        }
-        else
-        {
-            ConsoleUtilsPrintf("%c", ' ');
-        }
-    }
-}
-
-/**
- * @brief Read the status an Ethernet phys
- * @todo Assumes that the Ethernet phy defaults to auto-negotiate at reset
- * @param[in] phy_address Address of the phy to read the status for
- * @param[out] status Where to store the status of the phy
- */
-static void read_phy_status (const unsigned int phy_address, phy_status_t *const status)
-{
-    const unsigned int phys_alive_status = MDIOPhyAliveStatusGet (SOC_CPSW_MDIO_REGS);
-    bool status_available;
-
-    status_available = (phys_alive_status & (1u << phy_address)) != 0u;
-    if (status_available)
-    {
-        status->link_status = PhyLinkStatusGet (SOC_CPSW_MDIO_REGS, phy_address, 0);
-        status_available = MDIOPhyRegRead (SOC_CPSW_MDIO_REGS, phy_address, PHY_BSR, &status->basic_status);
-        if (status_available)
-        {
-            /* Only attempt to read the gigabit parter ability if the phy supports Gigabit */
-            status->gpbs_partner_ability = (status->basic_status & BMSR_ESTATEN) != 0;
-            status_available = PhyPartnerAbilityGet (SOC_CPSW_MDIO_REGS, phy_address,
-                                                     &status->partner_ability, &status->gpbs_partner_ability);
-        }
-    }
-
     if (status_available)
     {
         /* Determine the link speed of the phy */
@@ -322,6 +410,36 @@ static void read_phy_status (const unsigned int phy_address, phy_status_t *const
     }
 }
 
+/**
+ * @brief Read the status an Ethernet phys
+ * @details Uses blocking MDIO transactions, so is only used during initialisation. Once the scheduler is running
+ *          the status is read by phy_link_task().
+ * @todo Assumes that the Ethernet phy defaults to auto-negotiate at reset
+ * @param[in] phy_address Address of the phy to read the status for
+ * @param[out] status Where to store the status of the phy
+ */
+static void read_phy_status (const unsigned int phy_address, phy_status_t *const status)
+{
+    const unsigned int phys_alive_status = MDIOPhyAliveStatusGet (SOC_CPSW_MDIO_REGS);
+    bool status_available;
+
+    status_available = (phys_alive_status & (1u << phy_address)) != 0u;
+    if (status_available)
+    {
+        status->link_status = PhyLinkStatusGet (SOC_CPSW_MDIO_REGS, phy_address, 0);
+        status_available = MDIOPhyRegRead (SOC_CPSW_MDIO_REGS, phy_address, PHY_BSR, &status->basic_status);
+        if (status_available)
+        {
+            /* Only attempt to read the gigabit partner ability if the phy supports Gigabit */
+            status->gpbs_partner_ability = (status->basic_status & BMSR_ESTATEN) != 0;
+            status_available = PhyPartnerAbilityGet (SOC_CPSW_MDIO_REGS, phy_address,
+                                                     &status->partner_ability, &status->gpbs_partner_ability);
+        }
+    }
+
+    derive_phy_link_speed (status, status_available);
+}
+
 /**
  * @brief Set the transfer mode of a CPSW port to match the link speed / duplex in the Ethernet phy
  * @details To be called upon detecting a change in the link speed / duplex.
@@ -431,23 +549,28 @@ static void get_cpsw_statistics (cpsw_statistics_t *const stats)
 /**
  * @brief Display one CPSW statistic
  * @details Only display the statistic if the current value is non-zero or has changed.
- *          This means the error statistics will only be displayed once an error has occurred
- * @param[in] stat_name The name of the statistic
+ *          This means the error statistics will only be displayed once an error has occurred.
+ *
+ *          This is a macro so that the statistic name forms part of the DLOG() format string.
+ * @param[in] stat_name The name of the statistic, which must be a string literal
  * @param[in] current_value The current value of the statistic
  * @param[in] previous_value The statistic value from the previous iteration, used to detect change
  */
-static void display_one_cpsw_statistic (const char *stat_name, const unsigned int current_value, const unsigned int previous_value)
-{
-    if ((current_value != 0) || (current_value != previous_value))
-    {
-        UARTprintf ("%s = %u", stat_name, current_value);
-        if (current_value != previous_value)
-        {
-            UARTprintf (" (+%u)", current_value - previous_value);
-        }
-        UARTprintf ("\n");
-    }
-}
+#define display_one_cpsw_statistic(stat_name, current_value, previous_value) \
+    do \
+    { \
+        const unsigned int current_value_ = (current_value); \
+        const unsigned int previous_value_ = (previous_value); \
+        \
+        if (current_value_ != previous_value_) \
+        { \
+            DLOG (stat_name " = %u (+%u)\n", current_value_, current_value_ - previous_value_); \
+        } \
+        else if (current_value_ != 0) \
+        { \
+            DLOG (stat_name " = %u\n", current_value_); \
+        } \
+    } while (0)
 
 /**
  * @brief Display the CPSW statistics
@@ -486,6 +609,252 @@ static void display_cpsw_statistics (const cpsw_statistics_t *const current_stat
 
 }
 
+/**
+ * @brief Display the statistics for the CPDMA engine which services the host port
+ * @param[in] current_stats The current statistics
+ * @param[in] previous_stats The statistics from the previous call to this function, used to report changes
+ */
+static void display_cpdma_statistics (const cpsw_cpdma_statistics_t *const current_stats,
+                                      const cpsw_cpdma_statistics_t *const previous_stats)
+{
+    display_one_cpsw_statistic ("Host RX frames              ", current_stats->rx_frames, previous_stats->rx_frames);
+    display_one_cpsw_statistic ("Host RX octets              ", current_stats->rx_octets, previous_stats->rx_octets);
+    display_one_cpsw_statistic ("Host RX interrupts          ", current_stats->rx_interrupts, previous_stats->rx_interrupts);
+    display_one_cpsw_statistic ("Host RX no buffer discards  ", current_stats->rx_no_buffer_discards, previous_stats->rx_no_buffer_discards);
+    display_one_cpsw_statistic ("Host RX descriptor errors   ", current_stats->rx_descriptor_errors, previous_stats->rx_descriptor_errors);
+    display_one_cpsw_statistic ("Host RX end of queue restart", current_stats->rx_end_of_queue_restarts, previous_stats->rx_end_of_queue_restarts);
+    display_one_cpsw_statistic ("Host TX frames              ", current_stats->tx_frames, previous_stats->tx_frames);
+    display_one_cpsw_statistic ("Host TX octets              ", current_stats->tx_octets, previous_stats->tx_octets);
+    display_one_cpsw_statistic ("Host TX interrupts          ", current_stats->tx_interrupts, previous_stats->tx_interrupts);
+    display_one_cpsw_statistic ("Host TX queue full discards ", current_stats->tx_queue_full_discards, previous_stats->tx_queue_full_discards);
+    display_one_cpsw_statistic ("Host TX end of queue restart", current_stats->tx_end_of_queue_restarts, previous_stats->tx_end_of_queue_restarts);
+    display_one_cpsw_statistic ("Host polls                  ", current_stats->polls, previous_stats->polls);
+}
+
+/**
+ * @brief Display the statistics for the packet buffer pool
+ * @details The low watermark is the minimum number of free buffers over the statistics interval
+ * @param[in] current_stats The current statistics
+ * @param[in] previous_stats The statistics from the previous call to this function, used to report changes
+ */
+static void display_packet_pool_statistics (const packet_pool_statistics_t *const current_stats,
+                                            const packet_pool_statistics_t *const previous_stats)
+{
+    DLOG ("Free packet buffers          = %u of %u (low watermark %u)\n",
+          current_stats->free_buffers, current_stats->num_buffers, current_stats->low_watermark);
+    display_one_cpsw_statistic ("Packet buffer alloc failures", current_stats->alloc_failures, previous_stats->alloc_failures);
+}
+
+/**
+ * @brief RX handler for the software bridge, which forwards each received frame to the other CPSW port
+ * @details Called from cpsw_cpdma_poll(), or from the FIQ handler when RX_FIQ is non-zero. The latency is recorded
+ *          for each frame which is queued for transmission.
+ * @param[in] buffer The buffer containing the received frame
+ * @param[in] length The length of the received frame in bytes
+ * @param[in] from_port The CPSW port (1 or 2) the frame was received on
+ * @return Returns true if the frame was queued for transmission, in which case the reference to the buffer has
+ *         passed to the TX queue.
+ */
+static bool software_bridge_rx_handler (uint8_t *const buffer, const uint32_t length, const uint32_t from_port)
+{
+    const uint32_t to_port = (from_port == 1) ? 2 : 1;
+    const bool forwarded = cpsw_cpdma_transmit_directed (buffer, length, to_port);
+
+    if (forwarded)
+    {
+        const uint32_t latency_cycles = pmu_get_cycle_count () - cpsw_cpdma_rx_interrupt_start_cycles ();
+        const uint32_t bucket = (latency_cycles == 0) ? 0 : (31 - __builtin_clz (latency_cycles));
+
+        bridge_latency.counts[bucket]++;
+        if (latency_cycles < bridge_latency.min_cycles)
+        {
+            bridge_latency.min_cycles = latency_cycles;
+        }
+        if (latency_cycles > bridge_latency.max_cycles)
+        {
+            bridge_latency.max_cycles = latency_cycles;
+        }
+    }
+
+    return forwarded;
+}
+
+/**
+ * @brief Display the software bridge latency histogram
+ * @details Only the non-empty buckets are displayed
+ * @param[in] current_latency The current latency histogram
+ * @param[in] previous_latency The latency histogram from the previous call to this function, used to report changes
+ */
+static void display_bridge_latency (const latency_histogram_t *const current_latency,
+                                    const latency_histogram_t *const previous_latency)
+{
+    uint32_t bucket;
+
+    if (current_latency->max_cycles > 0)
+    {
+#if RX_FIQ
+        DLOG ("Software bridge latency in CPU cycles from RX FIQ entry to TX queued: min=%u max=%u\n",
+                    current_latency->min_cycles, current_latency->max_cycles);
+#else
+        DLOG ("Software bridge latency in CPU cycles from RX interrupt to TX queued: min=%u max=%u\n",
+                    current_latency->min_cycles, current_latency->max_cycles);
+#endif
+        for (bucket = 0; bucket < LATENCY_HISTOGRAM_BUCKETS; bucket++)
+        {
+            if (current_latency->counts[bucket] != 0)
+            {
+                DLOG ("  %10u..%10u = %u (+%u)\n", (bucket == 0) ? 0 : (1u << bucket), (2u << bucket) - 1,
+                      current_latency->counts[bucket], current_latency->counts[bucket] - previous_latency->counts[bucket]);
+            }
+        }
+    }
+}
+
+#if CPDMA_BENCHMARK
+/**
+ * @brief Report the performance of the CPDMA engine over one statistics interval
+ * @param[in] setting The CPDMA setting used for the interval
+ * @param[in] current_stats The CPDMA statistics at the end of the interval
+ * @param[in] previous_stats The CPDMA statistics at the start of the interval
+ * @param[in] current_pmu_counters The PMU counters at the end of the interval
+ * @param[in] previous_pmu_counters The PMU counters at the start of the interval
+ */
+static void display_cpdma_benchmark (const cpdma_setting_t *const setting,
+                                     const cpsw_cpdma_statistics_t *const current_stats,
+                                     const cpsw_cpdma_statistics_t *const previous_stats,
+                                     const pmu_counters_t *const current_pmu_counters,
+                                     const pmu_counters_t *const previous_pmu_counters)
+{
+    const uint32_t rx_frames = current_stats->rx_frames - previous_stats->rx_frames;
+    const uint32_t interrupts = (current_stats->rx_interrupts - previous_stats->rx_interrupts) +
+            (current_stats->tx_interrupts - previous_stats->tx_interrupts);
+    const uint64_t poll_cycles = (current_stats->poll_cycles - previous_stats->poll_cycles) +
+            (current_stats->rx_fiq_cycles - previous_stats->rx_fiq_cycles);
+    pmu_counters_t pmu_counts;
+
+    DLOG ("Benchmark budget=%u pacing=%u/ms (0=off) : RX frames/s=%u interrupts/s=%u CPU cycles/frame=%u\n",
+          setting->budget, setting->max_interrupts_per_ms,
+                rx_frames / STATISTICS_INTERVAL_SECS, interrupts / STATISTICS_INTERVAL_SECS,
+                (rx_frames > 0) ? (uint32_t) (poll_cycles / rx_frames) : 0);
+
+    /* The PMU events are counted for the whole program, not just the CPDMA poll */
+    pmu_counters_difference (previous_pmu_counters, current_pmu_counters, &pmu_counts);
+    if (rx_frames > 0)
+    {
+        DLOG ("Benchmark per frame : L1D refills=%u L2 misses=%u DTLB refills=%u branch mispredicts=%u\n",
+              (uint32_t) (pmu_counts.events[0] / rx_frames), (uint32_t) (pmu_counts.events[1] / rx_frames),
+              (uint32_t) (pmu_counts.events[2] / rx_frames), (uint32_t) (pmu_counts.events[3] / rx_frames));
+    }
+}
+#endif
+
+#if CACHE_BENCHMARK
+/**
+ * @brief Change the cache policy of the DDR, which contains the program and the packet buffers
+ * @details The virtual to physical mapping is unchanged, only the memory attributes. The caches are disabled,
+ *          which cleans the data cache, while the page table is changed so no cache lines can be left allocated
+ *          with the previous attributes. The packet buffers queued to the CPDMA have no dirty cache lines, so the
+ *          clean can't overwrite frames being received.
+ *
+ *          The DMA cache maintenance is only performed while the DDR is cached, so that the non-cacheable
+ *          policy measures the CPU cost of processing frames without any cache maintenance.
+ * @param[in] policy The memory type and cache policy for the DDR
+ */
+static void set_ddr_cache_policy (const memory_map_policy_t policy)
+{
+#if RX_FIQ
+    /* Frames received while the policy is changed would be processed with the wrong cache maintenance */
+    IntMasterFIQDisable ();
+#endif
+    CacheDisable (CACHE_ALL);
+    mmu_page_table_set_policy (mmu_page_table, MEMORY_MAP_DDR, policy);
+    CP15TlbInvalidate ();
+    CacheEnable (CACHE_ALL);
+    dma_coherency_set_enabled (policy != MEMORY_POLICY_NORMAL_NC);
+#if RX_FIQ
+    IntMasterFIQEnable ();
+#endif
+}
+
+/**
+ * @brief Report the performance of the CPDMA engine with the DDR policy used for one statistics interval
+ * @param[in] cached True if the DDR was cached for the interval
+ * @param[in] current_stats The CPDMA statistics at the end of the interval
+ * @param[in] previous_stats The CPDMA statistics at the start of the interval
+ * @param[in] current_coherency_stats The cache maintenance statistics at the end of the interval
+ * @param[in] previous_coherency_stats The cache maintenance statistics at the start of the interval
+ */
+static void display_cache_benchmark (const bool cached,
+                                     const cpsw_cpdma_statistics_t *const current_stats,
+                                     const cpsw_cpdma_statistics_t *const previous_stats,
+                                     const dma_coherency_statistics_t *const current_coherency_stats,
+                                     const dma_coherency_statistics_t *const previous_coherency_stats)
+{
+    const uint32_t rx_frames = current_stats->rx_frames - previous_stats->rx_frames;
+    const uint64_t poll_cycles = (current_stats->poll_cycles - previous_stats->poll_cycles) +
+            (current_stats->rx_fiq_cycles - previous_stats->rx_fiq_cycles);
+    const uint32_t cycles_per_frame = (rx_frames > 0) ? (uint32_t) (poll_cycles / rx_frames) : 0;
+
+    if (cached)
+    {
+        const uint32_t lines_cleaned =
+                current_coherency_stats->lines_cleaned - previous_coherency_stats->lines_cleaned;
+        const uint32_t lines_invalidated =
+                current_coherency_stats->lines_invalidated - previous_coherency_stats->lines_invalidated;
+
+        DLOG ("Cache benchmark DDR cached   : RX frames/s=%u CPU cycles/frame=%u\n",
+              rx_frames / STATISTICS_INTERVAL_SECS, cycles_per_frame);
+        if (rx_frames > 0)
+        {
+            DLOG ("Cache benchmark per frame : lines cleaned=%u lines invalidated=%u\n",
+                  lines_cleaned / rx_frames, lines_invalidated / rx_frames);
+        }
+    }
+    else
+    {
+        DLOG ("Cache benchmark DDR uncached : RX frames/s=%u CPU cycles/frame=%u\n",
+              rx_frames / STATISTICS_INTERVAL_SECS, cycles_per_frame);
+    }
+}
+#endif
+
+/**
+ * @brief Display the CPU overhead of the console output over one statistics interval
+ * @details The number of CPU cycles per byte allows the console transmit methods to be compared
+ * @param[in] current_stats The console statistics at the end of the interval
+ * @param[in] previous_stats The console statistics at the start of the interval
+ */
+static void display_console_statistics (const uart_console_statistics_t *const current_stats,
+                                        const uart_console_statistics_t *const previous_stats)
+{
+    const uint32_t bytes_written = current_stats->bytes_written - previous_stats->bytes_written;
+    const uint64_t write_cycles = current_stats->write_cpu_cycles - previous_stats->write_cpu_cycles;
+    const uint64_t isr_cycles = current_stats->isr_cpu_cycles - previous_stats->isr_cpu_cycles;
+
+    if (bytes_written > 0)
+    {
+        UARTprintf ("Console %s transmit: bytes=%u discarded=%u CPU cycles/byte write=%u isr=%u\n",
+                    current_stats->tx_mode, bytes_written, current_stats->bytes_discarded - previous_stats->bytes_discarded,
+                    (uint32_t) (write_cycles / bytes_written), (uint32_t) (isr_cycles / bytes_written));
+    }
+}
+
+/**
+ * @brief Display how much of the statistics interval the scheduler spent idle in WFI
+ * @param[in] current_stats The scheduler statistics at the end of the interval
+ * @param[in] previous_stats The scheduler statistics at the start of the interval
+ */
+static void display_scheduler_statistics (const scheduler_statistics_t *const current_stats,
+                                          const scheduler_statistics_t *const previous_stats)
+{
+    const uint64_t idle_ns = current_stats->idle_ns - previous_stats->idle_ns;
+
+    DLOG ("Scheduler: idle=%u%% sleeps=%u deadline interrupts=%u\n",
+          (uint32_t) ((idle_ns * 100u) / ((uint64_t) STATISTICS_INTERVAL_SECS * TIMESTAMP_NS_PER_SEC)),
+          current_stats->sleeps - previous_stats->sleeps,
+          current_stats->deadline_interrupts - previous_stats->deadline_interrupts);
+}
+
 /**
  * @brief Dislay the status of one CPSW port.
  * @param[in] port_id Identifies the CPSW port
@@ -493,99 +862,314 @@ static void display_cpsw_statistics (const cpsw_statistics_t *const current_stat
  */
 static void display_cpsw_link_status (const uint32_t port_id, phy_derived_link_speed link_speed)
 {
-    const char *link_status;
-
     switch (link_speed)
     {
     case LINK_SPEED_1000M_FULL_DUPLEX:
-        link_status = "1000M Full";
+        DLOG (" (Port %u 1000M Full)", port_id);
         break;
     case LINK_SPEED_1000M_HALF_DUPLEX:
-        link_status = "1000M Half";
+        DLOG (" (Port %u 1000M Half)", port_id);
         break;
     case LINK_SPEED_100M_FULL_DUPLEX:
-        link_status = "100M Full";
+        DLOG (" (Port %u 100M Full)", port_id);
         break;
     case LINK_SPEED_100M_HALF_DUPLEX:
-        link_status = "100M Half";
+        DLOG (" (Port %u 100M Half)", port_id);
         break;
     case LINK_SPEED_10M_FULL_DUPLEX:
-        link_status = "10M Full";
+        DLOG (" (Port %u 10M Full)", port_id);
         break;
     case LINK_SPEED_10M_HALF_DUPLEX:
-        link_status = "10M Half";
+        DLOG (" (Port %u 10M Half)", port_id);
         break;
     default:
-        link_status = "Down";
+        DLOG (" (Port %u Down)", port_id);
         break;
     }
-
-    UARTprintf (" (Port %u %s)", port_id, link_status);
 }
 
 /**
- * @brief Poll for an Ethernet phy link status change by checking for a Link Change Interrupt
+ * @brief Act upon the status of an Ethernet phy which has been read following a Link Change Interrupt
  * @todo The Link Change Interrupt monitors changes in the Link Status bit. For this function to detect changes
  *       in link speed or duplex assumes that the Link Status will report the Link Status as Down then Up during
  *       a change of link speed or duplex.
  * @param[in] phy_address Identifies the Ethernet phy
- * @param[in,out] current_status The most current status, updated after a Link Change Interrupt
- * @param[in,out] current_status The previous status, updated after a Link Change Interrupt
+ * @param[in] current_status The status which has been read from the phy
+ * @param[in,out] previous_status The previous status, updated to the current status
  */
-static void poll_for_phy_link_status_change (const unsigned int phy_address,
-                                             phy_status_t *const current_status, phy_status_t *const previous_status)
+static void phy_link_status_changed (const unsigned int phy_address,
+                                     const phy_status_t *const current_status, phy_status_t *const previous_status)
 {
-    const uint32_t link_int_mask = (phy_address == 0) ? MDIO_LINKINTMASKED_USERPHY0 : MDIO_LINKINTMASKED_USERPHY1;
-
-    if ((HWREG (SOC_CPSW_MDIO_REGS + MDIO_LINKINTMASKED) & link_int_mask) != 0)
+    if (current_status->link_speed != previous_status->link_speed)
     {
-        /* Clear interrupt */
-        HWREG (SOC_CPSW_MDIO_REGS + MDIO_LINKINTMASKED) = link_int_mask;
+        set_cpsw_transfer_mode (phy_address, current_status);
+    }
 
-        /* Read current status */
-        read_phy_status (phy_address, current_status);
-        if (current_status->link_speed != previous_status->link_speed)
+    if (memcmp (current_status, previous_status, sizeof (phy_status_t)) != 0)
+    {
+        UARTprintf ("Phy %u link %s  link speed ", phy_address, current_status->link_status ? "Up  " : "Down");
+        switch (current_status->link_speed)
         {
-            set_cpsw_transfer_mode (phy_address, current_status);
+        case LINK_SPEED_AUTO_NEGOTIATION_NOT_COMPLETE:
+            UARTprintf ("Auto negotiation not complete");
+            break;
+        case LINK_SPEED_UNKNOWN:
+            UARTprintf ("Unknown");
+            break;
+        case LINK_SPEED_1000M_FULL_DUPLEX:
+            UARTprintf ("1000M Full");
+            break;
+        case LINK_SPEED_1000M_HALF_DUPLEX:
+            UARTprintf ("1000M Half");
+            break;
+        case LINK_SPEED_100M_FULL_DUPLEX:
+            UARTprintf ("100M Full");
+            break;
+        case LINK_SPEED_100M_HALF_DUPLEX:
+            UARTprintf ("100M Half");
+            break;
+        case LINK_SPEED_10M_FULL_DUPLEX:
+            UARTprintf ("10M Full");
+            break;
+        case LINK_SPEED_10M_HALF_DUPLEX:
+            UARTprintf ("10M Half");
+            break;
         }
+        UARTprintf ("\n");
+    }
+
+    *previous_status = *current_status;
+}
+
+/**
+ * @brief Called from the CPDMA completion interrupts to run the CPDMA poll task
+ */
+static void cpdma_poll_notify (void)
+{
+    scheduler_task_signal (cpdma_poll_task_id);
+}
+
+/**
+ * @brief Task which processes the CPDMA queues, re-running itself until there is no more work
+ */
+static void cpdma_poll_task (void)
+{
+    if (cpsw_cpdma_poll () > 0)
+    {
+        scheduler_task_signal (cpdma_poll_task_id);
+    }
+}
+
+/**
+ * @brief Called from the MDIO interrupt to run the phy link task
+ */
+static void phy_link_notify (void)
+{
+    scheduler_task_signal (phy_link_task_id);
+}
 
-        if (memcmp (current_status, previous_status, sizeof (phy_status_t)) != 0)
+/**
+ * @brief Start the next phy register read for the phy whose status is being read by the phy link task
+ * @param[in] next_state The state to advance to
+ * @param[in] reg_num The phy register to read
+ */
+static void phy_reader_start_read (const phy_read_state next_state, const uint32_t reg_num)
+{
+    /* The read can't fail to start, since the phy link task only has one read in progress at once */
+    (void) mdio_async_read_start (phy_reader.phy_address, reg_num);
+    phy_reader.state = next_state;
+}
+
+/**
+ * @brief Advance the phy link state machine following the completion of a phy register read
+ * @param[in] status_available True if the phy acknowledged the read
+ * @param[in] value The value read from the phy register
+ * @return Returns true if another phy register read has been started, or false if the status has been read
+ */
+static bool phy_reader_advance (bool status_available, const uint16_t value)
+{
+    phy_status_t *const status = &phy_reader.status;
+
+    if (status_available)
+    {
+        switch (phy_reader.state)
         {
-            UARTprintf ("Phy %u link %s  link speed ", phy_address, current_status->link_status ? "Up  " : "Down");
-            switch (current_status->link_speed)
+        case PHY_READ_LINK_STATUS:
+            /* The link status is latched low, so the first read only reports if the link has gone down since the
+             * previous read, and is discarded. The second read of the same register gives the current status. */
+            phy_reader_start_read (PHY_READ_BASIC_STATUS, PHY_BSR);
+            return true;
+
+        case PHY_READ_BASIC_STATUS:
+            status->link_status = (value & PHY_LINK_STATUS) != 0;
+            status->basic_status = value;
+            phy_reader_start_read (PHY_READ_PARTNER_ABILITY, PHY_LINK_PARTNER_ABLTY);
+            return true;
+
+        case PHY_READ_PARTNER_ABILITY:
+            status->partner_ability = value;
+            /* Only attempt to read the gigabit partner ability if the phy supports Gigabit */
+            if ((status->basic_status & BMSR_ESTATEN) != 0)
             {
-            case LINK_SPEED_AUTO_NEGOTIATION_NOT_COMPLETE:
-                UARTprintf ("Auto negotiation not complete");
-                break;
-            case LINK_SPEED_UNKNOWN:
-                UARTprintf ("Unknown");
-                break;
-            case LINK_SPEED_1000M_FULL_DUPLEX:
-                UARTprintf ("1000M Full");
-                break;
-            case LINK_SPEED_1000M_HALF_DUPLEX:
-                UARTprintf ("1000M Half");
-                break;
-            case LINK_SPEED_100M_FULL_DUPLEX:
-                UARTprintf ("100M Full");
-                break;
-            case LINK_SPEED_100M_HALF_DUPLEX:
-                UARTprintf ("100M Half");
-                break;
-            case LINK_SPEED_10M_FULL_DUPLEX:
-                UARTprintf ("10M Full");
-                break;
-            case LINK_SPEED_10M_HALF_DUPLEX:
-                UARTprintf ("10M Half");
-                break;
+                phy_reader_start_read (PHY_READ_1000BT_STATUS, PHY_1000BT_STATUS);
+                return true;
             }
-            UARTprintf ("\n");
+            status->gpbs_partner_ability = 0;
+            break;
+
+        case PHY_READ_1000BT_STATUS:
+            status->gpbs_partner_ability = value;
+            break;
+
+        case PHY_READ_IDLE:
+            break;
+        }
+    }
+
+    derive_phy_link_speed (status, status_available);
+    return false;
+}
+
+/**
+ * @brief Event driven task which reads the status of the Ethernet phys which have had a link change
+ * @details Run when the MDIO interrupt reports either a link change or the completion of a phy register read.
+ *          The phy registers are read one at a time, returning to the scheduler while each MDIO transaction is
+ *          in progress, so that packet processing isn't blocked by the MDIO transactions.
+ */
+static void phy_link_task (void)
+{
+    mdio_async_read_status read_status;
+    uint16_t value = 0;
+
+    phy_reader.pending_phys |= mdio_async_take_link_changes ();
+
+    if (phy_reader.state != PHY_READ_IDLE)
+    {
+        read_status = mdio_async_read_poll (&value);
+        if ((read_status == MDIO_ASYNC_READ_BUSY) ||
+            phy_reader_advance (read_status == MDIO_ASYNC_READ_ACK, value))
+        {
+            return;
         }
 
-        *previous_status = *current_status;
+        current_phys_status[phy_reader.phy_address] = phy_reader.status;
+        phy_link_status_changed (phy_reader.phy_address, &current_phys_status[phy_reader.phy_address],
+                                 &previous_phys_status[phy_reader.phy_address]);
+        phy_reader.state = PHY_READ_IDLE;
+    }
+
+    if (phy_reader.pending_phys != 0)
+    {
+        phy_reader.phy_address = (uint32_t) __builtin_ctz (phy_reader.pending_phys);
+        phy_reader.pending_phys &= ~(1u << phy_reader.phy_address);
+        memset (&phy_reader.status, 0, sizeof (phy_reader.status));
+        phy_reader_start_read (PHY_READ_LINK_STATUS, PHY_BSR);
+    }
+}
+
+/**
+ * @brief Periodic task which reports CPSW statistics every STATISTICS_INTERVAL_SECS
+ */
+static void statistics_task (void)
+{
+    const unsigned int current_rtc_time = RTCTimeGet (SOC_RTC_0_REGS);
+    cpsw_statistics_t current_stats;
+    cpsw_cpdma_statistics_t current_cpdma_stats;
+    packet_pool_statistics_t current_pool_stats;
+    latency_histogram_t current_latency;
+    uart_console_statistics_t current_console_stats;
+    scheduler_statistics_t current_scheduler_stats;
+#if CPDMA_BENCHMARK
+    pmu_counters_t current_pmu_counters;
+#endif
+#if CACHE_BENCHMARK
+    dma_coherency_statistics_t current_coherency_stats;
+#endif
+
+    get_cpsw_statistics (&current_stats);
+    cpsw_cpdma_get_statistics (&current_cpdma_stats);
+    packet_pool_get_statistics (&current_pool_stats);
+    packet_pool_reset_low_watermark ();
+#if RX_FIQ
+    /* The FIQ handler updates the histogram, so mask FIQ to take a consistent copy */
+    IntMasterFIQDisable ();
+#endif
+    current_latency = bridge_latency;
+#if RX_FIQ
+    IntMasterFIQEnable ();
+#endif
+    UARTConsoleGetStatistics (&current_console_stats);
+    scheduler_get_statistics (&current_scheduler_stats);
+    DLOG ("\n%02X:%02X:%02X  CPSW Statistics for all ports",
+          (current_rtc_time & MASK_HOUR) >> HOUR_SHIFT, (current_rtc_time & MASK_MINUTE) >> MINUTE_SHIFT,
+          (current_rtc_time & MASK_SECOND) >> SECOND_SHIFT);
+    display_cpsw_link_status (1, current_phys_status[0].link_speed);
+    display_cpsw_link_status (2, current_phys_status[1].link_speed);
+    DLOG ("\n");
+    display_cpsw_statistics (&current_stats, &previous_stats);
+    display_cpdma_statistics (&current_cpdma_stats, &previous_cpdma_stats);
+    display_packet_pool_statistics (&current_pool_stats, &previous_pool_stats);
+    display_bridge_latency (&current_latency, &previous_latency);
+    display_console_statistics (&current_console_stats, &previous_console_stats);
+    display_scheduler_statistics (&current_scheduler_stats, &previous_scheduler_stats);
+#if CPDMA_BENCHMARK
+    pmu_counters_read (&current_pmu_counters);
+    display_cpdma_benchmark (&cpdma_benchmark_settings[benchmark_index], &current_cpdma_stats, &previous_cpdma_stats,
+                             &current_pmu_counters, &previous_pmu_counters);
+    previous_pmu_counters = current_pmu_counters;
+    benchmark_index = (benchmark_index + 1) % NUM_CPDMA_BENCHMARK_SETTINGS;
+    cpsw_cpdma_configure (cpdma_benchmark_settings[benchmark_index].budget,
+                          cpdma_benchmark_settings[benchmark_index].max_interrupts_per_ms);
+#endif
+#if CACHE_BENCHMARK
+    dma_coherency_get_statistics (&current_coherency_stats);
+    display_cache_benchmark (cache_benchmark_cached, &current_cpdma_stats, &previous_cpdma_stats,
+                             &current_coherency_stats, &previous_coherency_stats);
+    previous_coherency_stats = current_coherency_stats;
+    cache_benchmark_cached = !cache_benchmark_cached;
+    set_ddr_cache_policy (cache_benchmark_cached ? CACHED_DDR_POLICY : MEMORY_POLICY_NORMAL_NC);
+#endif
+
+    previous_stats = current_stats;
+    previous_cpdma_stats = current_cpdma_stats;
+    previous_pool_stats = current_pool_stats;
+    previous_latency = current_latency;
+    previous_console_stats = current_console_stats;
+    previous_scheduler_stats = current_scheduler_stats;
+
+#if PROFILER_ENABLED
+    if (!profile_dump_in_progress)
+    {
+        profiler_stop ();
+        profile_dump_next_bucket = 0;
+        profile_dump_in_progress = true;
+        scheduler_task_signal (profile_dump_task_id);
     }
+#endif
 }
 
+#if PROFILER_ENABLED
+/**
+ * @brief Task which dumps the profile on the console, and then restarts the profiler with an empty histogram
+ * @details The dump is written as space becomes available in the console buffer, so packet processing continues
+ *          while the dump is output.
+ */
+static void profile_dump_task (void)
+{
+    if (profiler_dump (&profile_dump_next_bucket))
+    {
+        profiler_clear ();
+        profiler_start ();
+        profile_dump_in_progress = false;
+    }
+    else
+    {
+        scheduler_task_run_at (profile_dump_task_id,
+                               timestamp_get_ns () + ((uint64_t) PROFILE_DUMP_RETRY_MS * (TIMESTAMP_NS_PER_SEC / 1000u)));
+    }
+}
+#endif
+
 int main (void)
 {
     uint8_t port1_mac_addr[LEN_MAC_ADDRESS];
@@ -594,25 +1178,46 @@ int main (void)
     unsigned int phy_address;
     unsigned int phy_id;
     unsigned short phy_special_modes;
-    phy_status_t current_phys_status[NUM_PHY_ADDRESSES];
-    phy_status_t previous_phys_status[NUM_PHY_ADDRESSES];
-    cpsw_statistics_t current_stats;
-    cpsw_statistics_t previous_stats;
-    unsigned int current_rtc_time;
-    unsigned int current_rtc_seconds;
-    unsigned int seconds_of_last_statistics;
 
+    boot_timeline_mark (BOOT_PHASE_APP_ENTRY);
+#if CACHES_ENABLED
+    mmu_page_table_enable (mmu_page_table);
+    CacheEnable (CACHE_ALL);
+    boot_timeline_mark (BOOT_PHASE_APP_MMU_ENABLE);
+#else
+    /* Without the MMU enabled all memory accesses are uncached, so the DMA buffers don't need cache maintenance */
+    dma_coherency_set_enabled (false);
+#endif
     memset (current_phys_status, 0, sizeof (current_phys_status));
     memset (previous_phys_status, 0, sizeof (previous_phys_status));
-    memset (&current_stats, 0, sizeof (cpsw_statistics_t));
     memset (&previous_stats, 0, sizeof (cpsw_statistics_t));
+    memset (&previous_cpdma_stats, 0, sizeof (cpsw_cpdma_statistics_t));
+    memset (&previous_pool_stats, 0, sizeof (packet_pool_statistics_t));
+    memset (&previous_latency, 0, sizeof (latency_histogram_t));
+    memset (&previous_console_stats, 0, sizeof (uart_console_statistics_t));
+    memset (&previous_scheduler_stats, 0, sizeof (scheduler_statistics_t));
+    memset (&bridge_latency, 0, sizeof (latency_histogram_t));
+    bridge_latency.min_cycles = UINT32_MAX;
+#if CACHE_BENCHMARK
+    cache_benchmark_cached = true;
+    memset (&previous_coherency_stats, 0, sizeof (dma_coherency_statistics_t));
+#endif
 
     /* Enabling IRQ in CPSR of ARM processor. */
     IntMasterIRQEnable();
 
     IntAINTCInit ();
+    boot_timeline_mark (BOOT_PHASE_APP_INTC_INIT);
+    enable_cycle_count ();
+    boot_timeline_cycle_counter_reset ();
+    timestamp_init ();
+    boot_timeline_mark (BOOT_PHASE_APP_TIMESTAMP_INIT);
+    scheduler_init ();
+    boot_timeline_mark (BOOT_PHASE_APP_SCHEDULER_INIT);
     UART_setup ();
+    boot_timeline_mark (BOOT_PHASE_APP_UART_SETUP);
     RTC_setup ();
+    boot_timeline_mark (BOOT_PHASE_APP_RTC_SETUP);
     CPSWClkEnable ();
     CPSWPinMuxSetup ();
     EVMPortGMIIModeSelect ();
@@ -623,23 +1228,41 @@ int main (void)
     HWREG (SOC_CPSW_MDIO_REGS + MDIO_USERPHYSEL0) = MDIO_USERPHYSEL0_LINKINTENB | (0 << MDIO_USERPHYSEL0_PHYADRMON_SHIFT);
     HWREG (SOC_CPSW_MDIO_REGS + MDIO_USERPHYSEL1) = MDIO_USERPHYSEL1_LINKINTENB | (1 << MDIO_USERPHYSEL1_PHYADRMON_SHIFT);
 
+#if SOFTWARE_BRIDGE
+    /* Bypass the CPSW ALE, so that all packets received on external ports 1 and 2 are sent only to the host port 0.
+     * The software bridge then forwards each packet to the other external port. */
+    HWREG (SOC_CPSW_ALE_REGS + CPSW_ALE_CONTROL) = CPSW_ALE_CONTROL_CLEAR_TABLE | CPSW_ALE_CONTROL_ALE_BYPASS | CPSW_ALE_CONTROL_ENABLE_ALE;
+    HWREG (SOC_CPSW_ALE_REGS + CPSW_ALE_PORTCTL(0)) = CPSW_ALE_PORT_STATE_FWD | CPSW_ALE_PORTCTL0_NO_LEARN;
+    HWREG (SOC_CPSW_ALE_REGS + CPSW_ALE_PORTCTL(1)) = CPSW_ALE_PORT_STATE_FWD | CPSW_ALE_PORTCTL1_NO_LEARN;
+    HWREG (SOC_CPSW_ALE_REGS + CPSW_ALE_PORTCTL(2)) = CPSW_ALE_PORT_STATE_FWD | CPSW_ALE_PORTCTL2_NO_LEARN;
+#else
     /* Set the CPSW ALE to:
      * - Pass packets between external port 1 and 2
      * - Flood all packets to the host port 0. This is done by enabling the flooding of unknown unicast packets
      *   and by disabling of learning (so that all unicast packets remain unknown). broadcast and multicast
      *   packets will be flooded anyway.
      *
-     *   @todo As this program doesn't yet read packets from host port 0, the "RX start of frame overruns"
-     *         statistic will increment for every received frame.
+     *   The packets flooded to the host port 0 are received by the CPDMA engine.
      */
     HWREG (SOC_CPSW_ALE_REGS + CPSW_ALE_CONTROL) = CPSW_ALE_CONTROL_CLEAR_TABLE | CPSW_ALE_CONTROL_EN_P0_UNI_FLOOD | CPSW_ALE_CONTROL_ENABLE_ALE;
     HWREG (SOC_CPSW_ALE_REGS + CPSW_ALE_PORTCTL(0)) = CPSW_ALE_PORT_STATE_FWD | CPSW_ALE_PORTCTL0_NO_LEARN;
     HWREG (SOC_CPSW_ALE_REGS + CPSW_ALE_PORTCTL(1)) = CPSW_ALE_PORT_STATE_FWD | CPSW_ALE_PORTCTL1_NO_LEARN;
     HWREG (SOC_CPSW_ALE_REGS + CPSW_ALE_PORTCTL(2)) = CPSW_ALE_PORT_STATE_FWD | CPSW_ALE_PORTCTL2_NO_LEARN;
+#endif
 
     CPSWStatisticsEnable (SOC_CPSW_SS_REGS);
     CPSWSlReset (SOC_CPSW_SLIVER_1_REGS);
     CPSWSlReset (SOC_CPSW_SLIVER_2_REGS);
+    cpsw_cpdma_set_rx_fiq (RX_FIQ != 0);
+    cpsw_cpdma_init (SOFTWARE_BRIDGE ? software_bridge_rx_handler : NULL);
+#if CPDMA_BENCHMARK
+    cpsw_cpdma_configure (cpdma_benchmark_settings[benchmark_index].budget,
+                          cpdma_benchmark_settings[benchmark_index].max_interrupts_per_ms);
+    pmu_overflow_interrupt_enable ();
+    pmu_event_counters_configure (&cpdma_benchmark_pmu_events);
+    pmu_event_counters_start ();
+    pmu_counters_read (&previous_pmu_counters);
+#endif
     EVMMACAddrGet (0, port1_mac_addr);
     EVMMACAddrGet (1, port2_mac_addr);
     UARTprintf ("Port 1 MAC address = %02X:%02X:%02X:%02X:%02X:%02X\n",
@@ -658,34 +1281,25 @@ int main (void)
         }
     }
 
-    seconds_of_last_statistics = get_rtc_seconds (RTCTimeGet (SOC_RTC_0_REGS));
-
     read_phy_status (0, &current_phys_status[0]);
     read_phy_status (1, &current_phys_status[1]);
-    for (;;)
-    {
-        /* Poll for changes in the status of the Ethernet phys */
-        poll_for_phy_link_status_change (0, &current_phys_status[0], &previous_phys_status[0]);
-        poll_for_phy_link_status_change (1, &current_phys_status[1], &previous_phys_status[1]);
-
-        /* Report CPSW statistics every 10 seconds */
-        current_rtc_time = RTCTimeGet (SOC_RTC_0_REGS);
-        current_rtc_seconds = get_rtc_seconds (current_rtc_time);
-        if (current_rtc_seconds == ((seconds_of_last_statistics + 10) % 60))
-        {
-            get_cpsw_statistics (&current_stats);
-            UARTprintf ("\n");
-            time_resolve (current_rtc_time);
-            UARTprintf (" CPSW Statistics for all ports");
-            display_cpsw_link_status (1, current_phys_status[0].link_speed);
-            display_cpsw_link_status (2, current_phys_status[1].link_speed);
-            UARTprintf ("\n");
-            display_cpsw_statistics (&current_stats, &previous_stats);
-
-            previous_stats = current_stats;
-            seconds_of_last_statistics = current_rtc_seconds;
-        }
-    }
+
+    /* Tasks in priority order */
+    cpdma_poll_task_id = scheduler_task_create (cpdma_poll_task);
+    phy_link_task_id = scheduler_task_create (phy_link_task);
+    scheduler_task_run_periodic (scheduler_task_create (statistics_task),
+                                 (uint64_t) STATISTICS_INTERVAL_SECS * TIMESTAMP_NS_PER_SEC);
+#if PROFILER_ENABLED
+    profile_dump_task_id = scheduler_task_create (profile_dump_task);
+    profile_dump_in_progress = false;
+    profiler_init (PROFILER_SAMPLE_HZ);
+#endif
+    cpsw_cpdma_set_poll_notify (cpdma_poll_notify);
+    mdio_async_init (phy_link_notify);
+    boot_timeline_mark (BOOT_PHASE_APP_OTHER_INIT);
+    boot_timeline_print ();
+    scheduler_task_signal (cpdma_poll_task_id);
+    scheduler_run ();
 
     return 0;
 }
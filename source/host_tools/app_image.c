@@ -0,0 +1,460 @@
+/*
+ * @file app_image.c
+ * @date 16 Oct 2026
+ * @brief Host program which converts an application image into the format loaded by the bootloader
+ * @details Usage: app_image [-c] <input_app> <output_app>
+ *
+ *          The input_app is an uncompressed image generated by tiimage, i.e. the image size and load address followed
+ *          by the binary. The output_app is in the format defined by bootloader/app_image.h, which adds a CRC32 of the
+ *          image so the bootloader can verify the image before starting it. With the -c option the image is LZ4
+ *          compressed in the format defined by bootloader/lz4_image.h. The input and output may be the same file.
+ *
+ *          Since the image is only compressed once when built, but decompressed by the bootloader on every boot, the
+ *          compressor searches hash chains for the longest match rather than using the fast LZ4 match finder.
+ *          The compressed image is verified by decompressing it with the bootloader decoder before being written.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_image.h"
+#include "crc32.h"
+#include "lz4_image.h"
+
+/* LZ4 block format definitions */
+#define LZ4_MIN_MATCH 4u
+#define LZ4_MAX_OFFSET 65535u
+#define LZ4_TOKEN_LITERAL_SHIFT 4u
+#define LZ4_LENGTH_EXTENDED 15u
+#define LZ4_LENGTH_BYTE_CONTINUE 255u
+
+/* The LZ4 block format requires the last 5 bytes of a block to be literals, and the last match to start at least
+ * 12 bytes before the end of the block */
+#define LZ4_LAST_LITERALS 5u
+#define LZ4_MATCH_FIND_LIMIT 12u
+
+/* The size of the hash table of 4 byte sequences, as a shift */
+#define HASH_BITS 16u
+#define HASH_SIZE (1u << HASH_BITS)
+
+/* The maximum number of previous positions with the same hash which are compared when searching for a match */
+#define MAX_CHAIN_ATTEMPTS 1024u
+
+/* The size of the header generated by tiimage for a peripheral boot image */
+#define TIIMAGE_HEADER_SIZE 8u
+
+/* Indicates no position in the hash chains */
+#define NO_POSITION (-1)
+
+/** The state of the match finder, which spans the complete image since the blocks are linked */
+typedef struct
+{
+    /** The image being compressed */
+    const uint8_t *data;
+    uint32_t data_len;
+    /** For each hash value, the most recent position with that hash */
+    int32_t *head;
+    /** For each position, the previous position with the same hash */
+    int32_t *chain;
+    /** The next position to be inserted into the hash chains */
+    uint32_t next_insert;
+} match_finder_t;
+
+/**
+ * @brief Read a little endian 32-bit value
+ */
+static uint32_t get_le32 (const uint8_t *const bytes)
+{
+    return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8) | ((uint32_t) bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+/**
+ * @brief Write a little endian 32-bit value
+ */
+static void put_le32 (uint8_t *const bytes, const uint32_t value)
+{
+    bytes[0] = (uint8_t) value;
+    bytes[1] = (uint8_t) (value >> 8);
+    bytes[2] = (uint8_t) (value >> 16);
+    bytes[3] = (uint8_t) (value >> 24);
+}
+
+/**
+ * @brief Hash the 4 bytes at a position in the image
+ */
+static uint32_t hash_position (const match_finder_t *const finder, const uint32_t position)
+{
+    return (get_le32 (&finder->data[position]) * 2654435761u) >> (32u - HASH_BITS);
+}
+
+/**
+ * @brief Insert the positions up to, but not including, end_position into the hash chains
+ */
+static void insert_positions (match_finder_t *const finder, const uint32_t end_position)
+{
+    uint32_t hash;
+
+    while ((finder->next_insert < end_position) && ((finder->next_insert + LZ4_MIN_MATCH) <= finder->data_len))
+    {
+        hash = hash_position (finder, finder->next_insert);
+        finder->chain[finder->next_insert] = finder->head[hash];
+        finder->head[hash] = (int32_t) finder->next_insert;
+        finder->next_insert++;
+    }
+}
+
+/**
+ * @brief Find the longest match for a position, with any previous position in the image within the LZ4 offset range
+ * @param[in,out] finder The match finder, into which the positions before position are inserted
+ * @param[in] position The position to find a match for
+ * @param[in] max_length The maximum length of the match
+ * @param[out] match_offset The offset back from position of the longest match
+ * @return The length of the longest match, which is less than LZ4_MIN_MATCH if no match was found
+ */
+static uint32_t find_longest_match (match_finder_t *const finder, const uint32_t position, const uint32_t max_length,
+                                    uint32_t *const match_offset)
+{
+    const uint8_t *const current = &finder->data[position];
+    uint32_t best_length = 0;
+    uint32_t attempts = 0;
+    int32_t candidate;
+    uint32_t length;
+
+    insert_positions (finder, position);
+    candidate = finder->head[hash_position (finder, position)];
+    while ((candidate != NO_POSITION) && ((position - (uint32_t) candidate) <= LZ4_MAX_OFFSET) &&
+           (attempts < MAX_CHAIN_ATTEMPTS))
+    {
+        const uint8_t *const previous = &finder->data[candidate];
+
+        if (previous[best_length] == current[best_length])
+        {
+            length = 0;
+            while ((length < max_length) && (previous[length] == current[length]))
+            {
+                length++;
+            }
+            if (length > best_length)
+            {
+                best_length = length;
+                *match_offset = position - (uint32_t) candidate;
+                if (best_length == max_length)
+                {
+                    break;
+                }
+            }
+        }
+        candidate = finder->chain[candidate];
+        attempts++;
+    }
+
+    return best_length;
+}
+
+/**
+ * @brief Write a literal or match length which doesn't fit in the token
+ * @return The position in the output after the length
+ */
+static uint8_t *write_extended_length (uint8_t *op, uint32_t length)
+{
+    length -= LZ4_LENGTH_EXTENDED;
+    while (length >= LZ4_LENGTH_BYTE_CONTINUE)
+    {
+        *op++ = LZ4_LENGTH_BYTE_CONTINUE;
+        length -= LZ4_LENGTH_BYTE_CONTINUE;
+    }
+    *op++ = (uint8_t) length;
+
+    return op;
+}
+
+/**
+ * @brief Write one LZ4 sequence, of literals optionally followed by a match
+ * @param[in] op Where to write the sequence
+ * @param[in] literals The literals
+ * @param[in] num_literals The number of literals
+ * @param[in] match_length The length of the match, or zero for the final sequence of a block which has no match
+ * @param[in] match_offset The offset of the match
+ * @return The position in the output after the sequence
+ */
+static uint8_t *write_sequence (uint8_t *op, const uint8_t *const literals, const uint32_t num_literals,
+                                const uint32_t match_length, const uint32_t match_offset)
+{
+    uint8_t *const token = op++;
+    const uint32_t match_code = (match_length > 0) ? (match_length - LZ4_MIN_MATCH) : 0;
+
+    *token = (uint8_t) (((num_literals < LZ4_LENGTH_EXTENDED) ? num_literals : LZ4_LENGTH_EXTENDED) <<
+                        LZ4_TOKEN_LITERAL_SHIFT);
+    if (num_literals >= LZ4_LENGTH_EXTENDED)
+    {
+        op = write_extended_length (op, num_literals);
+    }
+    memcpy (op, literals, num_literals);
+    op += num_literals;
+
+    if (match_length > 0)
+    {
+        *op++ = (uint8_t) match_offset;
+        *op++ = (uint8_t) (match_offset >> 8);
+        *token |= (uint8_t) ((match_code < LZ4_LENGTH_EXTENDED) ? match_code : LZ4_LENGTH_EXTENDED);
+        if (match_code >= LZ4_LENGTH_EXTENDED)
+        {
+            op = write_extended_length (op, match_code);
+        }
+    }
+
+    return op;
+}
+
+/**
+ * @brief Compress one block of the image into the LZ4 block format
+ * @param[in,out] finder The match finder
+ * @param[in] block_start The position in the image of the start of the block
+ * @param[in] block_len The number of bytes in the block
+ * @param[out] compressed Where to write the compressed block, which must have space for the worst case expansion
+ * @return The number of bytes in the compressed block
+ */
+static uint32_t compress_block (match_finder_t *const finder, const uint32_t block_start, const uint32_t block_len,
+                                uint8_t *const compressed)
+{
+    const uint32_t block_end = block_start + block_len;
+    uint8_t *op = compressed;
+    uint32_t anchor = block_start;
+    uint32_t position = block_start;
+    uint32_t match_length;
+    uint32_t match_offset = 0;
+
+    if (block_len > LZ4_MATCH_FIND_LIMIT)
+    {
+        while (position <= (block_end - LZ4_MATCH_FIND_LIMIT))
+        {
+            match_length = find_longest_match (finder, position, block_end - LZ4_LAST_LITERALS - position,
+                                               &match_offset);
+            if (match_length >= LZ4_MIN_MATCH)
+            {
+                op = write_sequence (op, &finder->data[anchor], position - anchor, match_length, match_offset);
+                position += match_length;
+                anchor = position;
+            }
+            else
+            {
+                position++;
+            }
+        }
+    }
+
+    /* The remainder of the block is the final literals */
+    op = write_sequence (op, &finder->data[anchor], block_end - anchor, 0, 0);
+    insert_positions (finder, block_end);
+
+    return (uint32_t) (op - compressed);
+}
+
+/**
+ * @brief Read the complete contents of a file
+ * @param[in] filename The file to read
+ * @param[out] file_len The number of bytes read
+ * @return The allocated file contents
+ */
+static uint8_t *read_file (const char *const filename, uint32_t *const file_len)
+{
+    FILE *const file = fopen (filename, "rb");
+    uint8_t *contents;
+    long len;
+
+    if (file == NULL)
+    {
+        fprintf (stderr, "Failed to open %s\n", filename);
+        exit (EXIT_FAILURE);
+    }
+
+    fseek (file, 0, SEEK_END);
+    len = ftell (file);
+    fseek (file, 0, SEEK_SET);
+    contents = malloc ((len > 0) ? (size_t) len : 1);
+    if ((len < 0) || (contents == NULL) || (fread (contents, 1, (size_t) len, file) != (size_t) len))
+    {
+        fprintf (stderr, "Failed to read %s\n", filename);
+        exit (EXIT_FAILURE);
+    }
+    fclose (file);
+    *file_len = (uint32_t) len;
+
+    return contents;
+}
+
+/**
+ * @brief LZ4 compress the image, verifying the compressed blocks by decompressing them with the bootloader decoder
+ * @param[in] image The image to compress
+ * @param[in] image_size The number of bytes in the image
+ * @param[out] compressed Where to write the compressed blocks, which must have space for each block being stored
+ * @return The number of bytes of compressed blocks
+ */
+static uint32_t compress_image (const uint8_t *const image, const uint32_t image_size, uint8_t *const compressed)
+{
+    match_finder_t finder;
+    uint8_t *op;
+    uint8_t *verify;
+    uint8_t *block_header;
+    uint32_t block_start;
+    uint32_t block_len;
+    uint32_t compressed_len;
+    uint32_t hash;
+
+    finder.data = image;
+    finder.data_len = image_size;
+    finder.head = malloc (HASH_SIZE * sizeof (finder.head[0]));
+    finder.chain = malloc (((image_size > 0) ? image_size : 1) * sizeof (finder.chain[0]));
+    finder.next_insert = 0;
+    verify = malloc ((image_size > 0) ? image_size : 1);
+    if ((finder.head == NULL) || (finder.chain == NULL) || (verify == NULL))
+    {
+        fprintf (stderr, "Failed to allocate compression buffers\n");
+        exit (EXIT_FAILURE);
+    }
+    for (hash = 0; hash < HASH_SIZE; hash++)
+    {
+        finder.head[hash] = NO_POSITION;
+    }
+
+    /* Compress and verify each block in turn, storing blocks which don't compress */
+    op = compressed;
+    for (block_start = 0; block_start < image_size; block_start += block_len)
+    {
+        block_len = image_size - block_start;
+        if (block_len > LZ4_IMAGE_BLOCK_SIZE)
+        {
+            block_len = LZ4_IMAGE_BLOCK_SIZE;
+        }
+
+        block_header = op;
+        op += LZ4_IMAGE_BLOCK_HEADER_SIZE;
+        compressed_len = compress_block (&finder, block_start, block_len, op);
+        if (compressed_len >= block_len)
+        {
+            memcpy (op, &image[block_start], block_len);
+            memcpy (&verify[block_start], op, block_len);
+            put_le32 (block_header, block_len | LZ4_IMAGE_BLOCK_STORED);
+            op += block_len;
+        }
+        else
+        {
+            if (!lz4_image_decode_block (op, compressed_len, &verify[block_start], block_len, verify))
+            {
+                fprintf (stderr, "Failed to decode the compressed block at offset %u\n", block_start);
+                exit (EXIT_FAILURE);
+            }
+            put_le32 (block_header, compressed_len);
+            op += compressed_len;
+        }
+    }
+    if ((image_size > 0) && (memcmp (verify, image, image_size) != 0))
+    {
+        fprintf (stderr, "Decompressed image doesn't match the input\n");
+        exit (EXIT_FAILURE);
+    }
+
+    free (finder.head);
+    free (finder.chain);
+    free (verify);
+
+    return (uint32_t) (op - compressed);
+}
+
+int main (int argc, char *argv[])
+{
+    bool compress = false;
+    int arg_index = 1;
+    uint8_t *input;
+    uint32_t input_len;
+    uint32_t image_size;
+    uint32_t load_addr;
+    const uint8_t *image;
+    uint8_t *output;
+    uint32_t stored_size;
+    uint32_t output_len;
+    uint32_t image_crc;
+    FILE *output_file;
+
+    if ((argc > 1) && (strcmp (argv[1], "-c") == 0))
+    {
+        compress = true;
+        arg_index++;
+    }
+    if ((argc - arg_index) != 2)
+    {
+        fprintf (stderr, "Usage: %s [-c] <input_app> <output_app>\n", argv[0]);
+        exit (EXIT_FAILURE);
+    }
+
+    input = read_file (argv[arg_index], &input_len);
+    if (input_len < TIIMAGE_HEADER_SIZE)
+    {
+        fprintf (stderr, "%s is too short for a tiimage header\n", argv[arg_index]);
+        exit (EXIT_FAILURE);
+    }
+    image_size = get_le32 (&input[0]);
+    load_addr = get_le32 (&input[4]);
+    if (image_size == APP_IMAGE_MAGIC)
+    {
+        fprintf (stderr, "%s has already been converted\n", argv[arg_index]);
+        exit (EXIT_FAILURE);
+    }
+    if (image_size != (input_len - TIIMAGE_HEADER_SIZE))
+    {
+        fprintf (stderr, "%s header image size %u doesn't match the file size %u\n", argv[arg_index], image_size,
+                 input_len);
+        exit (EXIT_FAILURE);
+    }
+    image = &input[TIIMAGE_HEADER_SIZE];
+    image_crc = crc32_update (0, image, image_size);
+
+    /* The worst case compressed size is when each block is stored */
+    output = malloc (sizeof (app_image_header_t) +
+                     (((image_size / LZ4_IMAGE_BLOCK_SIZE) + 1) * LZ4_IMAGE_MAX_BLOCK_BYTES) + LZ4_IMAGE_BLOCK_SIZE);
+    if (output == NULL)
+    {
+        fprintf (stderr, "Failed to allocate output buffer\n");
+        exit (EXIT_FAILURE);
+    }
+    if (compress)
+    {
+        stored_size = compress_image (image, image_size, &output[sizeof (app_image_header_t)]);
+    }
+    else
+    {
+        memcpy (&output[sizeof (app_image_header_t)], image, image_size);
+        stored_size = image_size;
+    }
+
+    output_len = (uint32_t) sizeof (app_image_header_t) + stored_size;
+    put_le32 (&output[offsetof (app_image_header_t, magic)], APP_IMAGE_MAGIC);
+    put_le32 (&output[offsetof (app_image_header_t, load_addr)], load_addr);
+    put_le32 (&output[offsetof (app_image_header_t, image_size)], image_size);
+    put_le32 (&output[offsetof (app_image_header_t, stored_size)], stored_size);
+    put_le32 (&output[offsetof (app_image_header_t, flags)], compress ? APP_IMAGE_FLAG_LZ4 : 0);
+    put_le32 (&output[offsetof (app_image_header_t, image_crc)], image_crc);
+
+    output_file = fopen (argv[arg_index + 1], "wb");
+    if ((output_file == NULL) || (fwrite (output, 1, output_len, output_file) != output_len) ||
+        (fclose (output_file) != 0))
+    {
+        fprintf (stderr, "Failed to write %s\n", argv[arg_index + 1]);
+        exit (EXIT_FAILURE);
+    }
+    printf ("%u byte image for 0x%08x with CRC 0x%08x", image_size, load_addr, image_crc);
+    if (compress)
+    {
+        printf (", compressed to %u bytes (%.1f%%)", stored_size,
+                (image_size > 0) ? ((100.0 * stored_size) / image_size) : 0.0);
+    }
+    printf ("\n");
+
+    free (input);
+    free (output);
+
+    return EXIT_SUCCESS;
+}
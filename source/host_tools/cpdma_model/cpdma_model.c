@@ -0,0 +1,516 @@
+/*
+ * @file cpdma_model.c
+ * @date 16 Oct 2026
+ * @brief Simulated CPDMA registers and descriptor processing, to test the cpsw_cpdma.c ring logic on the host
+ * @details Implements the StarterWare CPSW and AINTC functions called by cpsw_cpdma.c, with the CPPI RAM as an array
+ *          in host memory. A test injects received frames with cpdma_model_receive_frame(), completes queued
+ *          transmissions with cpdma_model_transmit(), and delivers the resulting interrupts to the handlers installed
+ *          by cpsw_cpdma.c with cpdma_model_service_interrupts().
+ *
+ *          Each channel follows the CPPI 3.0 rules used by the real CPDMA:
+ *          - Writing the head descriptor pointer starts an idle channel. A write while the channel is active is an error.
+ *          - The next pointer of a descriptor is read when the CPDMA starts the descriptor. When that next pointer was
+ *            NULL the descriptor is completed with the EOQ flag set, and the channel becomes idle, even if software
+ *            has since linked another descriptor. This makes the race between software appending to the queue and
+ *            the CPDMA reaching the end of the queue deterministic, so a test can place the append in the window.
+ *          - Completing a descriptor clears the OWNER flag. An interrupt pulse is generated while completed
+ *            descriptors haven't been acknowledged by writing the completion pointer, with no further pulse until the
+ *            end of interrupt has been signalled.
+ *
+ *          The host has no cache between the CPU and the simulated CPDMA, so the dma_coherency functions are no-ops.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "soc_AM335x.h"
+#include "interrupt.h"
+#include "cpsw.h"
+#include "AM3352_SOM.h"
+#include "dma_coherency.h"
+#include "fiq.h"
+#include "cpdma_model.h"
+
+/* Copies of the buffer descriptor definitions from cpsw_cpdma.c */
+#define CPDMA_DESC_SOP           0x80000000u
+#define CPDMA_DESC_EOP           0x40000000u
+#define CPDMA_DESC_OWNER         0x20000000u
+#define CPDMA_DESC_EOQ           0x10000000u
+#define CPDMA_DESC_FROM_PORT_SHIFT 16
+#define CPDMA_DESC_TX_TO_PORT_EN   0x00100000u
+#define CPDMA_DESC_TX_TO_PORT_MASK 0x00030000u
+#define CPDMA_DESC_TX_TO_PORT_SHIFT 16
+#define CPDMA_DESC_PKT_LEN_MASK  0x000007FFu
+
+typedef struct model_desc
+{
+    struct model_desc *volatile next;
+    uint8_t *volatile buffer;
+    volatile uint32_t buffer_offset_length;
+    volatile uint32_t flags_packet_length;
+} model_desc_t;
+
+/* The size of the CPPI RAM, and of the CPSW wrapper register block */
+#define CPPI_RAM_SIZE 8192u
+#define WR_REGS_SIZE  0x100u
+
+/* The number of AINTC system interrupts */
+#define NUM_SYS_INTS 128u
+
+/** The simulated CPPI RAM and CPSW wrapper registers, at the addresses given by soc_AM335x.h */
+uint64_t cpdma_model_cppi_ram[CPPI_RAM_SIZE / sizeof (uint64_t)];
+uint32_t cpdma_model_wr_regs[WR_REGS_SIZE / sizeof (uint32_t)];
+
+/** The state of one CPDMA channel */
+typedef struct
+{
+    /** The AINTC system interrupt for the channel completion interrupt */
+    unsigned int int_num;
+    /** Set by the CPDMA channel interrupt enable, and the CPSW wrapper core interrupt enable */
+    bool cpdma_int_enabled;
+    bool core_int_enabled;
+    /** True when the channel is processing descriptors, and so current is valid */
+    bool active;
+    /** The descriptor being processed, and its next pointer as read when the descriptor was started */
+    model_desc_t *current;
+    model_desc_t *latched_next;
+    /** The most recently completed descriptor, and the value written to the completion pointer */
+    model_desc_t *last_completed;
+    model_desc_t *completion_pointer;
+    /** Cleared when an interrupt pulse is generated, and set by the end of interrupt */
+    bool pulse_allowed;
+} model_channel_t;
+
+static model_channel_t rx_channel;
+static model_channel_t tx_channel;
+
+/** The AINTC state for each system interrupt */
+static void (*int_handlers[NUM_SYS_INTS]) (void);
+static unsigned int int_routes[NUM_SYS_INTS];
+static bool int_enabled[NUM_SYS_INTS];
+static bool int_pending[NUM_SYS_INTS];
+
+/** The CPU FIQ mask, and the function installed by fiq_install() */
+static bool fiq_masked;
+static fiq_function installed_fiq_function;
+
+static uint32_t cycle_count;
+static bool coherency_enabled;
+
+static cpdma_model_tx_frame_t tx_frames[CPDMA_MODEL_MAX_TX_FRAMES];
+static uint32_t num_tx_frames;
+
+static cpdma_model_errors_t model_errors;
+
+/******************************************************************************
+**                      Simulated CPDMA channels
+*******************************************************************************/
+
+/**
+ * @brief Convert a 32-bit descriptor pointer register value to the descriptor in the simulated CPPI RAM
+ * @details The host may use 64-bit pointers, so the register value is the offset into the CPPI RAM in the lower
+ *          32 bits of the descriptor address.
+ * @param[in] value The value written to a head descriptor or completion pointer register
+ * @return The descriptor
+ */
+static model_desc_t *desc_from_register (const unsigned int value)
+{
+    const uint32_t offset = (uint32_t) value - (uint32_t) SOC_CPSW_CPPI_RAM_REGS;
+
+    return (model_desc_t *) ((uint8_t *) cpdma_model_cppi_ram + offset);
+}
+
+/**
+ * @brief Start a channel processing the descriptor in its current field, reading the next pointer
+ * @details A descriptor which isn't owned by the CPDMA is recorded as an error, and stops the channel.
+ * @param[in,out] channel The channel to start
+ */
+static void channel_start_current (model_channel_t *const channel)
+{
+    if ((channel->current->flags_packet_length & CPDMA_DESC_OWNER) == 0)
+    {
+        model_errors.descriptors_not_owned++;
+        channel->active = false;
+        channel->current = NULL;
+    }
+    else
+    {
+        channel->active = true;
+        channel->latched_next = channel->current->next;
+    }
+}
+
+/**
+ * @brief Handle a write to the head descriptor pointer of a channel
+ * @param[in,out] channel The channel written
+ * @param[in] value The value written
+ */
+static void channel_hdp_write (model_channel_t *const channel, const unsigned int value)
+{
+    if (channel->active)
+    {
+        model_errors.hdp_writes_while_active++;
+        return;
+    }
+
+    channel->current = desc_from_register (value);
+    channel_start_current (channel);
+}
+
+/**
+ * @brief Generate an interrupt pulse for a channel if it has unacknowledged completed descriptors
+ * @param[in,out] channel The channel to check
+ */
+static void channel_update_interrupt (model_channel_t *const channel)
+{
+    if (channel->cpdma_int_enabled && channel->core_int_enabled && channel->pulse_allowed &&
+        (channel->completion_pointer != channel->last_completed))
+    {
+        channel->pulse_allowed = false;
+        int_pending[channel->int_num] = true;
+    }
+}
+
+/**
+ * @brief Complete the current descriptor of an active channel, and move on to the next descriptor
+ * @param[in,out] channel The channel
+ * @param[in] flags_packet_length The completed flags and packet length, which don't include OWNER or EOQ
+ */
+static void channel_complete_current (model_channel_t *const channel, const uint32_t flags_packet_length)
+{
+    model_desc_t *const desc = channel->current;
+
+    desc->flags_packet_length = flags_packet_length | ((channel->latched_next == NULL) ? CPDMA_DESC_EOQ : 0);
+    channel->last_completed = desc;
+    if (channel->latched_next != NULL)
+    {
+        channel->current = channel->latched_next;
+        channel_start_current (channel);
+    }
+    else
+    {
+        channel->active = false;
+        channel->current = NULL;
+    }
+    channel_update_interrupt (channel);
+}
+
+/**
+ * @brief Initialise the model to the reset state, with both channels idle and all interrupts disabled
+ * @details Must be called before cpsw_cpdma_init() in each test
+ */
+void cpdma_model_reset (void)
+{
+    memset (cpdma_model_cppi_ram, 0, sizeof (cpdma_model_cppi_ram));
+    memset (cpdma_model_wr_regs, 0, sizeof (cpdma_model_wr_regs));
+    memset (&rx_channel, 0, sizeof (rx_channel));
+    memset (&tx_channel, 0, sizeof (tx_channel));
+    rx_channel.int_num = SYS_INT_3PGSWRXINT0;
+    rx_channel.pulse_allowed = true;
+    tx_channel.int_num = SYS_INT_3PGSWTXINT0;
+    tx_channel.pulse_allowed = true;
+
+    memset (int_handlers, 0, sizeof (int_handlers));
+    memset (int_routes, 0, sizeof (int_routes));
+    memset (int_enabled, 0, sizeof (int_enabled));
+    memset (int_pending, 0, sizeof (int_pending));
+    fiq_masked = true;
+    installed_fiq_function = NULL;
+
+    num_tx_frames = 0;
+    memset (&model_errors, 0, sizeof (model_errors));
+}
+
+/**
+ * @brief Receive one frame from a CPSW port into the next RX descriptor
+ * @param[in] from_port The CPSW port (1 or 2) the frame was received on
+ * @param[in] length The frame length in bytes, of at least 4 bytes
+ * @param[in] first_word Stored in the first 4 bytes of the frame, with the remainder of the frame zero
+ * @return Returns true if the frame was received, or false if it was dropped as the RX channel is idle
+ */
+bool cpdma_model_receive_frame (const uint32_t from_port, const uint32_t length, const uint32_t first_word)
+{
+    model_desc_t *desc;
+
+    if (!rx_channel.active)
+    {
+        return false;
+    }
+
+    desc = rx_channel.current;
+    if (length > (desc->buffer_offset_length & CPDMA_DESC_PKT_LEN_MASK))
+    {
+        model_errors.rx_buffer_overflows++;
+        return false;
+    }
+
+    memset (desc->buffer, 0, length);
+    memcpy (desc->buffer, &first_word, sizeof (first_word));
+    channel_complete_current (&rx_channel, CPDMA_DESC_SOP | CPDMA_DESC_EOP |
+            (from_port << CPDMA_DESC_FROM_PORT_SHIFT) | length);
+
+    return true;
+}
+
+/**
+ * @brief Transmit frames from the TX queue, recording each transmitted frame
+ * @param[in] max_frames The maximum number of frames to transmit
+ * @return The number of frames transmitted. Less than max_frames means the TX channel is idle.
+ */
+uint32_t cpdma_model_transmit (const uint32_t max_frames)
+{
+    uint32_t num_transmitted = 0;
+
+    while ((num_transmitted < max_frames) && tx_channel.active)
+    {
+        model_desc_t *const desc = tx_channel.current;
+        const uint32_t flags = desc->flags_packet_length;
+
+        if (num_tx_frames < CPDMA_MODEL_MAX_TX_FRAMES)
+        {
+            cpdma_model_tx_frame_t *const frame = &tx_frames[num_tx_frames];
+
+            frame->to_port = ((flags & CPDMA_DESC_TX_TO_PORT_EN) != 0) ?
+                    ((flags & CPDMA_DESC_TX_TO_PORT_MASK) >> CPDMA_DESC_TX_TO_PORT_SHIFT) : 0;
+            frame->length = flags & CPDMA_DESC_PKT_LEN_MASK;
+            memcpy (&frame->first_word, desc->buffer, sizeof (frame->first_word));
+            num_tx_frames++;
+        }
+        channel_complete_current (&tx_channel, flags & ~CPDMA_DESC_OWNER);
+        num_transmitted++;
+    }
+
+    return num_transmitted;
+}
+
+/**
+ * @return Returns true if the RX channel is active, and so able to receive frames
+ */
+bool cpdma_model_rx_active (void)
+{
+    return rx_channel.active;
+}
+
+/**
+ * @return Returns true if the TX channel is active, and so has frames queued for transmission
+ */
+bool cpdma_model_tx_active (void)
+{
+    return tx_channel.active;
+}
+
+/**
+ * @brief Deliver the pending AINTC interrupts which are enabled, calling the installed IRQ handlers or FIQ function
+ * @return The number of interrupts delivered
+ */
+uint32_t cpdma_model_service_interrupts (void)
+{
+    uint32_t num_delivered = 0;
+    unsigned int int_num;
+
+    for (int_num = 0; int_num < NUM_SYS_INTS; int_num++)
+    {
+        if (int_pending[int_num] && int_enabled[int_num])
+        {
+            if (int_routes[int_num] == AINTC_HOSTINT_ROUTE_FIQ)
+            {
+                if (!fiq_masked && (installed_fiq_function != NULL))
+                {
+                    int_pending[int_num] = false;
+                    fiq_masked = true;
+                    installed_fiq_function (pmu_get_cycle_count ());
+                    fiq_masked = false;
+                    num_delivered++;
+                }
+            }
+            else if (int_handlers[int_num] != NULL)
+            {
+                int_pending[int_num] = false;
+                int_handlers[int_num] ();
+                num_delivered++;
+            }
+        }
+    }
+
+    return num_delivered;
+}
+
+/**
+ * @return Returns the number of frames transmitted since the model was reset
+ */
+uint32_t cpdma_model_num_tx_frames (void)
+{
+    return num_tx_frames;
+}
+
+/**
+ * @param[in] index Which transmitted frame to get, in the order transmitted
+ * @return Returns the transmitted frame
+ */
+const cpdma_model_tx_frame_t *cpdma_model_get_tx_frame (const uint32_t index)
+{
+    return &tx_frames[index];
+}
+
+/**
+ * @param[out] errors Where to store the errors detected since the model was reset
+ */
+void cpdma_model_get_errors (cpdma_model_errors_t *const errors)
+{
+    *errors = model_errors;
+}
+
+/**
+ * @return Returns true if FIQs are masked in the simulated CPU
+ */
+bool cpdma_model_fiq_masked (void)
+{
+    return fiq_masked;
+}
+
+/******************************************************************************
+**                      StarterWare CPSW functions
+*******************************************************************************/
+
+void CPSWCPDMARxHdrDescPtrWrite (unsigned int baseAddr, unsigned int descHdr, unsigned int channel)
+{
+    channel_hdp_write (&rx_channel, descHdr);
+}
+
+void CPSWCPDMATxHdrDescPtrWrite (unsigned int baseAddr, unsigned int descHdr, unsigned int channel)
+{
+    channel_hdp_write (&tx_channel, descHdr);
+}
+
+void CPSWCPDMARxCPWrite (unsigned int baseAddr, unsigned int channel, unsigned int comPtr)
+{
+    rx_channel.completion_pointer = desc_from_register (comPtr);
+}
+
+void CPSWCPDMATxCPWrite (unsigned int baseAddr, unsigned int channel, unsigned int comPtr)
+{
+    tx_channel.completion_pointer = desc_from_register (comPtr);
+}
+
+void CPSWCPDMAEndOfIntVectorWrite (unsigned int baseAddr, unsigned int eoiFlag)
+{
+    model_channel_t *const channel = (eoiFlag == CPSW_EOI_RX_PULSE) ? &rx_channel : &tx_channel;
+
+    channel->pulse_allowed = true;
+    channel_update_interrupt (channel);
+}
+
+void CPSWCPDMARxIntEnable (unsigned int baseAddr, unsigned int channel)
+{
+    rx_channel.cpdma_int_enabled = true;
+}
+
+void CPSWCPDMATxIntEnable (unsigned int baseAddr, unsigned int channel)
+{
+    tx_channel.cpdma_int_enabled = true;
+}
+
+void CPSWWrCoreIntEnable (unsigned int baseAddr, unsigned int core, unsigned int channel, unsigned int intFlag)
+{
+    if (intFlag == CPSW_CORE_INT_RX_PULSE)
+    {
+        rx_channel.core_int_enabled = true;
+    }
+    else if (intFlag == CPSW_CORE_INT_TX_PULSE)
+    {
+        tx_channel.core_int_enabled = true;
+    }
+}
+
+void CPSWCPDMATxEnable (unsigned int baseAddr)
+{
+}
+
+void CPSWCPDMARxEnable (unsigned int baseAddr)
+{
+}
+
+/******************************************************************************
+**                      StarterWare AINTC functions
+*******************************************************************************/
+
+void IntRegister (unsigned int intrNum, void (*fnHandler) (void))
+{
+    int_handlers[intrNum] = fnHandler;
+}
+
+void IntPrioritySet (unsigned int intrNum, unsigned int priority, unsigned int hostIntRoute)
+{
+    int_routes[intrNum] = hostIntRoute;
+}
+
+void IntSystemEnable (unsigned int intrNum)
+{
+    int_enabled[intrNum] = true;
+}
+
+void IntSystemDisable (unsigned int intrNum)
+{
+    int_enabled[intrNum] = false;
+}
+
+void IntMasterFIQEnable (void)
+{
+    fiq_masked = false;
+}
+
+void IntMasterFIQDisable (void)
+{
+    fiq_masked = true;
+}
+
+/******************************************************************************
+**                      Platform functions
+*******************************************************************************/
+
+void fiq_install (const unsigned int int_num, fiq_function function)
+{
+    installed_fiq_function = function;
+    int_routes[int_num] = AINTC_HOSTINT_ROUTE_FIQ;
+    fiq_masked = false;
+}
+
+/**
+ * @brief Simulated cycle counter, which advances by a fixed amount on each read
+ */
+unsigned int pmu_get_cycle_count (void)
+{
+    cycle_count += 100u;
+    return cycle_count;
+}
+
+void enable_cycle_count (void)
+{
+}
+
+void dma_coherency_set_enabled (const bool enabled)
+{
+    coherency_enabled = enabled;
+}
+
+bool dma_coherency_is_enabled (void)
+{
+    return coherency_enabled;
+}
+
+void dma_coherency_before_device_read (const void *const buffer, const uint32_t num_bytes)
+{
+}
+
+void dma_coherency_before_device_write (void *const buffer, const uint32_t num_bytes)
+{
+}
+
+void dma_coherency_after_device_write (void *const buffer, const uint32_t num_bytes)
+{
+}
+
+void dma_coherency_get_statistics (dma_coherency_statistics_t *const stats)
+{
+    memset (stats, 0, sizeof (*stats));
+}
@@ -0,0 +1,57 @@
+/*
+ * @file cpdma_model.h
+ * @date 16 Oct 2026
+ * @brief Interface to the simulated CPDMA used to test the cpsw_cpdma.c ring logic on the host
+ */
+
+#ifndef CPDMA_MODEL_H_
+#define CPDMA_MODEL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The maximum number of transmitted frames recorded by the model */
+#define CPDMA_MODEL_MAX_TX_FRAMES 4096u
+
+/** A frame which the simulated CPDMA has transmitted */
+typedef struct
+{
+    /** The CPSW port the frame was directed to */
+    uint32_t to_port;
+    /** The length of the frame in bytes */
+    uint32_t length;
+    /** The first 32-bit word of the frame, used by the tests as a sequence number */
+    uint32_t first_word;
+} cpdma_model_tx_frame_t;
+
+/** Errors in the use of the CPDMA detected by the model, which are all zero for correct software */
+typedef struct
+{
+    /** The number of head descriptor pointer writes while the channel was already active */
+    uint32_t hdp_writes_while_active;
+    /** The number of descriptors reached by the CPDMA without the OWNER flag set */
+    uint32_t descriptors_not_owned;
+    /** The number of frames which were larger than the RX buffer */
+    uint32_t rx_buffer_overflows;
+} cpdma_model_errors_t;
+
+void cpdma_model_reset (void);
+bool cpdma_model_receive_frame (const uint32_t from_port, const uint32_t length, const uint32_t first_word);
+uint32_t cpdma_model_transmit (const uint32_t max_frames);
+bool cpdma_model_rx_active (void);
+bool cpdma_model_tx_active (void);
+uint32_t cpdma_model_service_interrupts (void);
+uint32_t cpdma_model_num_tx_frames (void);
+const cpdma_model_tx_frame_t *cpdma_model_get_tx_frame (const uint32_t index);
+void cpdma_model_get_errors (cpdma_model_errors_t *const errors);
+bool cpdma_model_fiq_masked (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPDMA_MODEL_H_ */
@@ -0,0 +1,35 @@
+/*
+ * @file cpsw.h
+ * @date 16 Oct 2026
+ * @brief Host replacement for the StarterWare CPSW driver interface, implemented by cpdma_model.c
+ */
+
+#ifndef CPSW_H_
+#define CPSW_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Copies of the StarterWare CPSW definitions used by cpsw_cpdma.c */
+#define CPSW_EOI_TX_PULSE 0x02u
+#define CPSW_EOI_RX_PULSE 0x01u
+#define CPSW_CORE_INT_RX_PULSE 0x04u
+#define CPSW_CORE_INT_TX_PULSE 0x08u
+
+void CPSWCPDMARxHdrDescPtrWrite (unsigned int baseAddr, unsigned int descHdr, unsigned int channel);
+void CPSWCPDMATxHdrDescPtrWrite (unsigned int baseAddr, unsigned int descHdr, unsigned int channel);
+void CPSWCPDMARxCPWrite (unsigned int baseAddr, unsigned int channel, unsigned int comPtr);
+void CPSWCPDMATxCPWrite (unsigned int baseAddr, unsigned int channel, unsigned int comPtr);
+void CPSWCPDMAEndOfIntVectorWrite (unsigned int baseAddr, unsigned int eoiFlag);
+void CPSWCPDMARxIntEnable (unsigned int baseAddr, unsigned int channel);
+void CPSWCPDMATxIntEnable (unsigned int baseAddr, unsigned int channel);
+void CPSWWrCoreIntEnable (unsigned int baseAddr, unsigned int core, unsigned int channel, unsigned int intFlag);
+void CPSWCPDMATxEnable (unsigned int baseAddr);
+void CPSWCPDMARxEnable (unsigned int baseAddr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPSW_H_ */
@@ -0,0 +1,14 @@
+/*
+ * @file hw_types.h
+ * @date 16 Oct 2026
+ * @brief Host replacement for the StarterWare register access macros, used when testing against cpdma_model.c
+ */
+
+#ifndef HW_TYPES_H_
+#define HW_TYPES_H_
+
+#include <stdint.h>
+
+#define HWREG(x) (*((volatile unsigned int *) (x)))
+
+#endif /* HW_TYPES_H_ */
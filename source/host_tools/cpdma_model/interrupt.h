@@ -0,0 +1,32 @@
+/*
+ * @file interrupt.h
+ * @date 16 Oct 2026
+ * @brief Host replacement for the StarterWare AINTC interface, implemented by cpdma_model.c
+ */
+
+#ifndef INTERRUPT_H_
+#define INTERRUPT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Copies of the AM335x system interrupt numbers and AINTC routes used by cpsw_cpdma.c */
+#define SYS_INT_3PGSWRXINT0 41
+#define SYS_INT_3PGSWTXINT0 42
+
+#define AINTC_HOSTINT_ROUTE_IRQ 0
+#define AINTC_HOSTINT_ROUTE_FIQ 1
+
+void IntRegister (unsigned int intrNum, void (*fnHandler) (void));
+void IntPrioritySet (unsigned int intrNum, unsigned int priority, unsigned int hostIntRoute);
+void IntSystemEnable (unsigned int intrNum);
+void IntSystemDisable (unsigned int intrNum);
+void IntMasterFIQEnable (void);
+void IntMasterFIQDisable (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INTERRUPT_H_ */
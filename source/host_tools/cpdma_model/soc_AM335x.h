@@ -0,0 +1,21 @@
+/*
+ * @file soc_AM335x.h
+ * @date 16 Oct 2026
+ * @brief Host replacement for the StarterWare SoC memory map, used when testing cpsw_cpdma.c against cpdma_model.c
+ * @details Only the CPSW definitions used by cpsw_cpdma.c are provided. The CPPI RAM and CPSW wrapper registers are
+ *          arrays in cpdma_model.c, and the CPDMA registers are only accessed through the functions in cpsw.h.
+ */
+
+#ifndef SOC_AM335X_H_
+#define SOC_AM335X_H_
+
+#include <stdint.h>
+
+extern uint64_t cpdma_model_cppi_ram[];
+extern uint32_t cpdma_model_wr_regs[];
+
+#define SOC_CPSW_CPDMA_REGS    0
+#define SOC_CPSW_CPPI_RAM_REGS ((uintptr_t) cpdma_model_cppi_ram)
+#define SOC_CPSW_WR_REGS       ((uintptr_t) cpdma_model_wr_regs)
+
+#endif /* SOC_AM335X_H_ */
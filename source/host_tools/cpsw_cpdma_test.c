@@ -0,0 +1,372 @@
+/*
+ * @file cpsw_cpdma_test.c
+ * @date 16 Oct 2026
+ * @brief Host unit tests for the CPDMA ring logic in AM3352_SOM_platform/cpsw_cpdma.c
+ * @details cpsw_cpdma.c and packet_pool.c are built unchanged for the host, with the StarterWare CPSW and AINTC
+ *          functions provided by the simulated CPDMA in cpdma_model/. The tests check that frames are received and
+ *          forwarded in order, and that the RX and TX queues keep running when the CPDMA reaches the end of a queue,
+ *          including when software appends a descriptor after the CPDMA has read the NULL next pointer.
+ *
+ *          Usage: cpsw_cpdma_test
+ *          The exit status is zero when all tests pass.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "cpsw_cpdma.h"
+#include "packet_pool.h"
+#include "cpdma_model.h"
+
+/* The length of the frames received by the tests which don't vary the length */
+#define TEST_FRAME_LENGTH 64u
+
+/* Limits the number of passes made by run_until_idle(), to detect software which never goes idle */
+#define MAX_IDLE_PASSES 10000u
+
+/* The maximum number of buffers which keep_rx_frame() can hold */
+#define MAX_KEPT_BUFFERS 1024u
+
+static uint32_t num_failures;
+
+/** The buffers taken by keep_rx_frame() */
+static uint8_t *kept_buffers[MAX_KEPT_BUFFERS];
+static uint32_t num_kept_buffers;
+static uint32_t max_kept_buffers;
+
+/**
+ * @brief Report a failed check, and count the failure
+ */
+static void check (const bool ok, const char *const text, const int line)
+{
+    if (!ok)
+    {
+        printf ("  line %d: check failed: %s\n", line, text);
+        num_failures++;
+    }
+}
+
+#define CHECK(condition) check ((condition), #condition, __LINE__)
+
+/**
+ * @brief RX handler which forwards each frame to the other CPSW port, as the software bridge does
+ */
+static bool forward_rx_frame (uint8_t *const buffer, const uint32_t length, const uint32_t from_port)
+{
+    return cpsw_cpdma_transmit_directed (buffer, length, (from_port == 1) ? 2 : 1);
+}
+
+/**
+ * @brief RX handler which keeps each frame up to max_kept_buffers, to drain the packet pool
+ */
+static bool keep_rx_frame (uint8_t *const buffer, const uint32_t length, const uint32_t from_port)
+{
+    if (num_kept_buffers < max_kept_buffers)
+    {
+        kept_buffers[num_kept_buffers] = buffer;
+        num_kept_buffers++;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Deliver interrupts and poll the CPDMA engine until there is no more work, as the main loop does
+ */
+static void run_until_idle (void)
+{
+    uint32_t num_passes = 0;
+    uint32_t activity;
+
+    do
+    {
+        activity = cpdma_model_service_interrupts ();
+        activity += cpsw_cpdma_poll ();
+        num_passes++;
+    } while ((activity > 0) && (num_passes < MAX_IDLE_PASSES));
+    CHECK (num_passes < MAX_IDLE_PASSES);
+}
+
+/**
+ * @brief Transmit all queued frames, and process the resulting TX completions
+ */
+static void transmit_all (void)
+{
+    do
+    {
+        (void) cpdma_model_transmit (CPDMA_NUM_TX_DESCRIPTORS);
+        run_until_idle ();
+    } while (cpdma_model_tx_active ());
+}
+
+/**
+ * @brief Reset the simulated CPDMA and initialise the CPDMA engine for a test
+ * @param[in] name The test name to report
+ * @param[in] rx_fiq Selects processing the RX queue in the FIQ handler
+ * @param[in] rx_handler The RX handler to initialise the CPDMA engine with
+ */
+static void test_start (const char *const name, const bool rx_fiq, cpsw_cpdma_rx_handler rx_handler)
+{
+    printf ("%s\n", name);
+    cpdma_model_reset ();
+    cpsw_cpdma_set_rx_fiq (rx_fiq);
+    cpsw_cpdma_init (rx_handler);
+    num_kept_buffers = 0;
+    max_kept_buffers = 0;
+}
+
+/**
+ * @brief Check the state common to the end of all tests, once all frames have been transmitted
+ * @details The simulated CPDMA must not have detected any errors, the RX channel must still be able to receive, and
+ *          the only buffers allocated from the pool must be those queued for reception.
+ */
+static void test_end (void)
+{
+    cpdma_model_errors_t errors;
+    packet_pool_statistics_t pool_stats;
+
+    cpdma_model_get_errors (&errors);
+    packet_pool_get_statistics (&pool_stats);
+    CHECK (errors.hdp_writes_while_active == 0);
+    CHECK (errors.descriptors_not_owned == 0);
+    CHECK (errors.rx_buffer_overflows == 0);
+    CHECK (cpdma_model_rx_active ());
+    CHECK (!cpdma_model_tx_active ());
+    CHECK (pool_stats.free_buffers == (pool_stats.num_buffers - CPDMA_NUM_RX_DESCRIPTORS));
+}
+
+/**
+ * @brief Receive frames of varying lengths on both ports, with the main loop run every few frames
+ */
+static void test_forwarding (void)
+{
+    const uint32_t num_frames = 1000;
+    cpsw_cpdma_statistics_t stats;
+    uint32_t frame_index;
+
+    test_start ("test_forwarding", false, forward_rx_frame);
+    for (frame_index = 0; frame_index < num_frames; frame_index++)
+    {
+        CHECK (cpdma_model_receive_frame (1 + (frame_index % 2), 60 + (frame_index % 1400), frame_index));
+        if ((frame_index % 10) == 9)
+        {
+            run_until_idle ();
+            transmit_all ();
+        }
+    }
+    transmit_all ();
+
+    CHECK (cpdma_model_num_tx_frames () == num_frames);
+    for (frame_index = 0; frame_index < cpdma_model_num_tx_frames (); frame_index++)
+    {
+        const cpdma_model_tx_frame_t *const frame = cpdma_model_get_tx_frame (frame_index);
+
+        CHECK (frame->first_word == frame_index);
+        CHECK (frame->length == (60 + (frame_index % 1400)));
+        CHECK (frame->to_port == (2 - (frame_index % 2)));
+    }
+
+    cpsw_cpdma_get_statistics (&stats);
+    CHECK (stats.rx_frames == num_frames);
+    CHECK (stats.tx_frames == num_frames);
+    CHECK (stats.rx_no_buffer_discards == 0);
+    CHECK (stats.tx_queue_full_discards == 0);
+    test_end ();
+}
+
+/**
+ * @brief Fill the RX queue before the main loop runs, so the CPDMA stops at the end of the queue with EOQ set.
+ *        The first append must restart reception, after which no frames are lost.
+ */
+static void test_rx_end_of_queue (void)
+{
+    cpsw_cpdma_statistics_t stats;
+    uint32_t frame_index;
+
+    test_start ("test_rx_end_of_queue", false, forward_rx_frame);
+    for (frame_index = 0; frame_index < CPDMA_NUM_RX_DESCRIPTORS; frame_index++)
+    {
+        CHECK (cpdma_model_receive_frame (1, TEST_FRAME_LENGTH, frame_index));
+    }
+    CHECK (!cpdma_model_receive_frame (1, TEST_FRAME_LENGTH, frame_index));
+    CHECK (!cpdma_model_rx_active ());
+
+    run_until_idle ();
+    CHECK (cpdma_model_rx_active ());
+    transmit_all ();
+    for (frame_index = 0; frame_index < CPDMA_NUM_RX_DESCRIPTORS; frame_index++)
+    {
+        CHECK (cpdma_model_receive_frame (2, TEST_FRAME_LENGTH, frame_index));
+        run_until_idle ();
+    }
+    transmit_all ();
+
+    cpsw_cpdma_get_statistics (&stats);
+    CHECK (stats.rx_frames == (2 * CPDMA_NUM_RX_DESCRIPTORS));
+    CHECK (stats.rx_end_of_queue_restarts > 0);
+    CHECK (cpdma_model_num_tx_frames () == (2 * CPDMA_NUM_RX_DESCRIPTORS));
+    test_end ();
+}
+
+/**
+ * @brief The CPDMA starts the last RX descriptor while its next pointer is NULL, and software then appends to it
+ *        before the CPDMA completes it. The CPDMA stops with EOQ set in a descriptor whose next pointer isn't NULL,
+ *        which the append didn't see, so reception must be restarted when the completed descriptor is processed.
+ */
+static void test_rx_missed_end_of_queue (void)
+{
+    cpsw_cpdma_statistics_t stats;
+    uint32_t frame_index;
+
+    test_start ("test_rx_missed_end_of_queue", false, forward_rx_frame);
+    for (frame_index = 0; frame_index < (CPDMA_NUM_RX_DESCRIPTORS - 1); frame_index++)
+    {
+        CHECK (cpdma_model_receive_frame (1, TEST_FRAME_LENGTH, frame_index));
+    }
+    run_until_idle ();
+    transmit_all ();
+
+    CHECK (cpdma_model_receive_frame (1, TEST_FRAME_LENGTH, frame_index));
+    CHECK (!cpdma_model_rx_active ());
+    run_until_idle ();
+    CHECK (cpdma_model_rx_active ());
+
+    for (frame_index = 0; frame_index < (2 * CPDMA_NUM_RX_DESCRIPTORS); frame_index++)
+    {
+        CHECK (cpdma_model_receive_frame (2, TEST_FRAME_LENGTH, frame_index));
+        run_until_idle ();
+    }
+    transmit_all ();
+
+    cpsw_cpdma_get_statistics (&stats);
+    CHECK (stats.rx_frames == (3 * CPDMA_NUM_RX_DESCRIPTORS));
+    CHECK (stats.rx_end_of_queue_restarts > 0);
+    test_end ();
+}
+
+/**
+ * @brief A frame is queued for transmission while the previous frame is being transmitted, after the CPDMA has read
+ *        its NULL next pointer. The TX queue must be restarted when the previous frame is completed.
+ */
+static void test_tx_missed_end_of_queue (void)
+{
+    cpsw_cpdma_statistics_t stats;
+    uint32_t frame_index;
+
+    test_start ("test_tx_missed_end_of_queue", false, forward_rx_frame);
+    CHECK (cpdma_model_receive_frame (1, TEST_FRAME_LENGTH, 0));
+    run_until_idle ();
+    CHECK (cpdma_model_tx_active ());
+    CHECK (cpdma_model_receive_frame (1, TEST_FRAME_LENGTH, 1));
+    run_until_idle ();
+
+    CHECK (cpdma_model_transmit (CPDMA_NUM_TX_DESCRIPTORS) == 1);
+    CHECK (!cpdma_model_tx_active ());
+    run_until_idle ();
+    CHECK (cpdma_model_tx_active ());
+    transmit_all ();
+    CHECK (cpdma_model_num_tx_frames () == 2);
+
+    /* Enough frames to fill the TX queue, had it stopped */
+    for (frame_index = 2; frame_index < (2 * CPDMA_NUM_TX_DESCRIPTORS); frame_index++)
+    {
+        CHECK (cpdma_model_receive_frame (1, TEST_FRAME_LENGTH, frame_index));
+        run_until_idle ();
+        (void) cpdma_model_transmit (1);
+    }
+    transmit_all ();
+
+    cpsw_cpdma_get_statistics (&stats);
+    CHECK (cpdma_model_num_tx_frames () == (2 * CPDMA_NUM_TX_DESCRIPTORS));
+    CHECK (stats.tx_queue_full_discards == 0);
+    CHECK (stats.tx_end_of_queue_restarts > 0);
+    test_end ();
+}
+
+/**
+ * @brief The RX handler keeps every buffer until the pool is empty, after which received frames are discarded
+ *        with the RX queue still running
+ */
+static void test_rx_pool_exhausted (void)
+{
+    const uint32_t num_discards = 10;
+    packet_pool_statistics_t pool_stats;
+    cpsw_cpdma_statistics_t stats;
+    uint32_t frame_index;
+    uint32_t buffer_index;
+
+    test_start ("test_rx_pool_exhausted", false, keep_rx_frame);
+    packet_pool_get_statistics (&pool_stats);
+    max_kept_buffers = pool_stats.free_buffers;
+    CHECK (max_kept_buffers <= MAX_KEPT_BUFFERS);
+    for (frame_index = 0; frame_index < (max_kept_buffers + num_discards); frame_index++)
+    {
+        CHECK (cpdma_model_receive_frame (1, TEST_FRAME_LENGTH, frame_index));
+        run_until_idle ();
+    }
+
+    cpsw_cpdma_get_statistics (&stats);
+    packet_pool_get_statistics (&pool_stats);
+    CHECK (num_kept_buffers == max_kept_buffers);
+    CHECK (stats.rx_no_buffer_discards == num_discards);
+    CHECK (pool_stats.free_buffers == 0);
+
+    for (buffer_index = 0; buffer_index < num_kept_buffers; buffer_index++)
+    {
+        packet_pool_free (kept_buffers[buffer_index]);
+    }
+    num_kept_buffers = 0;
+    test_end ();
+}
+
+/**
+ * @brief Process the RX queue in the FIQ handler, where frames are forwarded without cpsw_cpdma_poll() being called.
+ *        More frames than the poll budget are received, so the FIQ has to be re-raised by the end of interrupt.
+ */
+static void test_rx_fiq (void)
+{
+    const uint32_t num_frames = 3 * CPDMA_DEFAULT_POLL_BUDGET;
+    cpsw_cpdma_statistics_t stats;
+    uint32_t frame_index;
+
+    test_start ("test_rx_fiq", true, forward_rx_frame);
+    for (frame_index = 0; frame_index < num_frames; frame_index++)
+    {
+        CHECK (cpdma_model_receive_frame (2, TEST_FRAME_LENGTH, frame_index));
+    }
+    while (cpdma_model_service_interrupts () > 0)
+    {
+    }
+
+    cpsw_cpdma_get_statistics (&stats);
+    CHECK (stats.rx_frames == num_frames);
+    CHECK (stats.polls == 0);
+    CHECK (stats.rx_fiq_cycles > 0);
+    CHECK (!cpdma_model_fiq_masked ());
+    CHECK (cpdma_model_tx_active ());
+
+    transmit_all ();
+    CHECK (!cpdma_model_fiq_masked ());
+    CHECK (cpdma_model_num_tx_frames () == num_frames);
+    for (frame_index = 0; frame_index < cpdma_model_num_tx_frames (); frame_index++)
+    {
+        CHECK (cpdma_model_get_tx_frame (frame_index)->first_word == frame_index);
+        CHECK (cpdma_model_get_tx_frame (frame_index)->to_port == 1);
+    }
+    test_end ();
+}
+
+int main (int argc, char *argv[])
+{
+    test_forwarding ();
+    test_rx_end_of_queue ();
+    test_rx_missed_end_of_queue ();
+    test_tx_missed_end_of_queue ();
+    test_rx_pool_exhausted ();
+    test_rx_fiq ();
+
+    printf ("%u check(s) failed\n", num_failures);
+    return (num_failures == 0) ? 0 : 1;
+}
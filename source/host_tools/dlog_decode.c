@@ -0,0 +1,234 @@
+/*
+ * @file dlog_decode.c
+ * @date 16 Oct 2026
+ * @brief Host program which decodes the console output from a target using deferred binary logging
+ * @details Usage: dlog_decode <elf_file> [<console_capture>]
+ *
+ *          The elf_file is the target program which generated the console output, which is used to look up the
+ *          format strings in the .dlog_formats section. The console output is read from console_capture if given,
+ *          otherwise from stdin so the decoder can be used on a live serial port, e.g.:
+ *            stty -F /dev/ttyUSB0 115200 raw && dlog_decode ethernet_passthrough.out < /dev/ttyUSB0
+ *
+ *          Text written by UARTprintf() is passed through unchanged, and each binary record is expanded by
+ *          applying the arguments to its format string. See dlog.h for the record layout.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "elf_file.h"
+
+/* Copies of the record layout definitions in AM3352_SOM_platform/dlog.h, which can't be included in a host
+ * program as it depends upon the target headers. */
+#define DLOG_RECORD_MARKER 0x1Eu
+#define DLOG_MAX_ARGS 8u
+#define DLOG_RECORD_HEADER_LEN 6u
+
+/** The maximum length of one conversion specification which is passed to snprintf() */
+#define MAX_CONVERSION_SPEC_LEN 32u
+
+/**
+ * @brief Output one record, by applying the record arguments to its format string
+ * @param[in] formats The contents of the .dlog_formats section
+ * @param[in] format_id The format string identity from the record, which is the offset in formats
+ * @param[in] num_args The number of arguments in the record
+ * @param[in] args The arguments from the record
+ */
+static void output_record (const elf_section_t *const formats, const uint32_t format_id,
+                           const uint32_t num_args, const uint32_t args[const DLOG_MAX_ARGS])
+{
+    const char *format;
+    const char *format_end;
+    uint32_t arg_index = 0;
+    char spec[MAX_CONVERSION_SPEC_LEN + 3];
+    char text[64];
+
+    if ((format_id >= formats->size) || (memchr (&formats->data[format_id], '\0', formats->size - format_id) == NULL))
+    {
+        printf ("<dlog: unknown format id 0x%x with %u args>\n", format_id, num_args);
+        return;
+    }
+
+    format = (const char *) &formats->data[format_id];
+    while (*format != '\0')
+    {
+        if (*format != '%')
+        {
+            putchar (*format);
+            format++;
+        }
+        else if (format[1] == '%')
+        {
+            putchar ('%');
+            format += 2;
+        }
+        else
+        {
+            /* Collect the flags, width and precision, dropping any length modifiers since all arguments
+             * are 32-bit integers */
+            size_t spec_len = 0;
+
+            spec[spec_len++] = '%';
+            format++;
+            while ((*format != '\0') && (strchr ("-+ #0123456789.", *format) != NULL) &&
+                   (spec_len < MAX_CONVERSION_SPEC_LEN))
+            {
+                spec[spec_len++] = *format++;
+            }
+            while ((*format != '\0') && (strchr ("hlLqjzt", *format) != NULL))
+            {
+                format++;
+            }
+            format_end = format;
+            if (*format_end == '\0')
+            {
+                break;
+            }
+            format++;
+
+            if (strchr ("diuxXocp", *format_end) == NULL)
+            {
+                printf ("<dlog: %%%c unsupported>", *format_end);
+            }
+            else if (arg_index >= num_args)
+            {
+                printf ("<dlog: missing arg>");
+            }
+            else
+            {
+                const uint32_t arg = args[arg_index++];
+
+                switch (*format_end)
+                {
+                case 'd':
+                case 'i':
+                    spec[spec_len++] = 'd';
+                    spec[spec_len] = '\0';
+                    snprintf (text, sizeof (text), spec, (int) (int32_t) arg);
+                    break;
+
+                case 'c':
+                    spec[spec_len++] = 'c';
+                    spec[spec_len] = '\0';
+                    snprintf (text, sizeof (text), spec, (int) (char) arg);
+                    break;
+
+                case 'p':
+                    snprintf (text, sizeof (text), "0x%08x", arg);
+                    break;
+
+                default:
+                    spec[spec_len++] = *format_end;
+                    spec[spec_len] = '\0';
+                    snprintf (text, sizeof (text), spec, (unsigned int) arg);
+                    break;
+                }
+                fputs (text, stdout);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Get a little-endian 32-bit value from a record
+ * @param[in] bytes The bytes of the value
+ * @return The 32-bit value
+ */
+static uint32_t get_le32 (const uint8_t *const bytes)
+{
+    return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8) | ((uint32_t) bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+int main (int argc, char *argv[])
+{
+    elf_file_t elf;
+    elf_section_t formats;
+    FILE *console;
+    int ch;
+
+    if ((argc != 2) && (argc != 3))
+    {
+        fprintf (stderr, "Usage: %s <elf_file> [<console_capture>]\n", argv[0]);
+        exit (EXIT_FAILURE);
+    }
+
+    if (!elf_file_open (argv[1], &elf))
+    {
+        exit (EXIT_FAILURE);
+    }
+    if (!elf_file_find_section (&elf, ".dlog_formats", &formats) || (formats.data == NULL))
+    {
+        fprintf (stderr, "%s doesn't contain a .dlog_formats section\n", argv[1]);
+        exit (EXIT_FAILURE);
+    }
+
+    if (argc == 3)
+    {
+        console = fopen (argv[2], "rb");
+        if (console == NULL)
+        {
+            fprintf (stderr, "Failed to open %s\n", argv[2]);
+            exit (EXIT_FAILURE);
+        }
+    }
+    else
+    {
+        console = stdin;
+    }
+
+    /* Line buffer the output so decoding of a live console is visible as it arrives */
+    setvbuf (stdout, NULL, _IOLBF, 0);
+
+    while ((ch = fgetc (console)) != EOF)
+    {
+        if (ch != DLOG_RECORD_MARKER)
+        {
+            putchar (ch);
+        }
+        else
+        {
+            uint8_t record[DLOG_RECORD_HEADER_LEN + (DLOG_MAX_ARGS * sizeof (uint32_t))];
+            uint32_t args[DLOG_MAX_ARGS];
+            uint32_t num_args;
+            uint32_t arg_index;
+            size_t record_len;
+
+            /* Read the number of arguments. If not valid treat the marker as text, to resynchronise on
+             * the next marker after corruption or starting to decode part way through a record. */
+            record[0] = (uint8_t) ch;
+            ch = fgetc (console);
+            if (ch == EOF)
+            {
+                break;
+            }
+            if ((uint32_t) ch > DLOG_MAX_ARGS)
+            {
+                ungetc (ch, console);
+                continue;
+            }
+            record[1] = (uint8_t) ch;
+            num_args = record[1];
+            record_len = DLOG_RECORD_HEADER_LEN + (num_args * sizeof (uint32_t));
+            if (fread (&record[2], 1, record_len - 2, console) != (record_len - 2))
+            {
+                fprintf (stderr, "Console output ended part way through a record\n");
+                break;
+            }
+
+            for (arg_index = 0; arg_index < num_args; arg_index++)
+            {
+                args[arg_index] = get_le32 (&record[DLOG_RECORD_HEADER_LEN + (arg_index * sizeof (uint32_t))]);
+            }
+            output_record (&formats, get_le32 (&record[2]), num_args, args);
+        }
+    }
+
+    if (console != stdin)
+    {
+        fclose (console);
+    }
+    elf_file_close (&elf);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,346 @@
+/*
+ * @file elf_file.c
+ * @date 16 Oct 2026
+ * @brief Minimal reading of the ELF files produced by the GCC ARM compiler, for use by the host tools
+ * @details Only little-endian ELF files are supported, which matches both the AM335x target and the x86 host.
+ *          Both 32-bit and 64-bit ELF files are supported, so the tools can be checked against host object files.
+ */
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "elf_file.h"
+
+/**
+ * @brief Read an ELF file into memory, checking the identification
+ * @param[in] pathname The ELF file to read
+ * @param[out] elf The ELF file which has been read
+ * @return Returns true if the ELF file has been read, or false if an error has been reported
+ */
+bool elf_file_open (const char *const pathname, elf_file_t *const elf)
+{
+    FILE *file;
+    long file_size;
+
+    memset (elf, 0, sizeof (*elf));
+    elf->pathname = pathname;
+    file = fopen (pathname, "rb");
+    if (file == NULL)
+    {
+        fprintf (stderr, "Failed to open %s\n", pathname);
+        return false;
+    }
+
+    if ((fseek (file, 0, SEEK_END) != 0) || ((file_size = ftell (file)) < 0) || (fseek (file, 0, SEEK_SET) != 0))
+    {
+        fprintf (stderr, "Failed to get size of %s\n", pathname);
+        fclose (file);
+        return false;
+    }
+
+    elf->contents_size = (size_t) file_size;
+    elf->contents = malloc (elf->contents_size);
+    if ((elf->contents == NULL) || (fread (elf->contents, 1, elf->contents_size, file) != elf->contents_size))
+    {
+        fprintf (stderr, "Failed to read %s\n", pathname);
+        fclose (file);
+        elf_file_close (elf);
+        return false;
+    }
+    fclose (file);
+
+    if ((elf->contents_size < EI_NIDENT) || (memcmp (elf->contents, ELFMAG, SELFMAG) != 0) ||
+        (elf->contents[EI_DATA] != ELFDATA2LSB) ||
+        ((elf->contents[EI_CLASS] != ELFCLASS32) && (elf->contents[EI_CLASS] != ELFCLASS64)))
+    {
+        fprintf (stderr, "%s is not a little-endian ELF file\n", pathname);
+        elf_file_close (elf);
+        return false;
+    }
+    elf->is_64bit = elf->contents[EI_CLASS] == ELFCLASS64;
+
+    if (elf->contents_size < (elf->is_64bit ? sizeof (Elf64_Ehdr) : sizeof (Elf32_Ehdr)))
+    {
+        fprintf (stderr, "%s is truncated\n", pathname);
+        elf_file_close (elf);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Release the memory used by an ELF file read by elf_file_open()
+ * @param[in,out] elf The ELF file to release
+ */
+void elf_file_close (elf_file_t *const elf)
+{
+    free (elf->contents);
+    elf->contents = NULL;
+    elf->contents_size = 0;
+}
+
+/**
+ * @brief Get the header of one section in an ELF file, converted to the 64-bit format
+ * @param[in] elf The ELF file to get the section header from
+ * @param[in] section_index Which section header to get
+ * @param[out] header The section header
+ * @return Returns true if the section header is within the file
+ */
+static bool elf_file_get_section_header (const elf_file_t *const elf, const uint32_t section_index,
+                                         Elf64_Shdr *const header)
+{
+    if (elf->is_64bit)
+    {
+        const Elf64_Ehdr *const ehdr = (const Elf64_Ehdr *) elf->contents;
+        const uint64_t offset = ehdr->e_shoff + ((uint64_t) section_index * ehdr->e_shentsize);
+
+        if ((section_index >= ehdr->e_shnum) || ((offset + sizeof (Elf64_Shdr)) > elf->contents_size))
+        {
+            return false;
+        }
+        memcpy (header, &elf->contents[offset], sizeof (Elf64_Shdr));
+    }
+    else
+    {
+        const Elf32_Ehdr *const ehdr = (const Elf32_Ehdr *) elf->contents;
+        const uint64_t offset = ehdr->e_shoff + ((uint64_t) section_index * ehdr->e_shentsize);
+        Elf32_Shdr header32;
+
+        if ((section_index >= ehdr->e_shnum) || ((offset + sizeof (Elf32_Shdr)) > elf->contents_size))
+        {
+            return false;
+        }
+        memcpy (&header32, &elf->contents[offset], sizeof (Elf32_Shdr));
+        header->sh_name = header32.sh_name;
+        header->sh_type = header32.sh_type;
+        header->sh_flags = header32.sh_flags;
+        header->sh_addr = header32.sh_addr;
+        header->sh_offset = header32.sh_offset;
+        header->sh_size = header32.sh_size;
+        header->sh_link = header32.sh_link;
+        header->sh_info = header32.sh_info;
+        header->sh_addralign = header32.sh_addralign;
+        header->sh_entsize = header32.sh_entsize;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Find a section in an ELF file by name
+ * @param[in] elf The ELF file to search
+ * @param[in] section_name The name of the section to find
+ * @param[out] section The section which was found
+ * @return Returns true if the section was found
+ */
+bool elf_file_find_section (const elf_file_t *const elf, const char *const section_name, elf_section_t *const section)
+{
+    const uint32_t num_sections = elf->is_64bit ? ((const Elf64_Ehdr *) elf->contents)->e_shnum :
+                                                  ((const Elf32_Ehdr *) elf->contents)->e_shnum;
+    const uint32_t string_section_index = elf->is_64bit ? ((const Elf64_Ehdr *) elf->contents)->e_shstrndx :
+                                                          ((const Elf32_Ehdr *) elf->contents)->e_shstrndx;
+    Elf64_Shdr string_header;
+    Elf64_Shdr header;
+    uint32_t section_index;
+
+    if (!elf_file_get_section_header (elf, string_section_index, &string_header) ||
+        ((string_header.sh_offset + string_header.sh_size) > elf->contents_size))
+    {
+        return false;
+    }
+
+    for (section_index = 0; section_index < num_sections; section_index++)
+    {
+        if (elf_file_get_section_header (elf, section_index, &header) && (header.sh_name < string_header.sh_size))
+        {
+            const char *const name = (const char *) &elf->contents[string_header.sh_offset + header.sh_name];
+            const size_t max_name_len = string_header.sh_size - header.sh_name;
+
+            if ((strnlen (name, max_name_len) < max_name_len) && (strcmp (name, section_name) == 0))
+            {
+                section->size = header.sh_size;
+                section->address = header.sh_addr;
+                if ((header.sh_type == SHT_NOBITS) || ((header.sh_offset + header.sh_size) > elf->contents_size))
+                {
+                    section->data = NULL;
+                }
+                else
+                {
+                    section->data = &elf->contents[header.sh_offset];
+                }
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Get one entry from the symbol table of an ELF file, converted to the 64-bit format
+ * @param[in] elf The ELF file containing the symbol table
+ * @param[in] symtab The symbol table section
+ * @param[in] symbol_index Which symbol to get
+ * @param[out] symbol The symbol
+ */
+static void elf_file_get_symbol (const elf_file_t *const elf, const elf_section_t *const symtab,
+                                 const size_t symbol_index, Elf64_Sym *const symbol)
+{
+    if (elf->is_64bit)
+    {
+        memcpy (symbol, &symtab->data[symbol_index * sizeof (Elf64_Sym)], sizeof (Elf64_Sym));
+    }
+    else
+    {
+        Elf32_Sym symbol32;
+
+        memcpy (&symbol32, &symtab->data[symbol_index * sizeof (Elf32_Sym)], sizeof (Elf32_Sym));
+        symbol->st_name = symbol32.st_name;
+        symbol->st_info = symbol32.st_info;
+        symbol->st_other = symbol32.st_other;
+        symbol->st_shndx = symbol32.st_shndx;
+        symbol->st_value = symbol32.st_value;
+        symbol->st_size = symbol32.st_size;
+    }
+}
+
+/**
+ * @brief Compare two symbols for sorting by increasing address
+ * @details Symbols at the same address are sorted by increasing size, so that elf_file_lookup_symbol() prefers a
+ *          function with a known size over an assembler label at the same address.
+ */
+static int elf_symbol_compare (const void *const compare_a, const void *const compare_b)
+{
+    const elf_symbol_t *const a = compare_a;
+    const elf_symbol_t *const b = compare_b;
+
+    if (a->address != b->address)
+    {
+        return (a->address < b->address) ? -1 : 1;
+    }
+    if (a->size != b->size)
+    {
+        return (a->size < b->size) ? -1 : 1;
+    }
+    return strcmp (a->name, b->name);
+}
+
+/**
+ * @brief Read the symbols for the code in an ELF file, for looking up the function containing an address
+ * @details Reads function symbols, plus named labels in executable sections to cover assembler code which doesn't
+ *          mark its functions. The ARM mapping symbols ($a, $t and $d) are ignored.
+ * @param[in] elf The ELF file to read the symbols from, which must remain open while the symbols are used
+ * @param[out] table The symbols read, which must be released by elf_file_free_symbols()
+ * @return Returns true if the symbols were read, or false if an error has been reported
+ */
+bool elf_file_read_code_symbols (const elf_file_t *const elf, elf_symbol_table_t *const table)
+{
+    const size_t symbol_size = elf->is_64bit ? sizeof (Elf64_Sym) : sizeof (Elf32_Sym);
+    const bool is_arm = ((const Elf32_Ehdr *) elf->contents)->e_machine == EM_ARM;
+    elf_section_t symtab;
+    elf_section_t strtab;
+    Elf64_Shdr section_header;
+    Elf64_Sym symbol;
+    size_t num_symbols;
+    size_t symbol_index;
+
+    memset (table, 0, sizeof (*table));
+    if (!elf_file_find_section (elf, ".symtab", &symtab) || (symtab.data == NULL) ||
+        !elf_file_find_section (elf, ".strtab", &strtab) || (strtab.data == NULL))
+    {
+        fprintf (stderr, "%s doesn't contain a symbol table\n", elf->pathname);
+        return false;
+    }
+
+    num_symbols = symtab.size / symbol_size;
+    table->symbols = calloc (num_symbols, sizeof (table->symbols[0]));
+    if (table->symbols == NULL)
+    {
+        fprintf (stderr, "Failed to allocate symbols for %s\n", elf->pathname);
+        return false;
+    }
+
+    for (symbol_index = 0; symbol_index < num_symbols; symbol_index++)
+    {
+        elf_file_get_symbol (elf, &symtab, symbol_index, &symbol);
+        if ((symbol.st_name != 0) && (symbol.st_name < strtab.size) &&
+            elf_file_get_section_header (elf, symbol.st_shndx, &section_header) &&
+            ((section_header.sh_flags & SHF_EXECINSTR) != 0))
+        {
+            const char *const name = (const char *) &strtab.data[symbol.st_name];
+            const size_t max_name_len = strtab.size - symbol.st_name;
+            const unsigned char symbol_type = ELF64_ST_TYPE (symbol.st_info);
+
+            if ((strnlen (name, max_name_len) < max_name_len) && (name[0] != '$') &&
+                ((symbol_type == STT_FUNC) || (symbol_type == STT_NOTYPE)))
+            {
+                elf_symbol_t *const code_symbol = &table->symbols[table->num_symbols++];
+
+                code_symbol->address = (is_arm && (symbol_type == STT_FUNC)) ?
+                        (symbol.st_value & ~(uint64_t) 1) : symbol.st_value;
+                code_symbol->size = symbol.st_size;
+                code_symbol->name = name;
+            }
+        }
+    }
+
+    qsort (table->symbols, table->num_symbols, sizeof (table->symbols[0]), elf_symbol_compare);
+
+    return true;
+}
+
+/**
+ * @brief Release the symbols read by elf_file_read_code_symbols()
+ * @param[in,out] table The symbols to release
+ */
+void elf_file_free_symbols (elf_symbol_table_t *const table)
+{
+    free (table->symbols);
+    table->symbols = NULL;
+    table->num_symbols = 0;
+}
+
+/**
+ * @brief Find the code symbol containing an address
+ * @details Uses the symbol with the highest address at or below the address. If that symbol has a known size the
+ *          address must be within it, otherwise it is assumed to extend to the next symbol.
+ * @param[in] table The symbols to search
+ * @param[in] address The address to look up
+ * @return The symbol containing the address, or NULL if not found
+ */
+const elf_symbol_t *elf_file_lookup_symbol (const elf_symbol_table_t *const table, const uint64_t address)
+{
+    const elf_symbol_t *symbol;
+    size_t low = 0;
+    size_t high = table->num_symbols;
+    size_t mid;
+
+    /* Find the number of symbols with an address at or below the address */
+    while (low < high)
+    {
+        mid = low + ((high - low) / 2);
+        if (table->symbols[mid].address <= address)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    if (low == 0)
+    {
+        return NULL;
+    }
+
+    symbol = &table->symbols[low - 1];
+    if ((symbol->size != 0) && ((address - symbol->address) >= symbol->size))
+    {
+        return NULL;
+    }
+
+    return symbol;
+}
@@ -0,0 +1,62 @@
+/*
+ * @file elf_file.h
+ * @date 16 Oct 2026
+ * @brief Minimal reading of the ELF files produced by the GCC ARM compiler, for use by the host tools
+ */
+
+#ifndef ELF_FILE_H_
+#define ELF_FILE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** The contents of one section read from an ELF file */
+typedef struct
+{
+    /** The section contents, or NULL for a section which doesn't occupy space in the file */
+    const uint8_t *data;
+    /** The size of the section in bytes */
+    uint64_t size;
+    /** The address of the section in the target memory */
+    uint64_t address;
+} elf_section_t;
+
+/** An ELF file which has been read into memory */
+typedef struct
+{
+    /** The pathname of the file, for error reporting */
+    const char *pathname;
+    /** The complete file contents */
+    uint8_t *contents;
+    size_t contents_size;
+    /** True for a 64-bit ELF file, false for a 32-bit ELF file */
+    bool is_64bit;
+} elf_file_t;
+
+/** One code symbol read from an ELF file */
+typedef struct
+{
+    /** The address of the symbol, with the Thumb bit cleared for ARM functions */
+    uint64_t address;
+    /** The size of the symbol in bytes, or zero if not known, e.g. for an assembler label */
+    uint64_t size;
+    /** The name of the symbol, which points into the contents of the ELF file */
+    const char *name;
+} elf_symbol_t;
+
+/** The code symbols read from an ELF file, sorted by increasing address */
+typedef struct
+{
+    elf_symbol_t *symbols;
+    size_t num_symbols;
+} elf_symbol_table_t;
+
+bool elf_file_open (const char *const pathname, elf_file_t *const elf);
+void elf_file_close (elf_file_t *const elf);
+bool elf_file_find_section (const elf_file_t *const elf, const char *const section_name, elf_section_t *const section);
+bool elf_file_read_code_symbols (const elf_file_t *const elf, elf_symbol_table_t *const table);
+void elf_file_free_symbols (elf_symbol_table_t *const table);
+const elf_symbol_t *elf_file_lookup_symbol (const elf_symbol_table_t *const table, const uint64_t address);
+
+#endif /* ELF_FILE_H_ */
@@ -0,0 +1,353 @@
+/*
+ * @file mmu_page_table.c
+ * @date 16 Oct 2026
+ * @brief Host program which generates the MMU page tables for a program at build time
+ * @details Usage: mmu_page_table [-w] -o <output_c_file> [<region>=<policy> ...]
+ *
+ *          The page tables map the regions of the memory map in AM3352_SOM_platform/memory_map.c. Each argument
+ *          selects the policy for one region by name, with the other regions given their default policy.
+ *          A region is mapped with 1MB sections where it covers complete sections. A section which is only partly
+ *          covered by a region is mapped by a second level page table, using 64KB large pages where a region covers
+ *          a complete large page and otherwise 4KB small pages. Addresses outside of the mapped regions are left as
+ *          fault entries, so an access generates an abort.
+ *
+ *          The output is a C source file which defines the 16K aligned first level page table mmu_page_table[],
+ *          which the program passes to mmu_page_table_enable(), along with any second level page tables. By default
+ *          the tables are const so are placed in .rodata. With the -w option the tables aren't const, and so are
+ *          placed in .data, for a program which changes the policy of a region at run time.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory_map.h"
+
+/* The result of find_block_region() when no mapped region intersects the block */
+#define BLOCK_UNMAPPED MEMORY_MAP_NUM_REGIONS
+
+/* The result of find_block_region() when a block is only partly covered by a region */
+#define BLOCK_MIXED (-1)
+
+/* The number of large pages in a section, and small pages in a large page */
+#define LARGE_PAGES_PER_SECTION (MEMORY_MAP_SECTION_SIZE / MEMORY_MAP_LARGE_PAGE_SIZE)
+#define SMALL_PAGES_PER_LARGE_PAGE (MEMORY_MAP_LARGE_PAGE_SIZE / MEMORY_MAP_SMALL_PAGE_SIZE)
+
+/** The policy selected for each region */
+static memory_map_policy_t region_policies[MEMORY_MAP_NUM_REGIONS];
+
+/** The first level page table. Sections mapped by a second level page table are identified by l2_table_indices[] */
+static uint32_t l1_table[MEMORY_MAP_L1_NUM_ENTRIES];
+
+/** The second level page tables, allocated in address order */
+static uint32_t l2_tables[MEMORY_MAP_L1_NUM_ENTRIES][MEMORY_MAP_L2_NUM_ENTRIES];
+static uint32_t num_l2_tables;
+
+/** For each first level entry, the index into l2_tables[] or -1 if the entry isn't a second level page table */
+static int32_t l2_table_indices[MEMORY_MAP_L1_NUM_ENTRIES];
+
+/**
+ * @brief Check that the regions of the memory map are page aligned and don't overlap
+ */
+static void check_memory_map (void)
+{
+    const memory_map_region_t *region;
+    const memory_map_region_t *other;
+    uint32_t region_id;
+    uint32_t other_id;
+
+    for (region_id = 0; region_id < MEMORY_MAP_NUM_REGIONS; region_id++)
+    {
+        region = &memory_map_regions[region_id];
+        if ((region->size == 0) || ((region->start_addr % MEMORY_MAP_SMALL_PAGE_SIZE) != 0) ||
+            ((region->size % MEMORY_MAP_SMALL_PAGE_SIZE) != 0))
+        {
+            fprintf (stderr, "Memory map region %s isn't aligned to a %u byte small page\n", region->name,
+                     MEMORY_MAP_SMALL_PAGE_SIZE);
+            exit (EXIT_FAILURE);
+        }
+        for (other_id = 0; other_id < region_id; other_id++)
+        {
+            other = &memory_map_regions[other_id];
+            if (((uint64_t) region->start_addr < ((uint64_t) other->start_addr + other->size)) &&
+                ((uint64_t) other->start_addr < ((uint64_t) region->start_addr + region->size)))
+            {
+                fprintf (stderr, "Memory map region %s overlaps region %s\n", region->name, other->name);
+                exit (EXIT_FAILURE);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Select the policy for a region, from a command line argument
+ * @param[in] arg The argument, as <region>=<policy>
+ */
+static void select_region_policy (const char *const arg)
+{
+    const char *const separator = strchr (arg, '=');
+    size_t name_len;
+    uint32_t region_id;
+    uint32_t policy;
+
+    if (separator == NULL)
+    {
+        fprintf (stderr, "Argument %s isn't in the form <region>=<policy>\n", arg);
+        exit (EXIT_FAILURE);
+    }
+    name_len = (size_t) (separator - arg);
+
+    for (region_id = 0; region_id < MEMORY_MAP_NUM_REGIONS; region_id++)
+    {
+        if ((strlen (memory_map_regions[region_id].name) == name_len) &&
+            (strncmp (memory_map_regions[region_id].name, arg, name_len) == 0))
+        {
+            break;
+        }
+    }
+    if (region_id == MEMORY_MAP_NUM_REGIONS)
+    {
+        fprintf (stderr, "Argument %s has an unknown region. Valid regions are:", arg);
+        for (region_id = 0; region_id < MEMORY_MAP_NUM_REGIONS; region_id++)
+        {
+            fprintf (stderr, " %s", memory_map_regions[region_id].name);
+        }
+        fprintf (stderr, "\n");
+        exit (EXIT_FAILURE);
+    }
+
+    for (policy = 0; (policy < MEMORY_NUM_POLICIES) && (strcmp (separator + 1, memory_map_policy_names[policy]) != 0);
+         policy++)
+    {
+    }
+    if (policy == MEMORY_NUM_POLICIES)
+    {
+        fprintf (stderr, "Argument %s has an unknown policy. Valid policies are:", arg);
+        for (policy = 0; policy < MEMORY_NUM_POLICIES; policy++)
+        {
+            fprintf (stderr, " %s", memory_map_policy_names[policy]);
+        }
+        fprintf (stderr, "\n");
+        exit (EXIT_FAILURE);
+    }
+
+    region_policies[region_id] = (memory_map_policy_t) policy;
+}
+
+/**
+ * @brief Find the mapped region which contains a block of the address space
+ * @param[in] block_start The start address of the block
+ * @param[in] block_size The size of the block
+ * @return The region_id which contains the complete block, BLOCK_UNMAPPED if no mapped region intersects the
+ *         block, or BLOCK_MIXED if the block is only partly covered by a mapped region.
+ */
+static int find_block_region (const uint64_t block_start, const uint64_t block_size)
+{
+    const uint64_t block_end = block_start + block_size;
+    const memory_map_region_t *region;
+    uint64_t region_end;
+    uint32_t region_id;
+
+    for (region_id = 0; region_id < MEMORY_MAP_NUM_REGIONS; region_id++)
+    {
+        region = &memory_map_regions[region_id];
+        region_end = (uint64_t) region->start_addr + region->size;
+        if (region_policies[region_id] != MEMORY_POLICY_UNMAPPED)
+        {
+            if ((region->start_addr <= block_start) && (block_end <= region_end))
+            {
+                return (int) region_id;
+            }
+            if ((region->start_addr < block_end) && (block_start < region_end))
+            {
+                return BLOCK_MIXED;
+            }
+        }
+    }
+
+    return BLOCK_UNMAPPED;
+}
+
+/**
+ * @brief Map a section which is only partly covered by mapped regions, using a second level page table
+ * @param[in] section The index of the section
+ */
+static void map_section_pages (const uint32_t section)
+{
+    uint32_t *const l2_table = l2_tables[num_l2_tables];
+    uint32_t large_page;
+    uint32_t small_page;
+    uint32_t entry_index;
+    uint32_t large_page_addr;
+    uint32_t small_page_addr;
+    int large_page_region_id;
+    int small_page_region_id;
+
+    l2_table_indices[section] = (int32_t) num_l2_tables;
+    num_l2_tables++;
+
+    for (large_page = 0; large_page < LARGE_PAGES_PER_SECTION; large_page++)
+    {
+        large_page_addr = (section * MEMORY_MAP_SECTION_SIZE) + (large_page * MEMORY_MAP_LARGE_PAGE_SIZE);
+        large_page_region_id = find_block_region (large_page_addr, MEMORY_MAP_LARGE_PAGE_SIZE);
+        for (small_page = 0; small_page < SMALL_PAGES_PER_LARGE_PAGE; small_page++)
+        {
+            entry_index = (large_page * SMALL_PAGES_PER_LARGE_PAGE) + small_page;
+            small_page_addr = large_page_addr + (small_page * MEMORY_MAP_SMALL_PAGE_SIZE);
+            if (large_page_region_id == BLOCK_MIXED)
+            {
+                /* Each small page is completely within one region, since the regions are page aligned */
+                small_page_region_id = find_block_region (small_page_addr, MEMORY_MAP_SMALL_PAGE_SIZE);
+                if (small_page_region_id != BLOCK_UNMAPPED)
+                {
+                    l2_table[entry_index] = memory_map_small_page_entry (small_page_addr,
+                                                                         region_policies[small_page_region_id]);
+                }
+            }
+            else if (large_page_region_id != BLOCK_UNMAPPED)
+            {
+                /* A large page entry is repeated in the 16 entries covering the large page */
+                l2_table[entry_index] = memory_map_large_page_entry (large_page_addr,
+                                                                     region_policies[large_page_region_id]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Write the generated page tables as a C source file
+ * @param[in] output_name The name of the file to create
+ * @param[in] writable When false the tables are const
+ */
+static void write_page_tables (const char *const output_name, const bool writable)
+{
+    const char *const qualifier = writable ? "" : "const ";
+    const memory_map_region_t *region;
+    uint32_t region_id;
+    uint32_t table_index;
+    uint32_t entry_index;
+    FILE *output_file;
+
+    output_file = fopen (output_name, "w");
+    if (output_file == NULL)
+    {
+        fprintf (stderr, "Failed to create %s\n", output_name);
+        exit (EXIT_FAILURE);
+    }
+
+    fprintf (output_file, "/* MMU page tables generated by host_tools/mmu_page_table from the memory map:\n");
+    for (region_id = 0; region_id < MEMORY_MAP_NUM_REGIONS; region_id++)
+    {
+        region = &memory_map_regions[region_id];
+        fprintf (output_file, " *   %-10s 0x%08x size 0x%08x %s\n", region->name, region->start_addr, region->size,
+                 memory_map_policy_names[region_policies[region_id]]);
+    }
+    fprintf (output_file, " * Don't edit, since this file is re-generated by the build. */\n\n");
+    fprintf (output_file, "#include <stdint.h>\n\n");
+
+    if (num_l2_tables > 0)
+    {
+        fprintf (output_file, "static %suint32_t mmu_page_table_l2[%u][%u] __attribute__((aligned(%u))) =\n{\n",
+                 qualifier, num_l2_tables, MEMORY_MAP_L2_NUM_ENTRIES, MEMORY_MAP_L2_ALIGN_SIZE);
+        for (table_index = 0; table_index < num_l2_tables; table_index++)
+        {
+            fprintf (output_file, "    {\n");
+            for (entry_index = 0; entry_index < MEMORY_MAP_L2_NUM_ENTRIES; entry_index++)
+            {
+                fprintf (output_file, "%s0x%08x,%s", ((entry_index % 8u) == 0) ? "        " : "",
+                         l2_tables[table_index][entry_index], ((entry_index % 8u) == 7u) ? "\n" : " ");
+            }
+            fprintf (output_file, "    },\n");
+        }
+        fprintf (output_file, "};\n\n");
+    }
+
+    fprintf (output_file, "%suint32_t mmu_page_table[%u] __attribute__((aligned(%u))) =\n{\n",
+             qualifier, MEMORY_MAP_L1_NUM_ENTRIES, MEMORY_MAP_L1_ALIGN_SIZE);
+    for (entry_index = 0; entry_index < MEMORY_MAP_L1_NUM_ENTRIES; entry_index++)
+    {
+        fprintf (output_file, "%s", ((entry_index % 8u) == 0) ? "    " : "");
+        if (l2_table_indices[entry_index] >= 0)
+        {
+            /* The address of a second level page table is only known once linked */
+            fprintf (output_file, "(uint32_t) mmu_page_table_l2[%d] + 0x%xu,", l2_table_indices[entry_index],
+                     memory_map_l2_table_entry (0));
+        }
+        else
+        {
+            fprintf (output_file, "0x%08x,", l1_table[entry_index]);
+        }
+        fprintf (output_file, "%s", ((entry_index % 8u) == 7u) ? "\n" : " ");
+    }
+    fprintf (output_file, "};\n");
+
+    if (fclose (output_file) != 0)
+    {
+        fprintf (stderr, "Failed to write %s\n", output_name);
+        exit (EXIT_FAILURE);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+    bool writable = false;
+    const char *output_name = NULL;
+    int arg_index = 1;
+    uint32_t region_id;
+    uint32_t section;
+    int section_region_id;
+
+    while ((arg_index < argc) && (argv[arg_index][0] == '-'))
+    {
+        if (strcmp (argv[arg_index], "-w") == 0)
+        {
+            writable = true;
+            arg_index++;
+        }
+        else if ((strcmp (argv[arg_index], "-o") == 0) && ((arg_index + 1) < argc))
+        {
+            output_name = argv[arg_index + 1];
+            arg_index += 2;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (output_name == NULL)
+    {
+        fprintf (stderr, "Usage: %s [-w] -o <output_c_file> [<region>=<policy> ...]\n", argv[0]);
+        exit (EXIT_FAILURE);
+    }
+
+    check_memory_map ();
+    for (region_id = 0; region_id < MEMORY_MAP_NUM_REGIONS; region_id++)
+    {
+        region_policies[region_id] = memory_map_regions[region_id].default_policy;
+    }
+    for (; arg_index < argc; arg_index++)
+    {
+        select_region_policy (argv[arg_index]);
+    }
+
+    for (section = 0; section < MEMORY_MAP_L1_NUM_ENTRIES; section++)
+    {
+        l2_table_indices[section] = -1;
+        section_region_id = find_block_region ((uint64_t) section * MEMORY_MAP_SECTION_SIZE, MEMORY_MAP_SECTION_SIZE);
+        if (section_region_id == BLOCK_MIXED)
+        {
+            map_section_pages (section);
+        }
+        else if (section_region_id != BLOCK_UNMAPPED)
+        {
+            l1_table[section] = memory_map_section_entry (section * MEMORY_MAP_SECTION_SIZE,
+                                                          region_policies[section_region_id]);
+        }
+    }
+
+    write_page_tables (output_name, writable);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,189 @@
+/*
+ * @file profile_symbolize.c
+ * @date 16 Oct 2026
+ * @brief Host program which converts the profile dumped by the target sampling profiler into a flat profile
+ * @details Usage: profile_symbolize <elf_file> [<console_capture>]
+ *
+ *          The elf_file is the target program which was profiled, whose symbol table is used to find the function
+ *          containing each sampled address. The console output is read from console_capture if given, otherwise from
+ *          stdin. Lines which aren't part of a profile dump are ignored, so the complete console output can be used.
+ *          When the target uses deferred binary logging the console output must be first decoded by dlog_decode, e.g.:
+ *            dlog_decode ethernet_passthrough.out console.log | profile_symbolize ethernet_passthrough.out
+ *
+ *          The samples from all complete dumps in the console output are summed, and the functions are reported in
+ *          order of decreasing samples. See AM3352_SOM_platform/profiler.c for the dump format.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "elf_file.h"
+
+/* Copy of the dump line prefix in AM3352_SOM_platform/profiler.h, which can't be included in a host program as it
+ * depends upon the target headers. */
+#define PROFILER_DUMP_PREFIX "profile:"
+
+/** The maximum length of a console line which is parsed */
+#define MAX_LINE_LEN 256
+
+/** The samples for one function */
+typedef struct
+{
+    /** The function, or NULL for samples which weren't within any function */
+    const elf_symbol_t *symbol;
+    uint64_t samples;
+} function_samples_t;
+
+/**
+ * @brief Compare two functions for sorting by decreasing samples, and then by name
+ */
+static int function_samples_compare (const void *const compare_a, const void *const compare_b)
+{
+    const function_samples_t *const a = compare_a;
+    const function_samples_t *const b = compare_b;
+
+    if (a->samples != b->samples)
+    {
+        return (a->samples > b->samples) ? -1 : 1;
+    }
+    if ((a->symbol == NULL) || (b->symbol == NULL))
+    {
+        return (a->symbol == NULL) ? 1 : -1;
+    }
+    return strcmp (a->symbol->name, b->symbol->name);
+}
+
+int main (int argc, char *argv[])
+{
+    elf_file_t elf;
+    elf_symbol_table_t symbols;
+    FILE *console;
+    char line[MAX_LINE_LEN];
+    function_samples_t *functions;
+    function_samples_t *dump_functions;
+    const size_t prefix_len = strlen (PROFILER_DUMP_PREFIX);
+    size_t num_functions;
+    size_t function_index;
+    bool in_dump = false;
+    uint32_t num_dumps = 0;
+    unsigned int sample_hz = 0;
+    unsigned int dump_samples;
+    unsigned int dump_outside_text_samples;
+    uint64_t total_samples = 0;
+    uint64_t outside_text_samples = 0;
+    unsigned int address;
+    unsigned int count;
+
+    if ((argc != 2) && (argc != 3))
+    {
+        fprintf (stderr, "Usage: %s <elf_file> [<console_capture>]\n", argv[0]);
+        exit (EXIT_FAILURE);
+    }
+
+    if (!elf_file_open (argv[1], &elf) || !elf_file_read_code_symbols (&elf, &symbols))
+    {
+        exit (EXIT_FAILURE);
+    }
+
+    if (argc == 3)
+    {
+        console = fopen (argv[2], "r");
+        if (console == NULL)
+        {
+            fprintf (stderr, "Failed to open %s\n", argv[2]);
+            exit (EXIT_FAILURE);
+        }
+    }
+    else
+    {
+        console = stdin;
+    }
+
+    /* One entry per symbol, plus a final entry for samples not within any symbol. The samples of the dump in progress
+     * are accumulated separately, so that an incomplete dump at the end of the console output is ignored. */
+    num_functions = symbols.num_symbols + 1;
+    functions = calloc (num_functions, sizeof (functions[0]));
+    dump_functions = calloc (num_functions, sizeof (dump_functions[0]));
+    if ((functions == NULL) || (dump_functions == NULL))
+    {
+        fprintf (stderr, "Failed to allocate function samples\n");
+        exit (EXIT_FAILURE);
+    }
+    for (function_index = 0; function_index < symbols.num_symbols; function_index++)
+    {
+        functions[function_index].symbol = &symbols.symbols[function_index];
+    }
+
+    while (fgets (line, sizeof (line), console) != NULL)
+    {
+        const char *const dump_line = strstr (line, PROFILER_DUMP_PREFIX);
+
+        if (dump_line == NULL)
+        {
+            continue;
+        }
+
+        if (sscanf (&dump_line[prefix_len], " start %u %u %u", &sample_hz, &dump_samples,
+                    &dump_outside_text_samples) == 3)
+        {
+            memset (dump_functions, 0, num_functions * sizeof (dump_functions[0]));
+            in_dump = true;
+        }
+        else if (!in_dump)
+        {
+            /* Skip the remainder of a dump which was in progress when the console capture started */
+        }
+        else if (sscanf (&dump_line[prefix_len], " %x %u", &address, &count) == 2)
+        {
+            const elf_symbol_t *const symbol = elf_file_lookup_symbol (&symbols, address);
+
+            function_index = (symbol != NULL) ? (size_t) (symbol - symbols.symbols) : symbols.num_symbols;
+            dump_functions[function_index].samples += count;
+        }
+        else if (strncmp (&dump_line[prefix_len], " end", 4) == 0)
+        {
+            for (function_index = 0; function_index < num_functions; function_index++)
+            {
+                functions[function_index].samples += dump_functions[function_index].samples;
+            }
+            total_samples += dump_samples;
+            outside_text_samples += dump_outside_text_samples;
+            num_dumps++;
+            in_dump = false;
+        }
+    }
+
+    if (num_dumps == 0)
+    {
+        fprintf (stderr, "No complete profile dumps found\n");
+        exit (EXIT_FAILURE);
+    }
+
+    printf ("%u dumps, %" PRIu64 " samples at %u Hz (%.3f seconds), %" PRIu64 " samples outside of the code\n\n",
+            num_dumps, total_samples, sample_hz, (sample_hz != 0) ? ((double) total_samples / sample_hz) : 0.0,
+            outside_text_samples);
+    printf ("   Samples       %%  Function\n");
+    qsort (functions, num_functions, sizeof (functions[0]), function_samples_compare);
+    for (function_index = 0; (function_index < num_functions) && (functions[function_index].samples > 0);
+         function_index++)
+    {
+        const function_samples_t *const function = &functions[function_index];
+
+        printf ("%10" PRIu64 "  %6.2f  %s\n", function->samples,
+                (100.0 * (double) function->samples) / (double) total_samples,
+                (function->symbol != NULL) ? function->symbol->name : "<unknown>");
+    }
+
+    if (console != stdin)
+    {
+        fclose (console);
+    }
+    free (functions);
+    free (dump_functions);
+    elf_file_free_symbols (&symbols);
+    elf_file_close (&elf);
+
+    return EXIT_SUCCESS;
+}
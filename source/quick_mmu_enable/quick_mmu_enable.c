@@ -3,12 +3,12 @@
  * @date 2 Augr 2015
  * @author Chester Gillon
  * @brief Enable the MMU as quickly as possible
+ * @details The page table is generated at build time, so enabling the MMU doesn't have to fill in the page table.
  * @todo When this program is placed on a bootable SD card, it prevents the CCS debugger from being able
  *       to download a program unless the SD card is removed.
  */
 
 #include <stdint.h>
-#include <string.h>
 
 #include <hw/hw_types.h>
 #include <hw/soc_AM335x.h>
@@ -16,75 +16,11 @@
 #include <hw/hw_cm_wkup.h>
 #include <uartStdio.h>
 #include <consoleUtils.h>
-#include <mmu.h>
+#include <mmu_page_table.h>
 
-/* The MMU regions used */
-#define START_ADDR_DEV             (0x44000000)
-#define START_ADDR_IRAM            (0x40300000)
-#define NUM_SECTIONS_DEV           (960)
-#define NUM_SECTIONS_IRAM          (1)
-
-/* page tables start must be aligned in 16K boundary */
-#ifdef __TMS470__
-#pragma DATA_ALIGN(pageTable, MMU_PAGETABLE_ALIGN_SIZE);
-static volatile unsigned int pageTable[4*1024];
-
-#elif defined(gcc)
-/* @todo Placed in it's own section and zeroed with memset() to avoid the linker memory allocation failing */
-static volatile unsigned int pageTable[4*1024]
-__attribute__((aligned(MMU_PAGETABLE_ALIGN_SIZE)))
-__attribute__((section(".mmu_page_table")));
-
-#else
-#error "Unsupported Compiler.\r\n"
-
-#endif
-
-/*
-** Function to setup MMU. This function Maps three regions (1. DDR
-** 2. OCMC and 3. Device memory) and enables MMU.
-*/
-static void MMUConfigAndEnable(void)
-{
-    /*
-    ** Define IRAM memory region of AM335x. IRAM can be configured as Normal
-    ** memory with R/W access in user/privileged modes. The cache attributes
-    ** specified here are,
-    ** Inner - Write through, No Write Allocate
-    ** Outer - Write Back, Write Allocate
-    */
-    REGION regionIram = {
-                         MMU_PGTYPE_SECTION, START_ADDR_IRAM, NUM_SECTIONS_IRAM,
-                         MMU_MEMTYPE_NORMAL_NON_SHAREABLE(MMU_CACHE_WT_NOWA,
-                                                          MMU_CACHE_WB_WA),
-                         MMU_REGION_NON_SECURE, MMU_AP_PRV_RW_USR_RW,
-                         (unsigned int*)pageTable
-                        };
-
-    /*
-    ** Define Device Memory Region. The region between OCMC and DDR is
-    ** configured as device memory, with R/W access in user/privileged modes.
-    ** Also, the region is marked 'Execute Never'.
-    */
-    REGION regionDev = {
-                        MMU_PGTYPE_SECTION, START_ADDR_DEV, NUM_SECTIONS_DEV,
-                        MMU_MEMTYPE_DEVICE_SHAREABLE,
-                        MMU_REGION_NON_SECURE,
-                        MMU_AP_PRV_RW_USR_RW  | MMU_SECTION_EXEC_NEVER,
-                        (unsigned int*)pageTable
-                       };
-
-    /* Initialize the page table and MMU */
-    memset ((void *) pageTable, 0, sizeof (pageTable));
-    MMUInit((unsigned int*)pageTable);
-
-    /* Map the defined regions */
-    MMUMemRegionMap(&regionIram);
-    MMUMemRegionMap(&regionDev);
-
-    /* Now Safe to enable MMU */
-    MMUEnable((unsigned int*)pageTable);
-}
+/* Defined in the source file generated at build time by host_tools/mmu_page_table, from the platform memory map with
+ * the policies selected in the CMakeLists.txt */
+extern const uint32_t mmu_page_table[MMU_PAGE_TABLE_NUM_ENTRIES];
 
 /**
  * @brief This function is used to initialize and configure UART Module.
@@ -96,7 +32,7 @@ static void UART_setup (void)
 
 int main(void)
 {
-    MMUConfigAndEnable ();
+    mmu_page_table_enable (mmu_page_table);
     UART_setup ();
 
     UARTprintf ("MMU enabled\n");
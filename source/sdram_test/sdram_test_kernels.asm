@@ -0,0 +1,118 @@
+/*
+  @file sdram_test_kernels.asm
+  @date 16 Oct 2026
+  @brief NEON implementation of the March elements used by the SDRAM test patterns
+  @details Each kernel operates on a region of memory from start up to end (exclusive) in 64 byte blocks,
+           i.e. one cache line, using a 64 byte pattern block which is repeated over the region:
+
+           void sdram_neon_write_up (uint32_t *start, uint32_t *end, const uint32_t new_block[16]);
+           uint32_t *sdram_neon_read_up (uint32_t *start, uint32_t *end, const uint32_t expected_block[16]);
+           uint32_t *sdram_neon_read_write_up (uint32_t *start, uint32_t *end, const uint32_t expected_block[16],
+                                               const uint32_t new_block[16]);
+           uint32_t *sdram_neon_read_write_down (uint32_t *start, uint32_t *end, const uint32_t expected_block[16],
+                                                 const uint32_t new_block[16]);
+
+           The _up kernels process the blocks in ascending address order, and _down in descending address order.
+           The kernels which read return a pointer to the first block which didn't match expected_block, without
+           having written the new pattern to that block, or NULL if all blocks matched. This allows the caller
+           to locate the failing words and bits with the contents of the failing block intact, and then resume
+           the kernel from the next block.
+
+           start, end and the pattern blocks must be aligned to 64 bytes.
+           Only q0-q3 and q8-q15 are used, since d8-d15 are callee saved.
+*/
+
+        .arch armv7-a
+        .fpu  neon
+        .syntax unified
+        .arm
+        .text
+
+/* Load a 64 byte pattern block into q8-q11 (expected) or q12-q15 (new) */
+        .macro load_expected_block reg
+        vld1.32 {d16-d19}, [\reg:128]!
+        vld1.32 {d20-d23}, [\reg:128]
+        .endm
+
+        .macro load_new_block reg
+        vld1.32 {d24-d27}, [\reg:128]!
+        vld1.32 {d28-d31}, [\reg:128]
+        .endm
+
+/* Compare the block in q0-q3 against the expected block in q8-q11, setting the Z flag if the block matches.
+   The contents of q0-q3 are destroyed. */
+        .macro compare_block
+        veor    q0, q0, q8
+        veor    q1, q1, q9
+        veor    q2, q2, q10
+        veor    q3, q3, q11
+        vorr    q0, q0, q1
+        vorr    q2, q2, q3
+        vorr    q0, q0, q2
+        vorr    d0, d0, d1
+        vmov    r12, r3, d0
+        orrs    r12, r12, r3
+        .endm
+
+        .global sdram_neon_write_up
+        .type   sdram_neon_write_up, %function
+sdram_neon_write_up:
+        load_new_block r2
+1:      vst1.32 {d24-d27}, [r0:128]!
+        vst1.32 {d28-d31}, [r0:128]!
+        cmp     r0, r1
+        blo     1b
+        bx      lr
+
+        .global sdram_neon_read_up
+        .type   sdram_neon_read_up, %function
+sdram_neon_read_up:
+        load_expected_block r2
+1:      vld1.32 {d0-d3}, [r0:128]!
+        vld1.32 {d4-d7}, [r0:128]!
+        compare_block
+        bne     2f
+        cmp     r0, r1
+        blo     1b
+        mov     r0, #0
+        bx      lr
+2:      sub     r0, r0, #64
+        bx      lr
+
+        .global sdram_neon_read_write_up
+        .type   sdram_neon_read_write_up, %function
+sdram_neon_read_write_up:
+        load_expected_block r2
+        load_new_block r3
+1:      vld1.32 {d0-d3}, [r0:128]!
+        vld1.32 {d4-d7}, [r0:128]
+        sub     r0, r0, #32
+        compare_block
+        bne     2f
+        vst1.32 {d24-d27}, [r0:128]!
+        vst1.32 {d28-d31}, [r0:128]!
+        cmp     r0, r1
+        blo     1b
+        mov     r0, #0
+2:      bx      lr
+
+        .global sdram_neon_read_write_down
+        .type   sdram_neon_read_write_down, %function
+sdram_neon_read_write_down:
+        load_expected_block r2
+        load_new_block r3
+        mov     r2, r0
+        mov     r0, r1
+1:      sub     r0, r0, #64
+        vld1.32 {d0-d3}, [r0:128]!
+        vld1.32 {d4-d7}, [r0:128]
+        sub     r0, r0, #32
+        compare_block
+        bne     2f
+        vst1.32 {d24-d27}, [r0:128]!
+        vst1.32 {d28-d31}, [r0:128]
+        sub     r0, r0, #32
+        cmp     r0, r2
+        bhi     1b
+        mov     r0, #0
+2:      bx      lr
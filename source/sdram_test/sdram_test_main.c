@@ -3,11 +3,10 @@
  * @date 28 Mar 2015
  * @author Chester Gillon
  * @brief SDRAM test which executes in the AM3352 on-chip SRAM, to be able to test all of the SDRAM
- * @details This version writes and then reads back a test pattern to the entire SDRAM, with progress reported via the UART0
+ * @details This version runs the test patterns in sdram_test_patterns.c over the entire SDRAM, with progress reported via the UART0
  */
 
 #include <stdint.h>
-#include <string.h>
 
 #include <hw/hw_types.h>
 #include <hw/soc_AM335x.h>
@@ -17,7 +16,14 @@
 #include <consoleUtils.h>
 #include <rtc.h>
 #include <cache.h>
-#include <mmu.h>
+#include <cp15.h>
+#include <interrupt.h>
+#include <timestamp.h>
+#include <boot_timeline.h>
+#include <mmu_page_table.h>
+
+#include "stream_benchmark.h"
+#include "sdram_test_patterns.h"
 
 /* The total SDRAM size which is tested */
 #define SDRAM_BASE_ADDR 0x80000000
@@ -33,85 +39,106 @@
 #define MINUTE_SHIFT         (16)
 #define SECOND_SHIFT         (8)
 
-/* The MMU regions used */
-#define START_ADDR_DDR             (0x80000000)
-#define START_ADDR_DEV             (0x44000000)
-#define START_ADDR_OCMC            (0x40300000)
-#define NUM_SECTIONS_DDR           (512)
-#define NUM_SECTIONS_DEV           (960)
-#define NUM_SECTIONS_OCMC          (1)
-
-/* page tables start must be aligned in 16K boundary */
-#ifdef __TMS470__
-#pragma DATA_ALIGN(pageTable, MMU_PAGETABLE_ALIGN_SIZE);
-static volatile unsigned int pageTable[4*1024];
-#elif defined(gcc)
-/* @todo Placed in it's own section and zeroed with memset() to avoid the linker memory allocation failing */
-static volatile unsigned int pageTable[4*1024]
-__attribute__((aligned(MMU_PAGETABLE_ALIGN_SIZE)))
-__attribute__((section(".mmu_page_table")));
-
-#else
-#error "Unsupported Compiler.\r\n"
+/* When non-zero the STREAM benchmark is run once at start up, before the SDRAM test starts overwriting the SDRAM */
+#ifndef STREAM_BENCHMARK
+#define STREAM_BENCHMARK 1
+#endif
+
+/* Selects the implementation used by the SDRAM test patterns, either SDRAM_TEST_NEON or SDRAM_TEST_SCALAR */
+#ifndef SDRAM_TEST_IMPLEMENTATION
+#define SDRAM_TEST_IMPLEMENTATION SDRAM_TEST_NEON
+#endif
 
+/* When non-zero the SDRAM is mapped as non-cacheable during the test, so the caches are bypassed.
+ * When zero the SDRAM remains cacheable, and the SDRAM test patterns invalidate the cache instead. */
+#ifndef SDRAM_TEST_CACHE_BYPASS
+#define SDRAM_TEST_CACHE_BYPASS 1
 #endif
 
+/* Defined in the source file generated at build time by host_tools/mmu_page_table, from the platform memory map.
+ * Writable since change_ram_cache_policy() changes the policy of the RAM regions. */
+extern uint32_t mmu_page_table[MMU_PAGE_TABLE_NUM_ENTRIES];
+
 /*
-** Function to setup MMU. This function Maps three regions (1. DDR
-** 2. OCMC and 3. Device memory) and enables MMU.
+** The default cache policy for the DDR and OCMC RAM, which is Normal memory with:
+** Inner - Write through, No Write Allocate
+** Outer - Write Back, Write Allocate
 */
-static void MMUConfigAndEnable(void)
+#define DEFAULT_RAM_POLICY MEMORY_POLICY_NORMAL_WT_WB
+
+/* When non-zero the cache policy matrix benchmark is run once at start up, after the STREAM benchmark */
+#ifndef CACHE_POLICY_BENCHMARK
+#define CACHE_POLICY_BENCHMARK 1
+#endif
+
+#if CACHE_POLICY_BENCHMARK
+/** One cache policy used for the cache policy matrix benchmark */
+typedef struct
+{
+    /** Describes the cache policy in the results */
+    const char *name;
+    /** The memory type and cache policy for the page table */
+    memory_map_policy_t policy;
+} cache_policy_t;
+
+static const cache_policy_t cache_policies[] =
 {
-    /*
-    ** Define DDR memory region of AM335x. DDR can be configured as Normal
-    ** memory with R/W access in user/privileged modes. The cache attributes
-    ** specified here are,
-    ** Inner - Write through, No Write Allocate
-    ** Outer - Write Back, Write Allocate
-    */
-    REGION regionDdr = {
-                        MMU_PGTYPE_SECTION, START_ADDR_DDR, NUM_SECTIONS_DDR,
-                        MMU_MEMTYPE_NORMAL_NON_SHAREABLE(MMU_CACHE_WT_NOWA,
-                                                         MMU_CACHE_WB_WA),
-                        MMU_REGION_NON_SECURE, MMU_AP_PRV_RW_USR_RW,
-                        (unsigned int*)pageTable
-                       };
-    /*
-    ** Define OCMC RAM region of AM335x. Same Attributes of DDR region given.
-    */
-    REGION regionOcmc = {
-                         MMU_PGTYPE_SECTION, START_ADDR_OCMC, NUM_SECTIONS_OCMC,
-                         MMU_MEMTYPE_NORMAL_NON_SHAREABLE(MMU_CACHE_WT_NOWA,
-                                                          MMU_CACHE_WB_WA),
-                         MMU_REGION_NON_SECURE, MMU_AP_PRV_RW_USR_RW,
-                         (unsigned int*)pageTable
-                        };
-
-    /*
-    ** Define Device Memory Region. The region between OCMC and DDR is
-    ** configured as device memory, with R/W access in user/privileged modes.
-    ** Also, the region is marked 'Execute Never'.
-    */
-    REGION regionDev = {
-                        MMU_PGTYPE_SECTION, START_ADDR_DEV, NUM_SECTIONS_DEV,
-                        MMU_MEMTYPE_DEVICE_SHAREABLE,
-                        MMU_REGION_NON_SECURE,
-                        MMU_AP_PRV_RW_USR_RW  | MMU_SECTION_EXEC_NEVER,
-                        (unsigned int*)pageTable
-                       };
-
-    /* Initialize the page table and MMU */
-    memset ((void *) pageTable, 0, sizeof (pageTable));
-    MMUInit((unsigned int*)pageTable);
-
-    /* Map the defined regions */
-    MMUMemRegionMap(&regionDdr);
-    MMUMemRegionMap(&regionOcmc);
-    MMUMemRegionMap(&regionDev);
-
-    /* Now Safe to enable MMU */
-    MMUEnable((unsigned int*)pageTable);
+    {"inner WT-noWA outer WB-WA (default)", DEFAULT_RAM_POLICY},
+    {"WB-WA", MEMORY_POLICY_NORMAL_WB},
+    {"WB-noWA", MEMORY_POLICY_NORMAL_WB_NOWA},
+    {"WT", MEMORY_POLICY_NORMAL_WT},
+    {"non-cacheable", MEMORY_POLICY_NORMAL_NC},
+    {"strongly ordered", MEMORY_POLICY_STRONGLY_ORDERED}
+};
+#define NUM_CACHE_POLICIES (sizeof (cache_policies) / sizeof (cache_policies[0]))
+#endif
+
+/**
+ * @brief Change the cache policy of the DDR and OCMC RAM, while the MMU remains enabled
+ * @details The virtual to physical mapping is unchanged, only the memory attributes. The caches are disabled,
+ *          which cleans the data cache, while the page table is changed so no cache lines can be left allocated
+ *          with the previous attributes. The page table is written while the data cache is disabled, so doesn't
+ *          need cleaning before the TLB is invalidated.
+ * @param[in] ddr_policy The memory type and cache policy for the DDR
+ * @param[in] ocmc_policy The memory type and cache policy for the OCMC RAM
+ */
+static void change_ram_cache_policy (const memory_map_policy_t ddr_policy, const memory_map_policy_t ocmc_policy)
+{
+    CacheDisable (CACHE_ALL);
+    mmu_page_table_set_policy (mmu_page_table, MEMORY_MAP_DDR, ddr_policy);
+    mmu_page_table_set_policy (mmu_page_table, MEMORY_MAP_OCMC, ocmc_policy);
+    CP15TlbInvalidate ();
+    CacheEnable (CACHE_ALL);
+}
+
+#if CACHE_POLICY_BENCHMARK
+/**
+ * @brief Run the STREAM kernels with each cache policy for the DDR and OCMC RAM, displaying a matrix of the results
+ * @details The cache policy is only changed for the region being benchmarked. The OCMC RAM also contains the
+ *          program code and stack, so the OCMC results include the effect of the policy on instruction fetches.
+ * @param[in] cycle_counter_ticks_per_sec The measured frequency of the cycle counter, used to convert to MB/s
+ */
+static void cache_policy_benchmark (const uint32_t cycle_counter_ticks_per_sec)
+{
+    uint32_t region_id;
+    uint32_t policy_index;
+
+    for (region_id = 0; region_id < STREAM_NUM_REGIONS; region_id++)
+    {
+        stream_benchmark_cache_policy_heading (region_id);
+        for (policy_index = 0; policy_index < NUM_CACHE_POLICIES; policy_index++)
+        {
+            const cache_policy_t *const policy = &cache_policies[policy_index];
+
+            change_ram_cache_policy ((region_id == STREAM_REGION_DDR) ? policy->policy : DEFAULT_RAM_POLICY,
+                                     (region_id == STREAM_REGION_OCMC) ? policy->policy : DEFAULT_RAM_POLICY);
+            stream_benchmark_cache_policy (region_id, policy->name, cycle_counter_ticks_per_sec);
+        }
+    }
+
+    change_ram_cache_policy (DEFAULT_RAM_POLICY, DEFAULT_RAM_POLICY);
 }
+#endif
 
 /**
  * @brief This function is used to initialize and configure UART Module.
@@ -206,33 +233,24 @@ static void time_resolve (unsigned int timeValue)
 }
 
 /**
- * @brief Use a one second delay from the RTC to report the frequency of other clocks
+ * @brief Report the frequencies of the timestamp timer and the cycle counter
+ * @details Waits for just over one second, so that the cycle counter frequency has been measured over a full
+ *          second by the timestamp overflow interrupt
+ * @return The measured number of cycle counter ticks per second
  */
-static void check_clock_frequencies (void)
+static uint32_t check_clock_frequencies (void)
 {
-    unsigned int initial_rtc_time;
-    unsigned int current_rtc_time;
-    unsigned int perf_timer_ticks_per_sec;
-    unsigned int start_cycle_count, stop_cycle_count;
+    const uint64_t start_ns = timestamp_get_ns ();
+    uint32_t cycle_counter_ticks_per_sec;
 
-    initial_rtc_time = RTCTimeGet (SOC_RTC_0_REGS);
-    do
+    while ((timestamp_get_ns () - start_ns) < (TIMESTAMP_NS_PER_SEC + (TIMESTAMP_NS_PER_SEC / 10u)))
     {
-        current_rtc_time = RTCTimeGet (SOC_RTC_0_REGS);
-    } while (current_rtc_time == initial_rtc_time);
-    (void) SysPerfTimerConfig (1);
-    start_cycle_count = pmu_get_cycle_count ();
-
-    initial_rtc_time = current_rtc_time;
-    do
-    {
-        current_rtc_time = RTCTimeGet (SOC_RTC_0_REGS);
-    } while (current_rtc_time == initial_rtc_time);
-    perf_timer_ticks_per_sec = SysPerfTimerConfig (0);
-    stop_cycle_count = pmu_get_cycle_count ();
+    }
+    cycle_counter_ticks_per_sec = timestamp_cycle_counter_hz ();
 
-    UARTprintf ("Perf Timer Ticks Per Second = %u\n", perf_timer_ticks_per_sec);
-    UARTprintf ("cycle counter Ticks Per Second = %u\n", stop_cycle_count - start_cycle_count);
+    UARTprintf ("Timestamp Timer Ticks Per Second = %u\n", timestamp_timer_hz ());
+    UARTprintf ("cycle counter Ticks Per Second = %u\n", cycle_counter_ticks_per_sec);
+    return cycle_counter_ticks_per_sec;
 }
 
 /**
@@ -304,73 +322,80 @@ static void mmu_and_cache_on_delay (void)
 
 int main (void)
 {
-    uint32_t *const sdram_base = (uint32_t *) SDRAM_BASE_ADDR;
-    uint32_t index;
-    uint32_t num_errors;
-    uint32_t offset;
-    unsigned int write_duration, clean_and_invalidate_duration, read_duration;
+    sdram_test_config_t config;
+    sdram_test_pattern_result_t result;
+    uint32_t pattern_index;
+    uint32_t total_errors;
+    uint32_t cycle_counter_ticks_per_sec;
 
+    boot_timeline_mark (BOOT_PHASE_APP_ENTRY);
     enable_cycle_count ();
+    boot_timeline_cycle_counter_reset ();
     mmu_and_cache_off_delay ();
-    MMUConfigAndEnable ();
+    boot_timeline_mark (BOOT_PHASE_APP_MMU_OFF_DELAY);
+    mmu_page_table_enable (mmu_page_table);
     CacheEnable (CACHE_ALL);
+    boot_timeline_mark (BOOT_PHASE_APP_MMU_ENABLE);
     mmu_and_cache_on_delay ();
+    boot_timeline_mark (BOOT_PHASE_APP_MMU_ON_DELAY);
     UART_setup ();
+    boot_timeline_mark (BOOT_PHASE_APP_UART_SETUP);
     RTC_setup ();
-    SysPerfTimerSetup ();
-    check_clock_frequencies ();
+    boot_timeline_mark (BOOT_PHASE_APP_RTC_SETUP);
+    IntAINTCInit ();
+    IntMasterIRQEnable ();
+    boot_timeline_mark (BOOT_PHASE_APP_INTC_INIT);
+    timestamp_init ();
+    boot_timeline_mark (BOOT_PHASE_APP_TIMESTAMP_INIT);
+    boot_timeline_print ();
+    cycle_counter_ticks_per_sec = check_clock_frequencies ();
+#if STREAM_BENCHMARK
+    stream_benchmark_run (cycle_counter_ticks_per_sec);
+#endif
+#if CACHE_POLICY_BENCHMARK
+    cache_policy_benchmark (cycle_counter_ticks_per_sec);
+#endif
+    (void) cycle_counter_ticks_per_sec;
+
+    config.start = (uint32_t *) SDRAM_BASE_ADDR;
+    config.num_words = SDRAM_SIZE_WORDS;
+    config.implementation = SDRAM_TEST_IMPLEMENTATION;
+    config.cache_bypass = SDRAM_TEST_CACHE_BYPASS;
+    config.iteration = 0;
+    if (config.cache_bypass)
+    {
+        change_ram_cache_policy (MEMORY_POLICY_NORMAL_NC, DEFAULT_RAM_POLICY);
+    }
+    UARTprintf ("\nSDRAM test using %s implementation with cache %s\n",
+                (config.implementation == SDRAM_TEST_NEON) ? "NEON" : "scalar",
+                config.cache_bypass ? "bypassed" : "invalidated after each March element");
 
-    num_errors = 0;
-    offset = 0;
+    total_errors = 0;
     for (;;)
     {
         time_resolve (RTCTimeGet (SOC_RTC_0_REGS));
-        UARTprintf ("Write test starting\n");
-        (void) SysPerfTimerConfig (1);
-        for (index = 0; index < SDRAM_SIZE_WORDS; index++)
+        UARTprintf ("Test iteration %u starting\n", config.iteration);
+        for (pattern_index = 0; pattern_index < sdram_test_num_patterns; pattern_index++)
         {
-            sdram_base[index] = index + offset;
-        }
-        write_duration = SysPerfTimerConfig (0);
-
-        /* Ensure all the test pattern is cleaned and invalidated from cache, so that the read is forced to be from the SDRAM */
-        (void) SysPerfTimerConfig (1);
-        CacheDataCleanInvalidateBuff (SDRAM_BASE_ADDR, SDRAM_SIZE_BYTES);
-        clean_and_invalidate_duration = SysPerfTimerConfig (0);
-
-        (void) SysPerfTimerConfig (1);
-        for (index = 0; index < SDRAM_SIZE_WORDS; index++)
-        {
-            if (sdram_base[index] != (index + offset))
-            {
-                num_errors++;
-            }
-        }
-        read_duration = SysPerfTimerConfig (0);
-
-        time_resolve (RTCTimeGet (SOC_RTC_0_REGS));
-        UARTprintf ("Write duration = %u  Clean and invalidate duration = %u  Read duration = %u\n",
-                    write_duration, clean_and_invalidate_duration, read_duration);
-        UARTprintf ("After index write num_errors=%u\n", num_errors);
-
-        for (index = 0; index < SDRAM_SIZE_WORDS; index++)
-        {
-            sdram_base[index] = ~(index + offset);
-        }
-        CacheDataCleanInvalidateBuff (SDRAM_BASE_ADDR, SDRAM_SIZE_BYTES);
-        for (index = 0; index < SDRAM_SIZE_WORDS; index++)
-        {
-            if (sdram_base[index] != ~(index + offset))
+            const sdram_test_pattern_t *const pattern = &sdram_test_patterns[pattern_index];
+
+            sdram_test_run_pattern (pattern, &config, &result);
+            total_errors += result.num_errors;
+            UARTprintf ("%s duration = %u ms  num_errors=%u", pattern->name,
+                        (uint32_t) (result.duration_ns / 1000000u),
+                        result.num_errors);
+            if (result.num_errors > 0)
             {
-                num_errors++;
+                UARTprintf ("  first failing address=0x%08X failing bits=0x%08X",
+                            result.first_failing_address, result.failing_bits);
             }
+            UARTprintf ("\n");
         }
 
         time_resolve (RTCTimeGet (SOC_RTC_0_REGS));
-        UARTprintf ("After ~index write num_errors=%u\n", num_errors);
-        offset++;
+        UARTprintf ("After iteration %u total num_errors=%u\n", config.iteration, total_errors);
+        config.iteration++;
     }
 
     return 0;
 }
-
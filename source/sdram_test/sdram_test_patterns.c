@@ -0,0 +1,483 @@
+/*
+ * @file sdram_test_patterns.c
+ * @date 16 Oct 2026
+ * @brief Pluggable engine of test patterns used to test the SDRAM
+ * @details The test patterns are:
+ *          - Address bus isolation, which writes to each power of two word offset in turn to detect address
+ *            lines which are stuck or shorted.
+ *          - Data bus walking ones and zeros, which exercises each data line in isolation over the region.
+ *          - March C-, which detects stuck-at, transition and coupling faults.
+ *          - Moving inversions, which repeats ascending and descending inversions over data backgrounds which
+ *            toggle adjacent data lines.
+ *          - Address in address, which writes a unique value to each word to detect aliased addresses.
+ *
+ *          The March based patterns are built from March elements which repeat a 64 byte pattern block over the
+ *          region. The NEON implementation processes a 64 byte block per access, so the read and write of each word
+ *          in a block are grouped rather than interleaved per word as in the scalar implementation.
+ *
+ *          The address bus isolation and address in address patterns only have a scalar implementation; the former
+ *          only makes a few accesses, and the latter needs a different value for every word.
+ */
+
+#include <stddef.h>
+
+#include <AM3352_SOM.h>
+#include <uartStdio.h>
+#include <cache.h>
+#include <timestamp.h>
+
+#include "sdram_test_patterns.h"
+
+/** The number of words in the pattern block used by the March elements, which is one cache line */
+#define SDRAM_TEST_BLOCK_WORDS 16
+
+/** The maximum number of failing words which are reported individually for each run of a test pattern */
+#define SDRAM_TEST_MAX_REPORTED_ERRORS 10
+
+/** The NEON March element kernels in sdram_test_kernels.asm */
+void sdram_neon_write_up (uint32_t *start, uint32_t *end, const uint32_t new_block[SDRAM_TEST_BLOCK_WORDS]);
+uint32_t *sdram_neon_read_up (uint32_t *start, uint32_t *end, const uint32_t expected_block[SDRAM_TEST_BLOCK_WORDS]);
+uint32_t *sdram_neon_read_write_up (uint32_t *start, uint32_t *end,
+                                    const uint32_t expected_block[SDRAM_TEST_BLOCK_WORDS],
+                                    const uint32_t new_block[SDRAM_TEST_BLOCK_WORDS]);
+uint32_t *sdram_neon_read_write_down (uint32_t *start, uint32_t *end,
+                                      const uint32_t expected_block[SDRAM_TEST_BLOCK_WORDS],
+                                      const uint32_t new_block[SDRAM_TEST_BLOCK_WORDS]);
+
+/** The order in which a March element accesses the words */
+typedef enum
+{
+    MARCH_UP,
+    MARCH_DOWN
+} march_direction;
+
+/** The pattern blocks used by the March elements, aligned as required by the NEON kernels */
+static uint32_t pattern_blocks[2][SDRAM_TEST_BLOCK_WORDS] __attribute__((aligned(64)));
+
+/** The data backgrounds used by the moving inversions pattern */
+static const uint32_t moving_inversion_backgrounds[] =
+{
+    0x55555555, 0x33333333, 0x0F0F0F0F, 0x00FF00FF, 0x0000FFFF
+};
+#define NUM_MOVING_INVERSION_BACKGROUNDS (sizeof (moving_inversion_backgrounds) / sizeof (moving_inversion_backgrounds[0]))
+
+/**
+ * @brief Record one word which failed to read back the expected value
+ * @param[in,out] result The result of the test pattern to update
+ * @param[in] word The address of the failing word
+ * @param[in] expected The expected value of the word
+ * @param[in] actual The value read from the word
+ */
+static void sdram_test_report_error (sdram_test_pattern_result_t *const result, volatile uint32_t *const word,
+                                     const uint32_t expected, const uint32_t actual)
+{
+    if (result->num_errors == 0)
+    {
+        result->first_failing_address = (uint32_t) word;
+    }
+    result->num_errors++;
+    result->failing_bits |= expected ^ actual;
+    if (result->num_errors <= SDRAM_TEST_MAX_REPORTED_ERRORS)
+    {
+        UARTprintf ("  Error at 0x%08X expected 0x%08X actual 0x%08X failing bits 0x%08X\n",
+                    (uint32_t) word, expected, actual, expected ^ actual);
+    }
+}
+
+/**
+ * @brief Read one word from the memory under test, ensuring the read isn't satisfied from the cache
+ * @param[in] config Defines how the memory is being tested
+ * @param[in] word The word to read
+ * @return The value read
+ */
+static uint32_t sdram_test_read_word (const sdram_test_config_t *const config, volatile uint32_t *const word)
+{
+    if (!config->cache_bypass)
+    {
+        CacheDataCleanInvalidateBuff ((unsigned int) word, sizeof (uint32_t));
+    }
+
+    return *word;
+}
+
+/**
+ * @brief Write one word to the memory under test, ensuring the write reaches the SDRAM before returning
+ * @details With a write-back cache the store would otherwise stay dirty in the cache, and a following read of an
+ *          address which aliases in the SDRAM would not see it.
+ * @param[in] config Defines how the memory is being tested
+ * @param[in] word The word to write
+ * @param[in] value The value to write
+ */
+static void sdram_test_write_word (const sdram_test_config_t *const config, volatile uint32_t *const word,
+                                   const uint32_t value)
+{
+    *word = value;
+    if (!config->cache_bypass)
+    {
+        CacheDataCleanBuff ((unsigned int) word, sizeof (uint32_t));
+    }
+}
+
+/**
+ * @brief Invalidate the memory under test from the cache, when the cache isn't being bypassed
+ * @param[in] config Defines how the memory is being tested
+ */
+static void sdram_test_invalidate_region (const sdram_test_config_t *const config)
+{
+    if (!config->cache_bypass)
+    {
+        CacheDataCleanInvalidateBuff ((unsigned int) config->start, config->num_words * sizeof (uint32_t));
+    }
+}
+
+/**
+ * @brief Set all words in a pattern block to the same value
+ * @param[out] block The pattern block to set
+ * @param[in] value The value for all words
+ */
+static void sdram_test_fill_block (uint32_t block[const SDRAM_TEST_BLOCK_WORDS], const uint32_t value)
+{
+    uint32_t index;
+
+    for (index = 0; index < SDRAM_TEST_BLOCK_WORDS; index++)
+    {
+        block[index] = value;
+    }
+}
+
+/**
+ * @brief Check one block which the NEON implementation has reported as failing
+ * @param[in] block The block to check
+ * @param[in] expected_block The expected contents of the block
+ * @param[in,out] result Updated with the failing words
+ */
+static void sdram_test_check_block (volatile uint32_t *const block,
+                                    const uint32_t expected_block[const SDRAM_TEST_BLOCK_WORDS],
+                                    sdram_test_pattern_result_t *const result)
+{
+    uint32_t index;
+    uint32_t actual;
+
+    for (index = 0; index < SDRAM_TEST_BLOCK_WORDS; index++)
+    {
+        actual = block[index];
+        if (actual != expected_block[index])
+        {
+            sdram_test_report_error (result, &block[index], expected_block[index], actual);
+        }
+    }
+}
+
+/**
+ * @brief Perform one March element over the memory under test
+ * @details Each word is read and checked against the pattern block when expected_block is non-NULL,
+ *          and then written from the pattern block when new_block is non-NULL.
+ * @param[in] config Defines how the memory is being tested
+ * @param[in] direction The order in which the words are accessed. Ignored for an element which only writes.
+ * @param[in] expected_block The pattern block expected to be read, or NULL if the element doesn't read
+ * @param[in] new_block The pattern block to write, or NULL if the element doesn't write
+ * @param[in,out] result Updated with the failing words
+ */
+static void march_element (const sdram_test_config_t *const config, const march_direction direction,
+                           const uint32_t *const expected_block, const uint32_t *const new_block,
+                           sdram_test_pattern_result_t *const result)
+{
+    uint32_t *const end = config->start + config->num_words;
+    uint32_t *block;
+    uint32_t *failing_block;
+    uint32_t count;
+    uint32_t index;
+    uint32_t actual;
+
+    if (config->implementation == SDRAM_TEST_NEON)
+    {
+        if (expected_block == NULL)
+        {
+            sdram_neon_write_up (config->start, end, new_block);
+        }
+        else if (new_block == NULL)
+        {
+            block = config->start;
+            while (block < end)
+            {
+                failing_block = sdram_neon_read_up (block, end, expected_block);
+                if (failing_block == NULL)
+                {
+                    block = end;
+                }
+                else
+                {
+                    sdram_test_check_block (failing_block, expected_block, result);
+                    block = failing_block + SDRAM_TEST_BLOCK_WORDS;
+                }
+            }
+        }
+        else if (direction == MARCH_UP)
+        {
+            block = config->start;
+            while (block < end)
+            {
+                failing_block = sdram_neon_read_write_up (block, end, expected_block, new_block);
+                if (failing_block == NULL)
+                {
+                    block = end;
+                }
+                else
+                {
+                    sdram_test_check_block (failing_block, expected_block, result);
+                    for (index = 0; index < SDRAM_TEST_BLOCK_WORDS; index++)
+                    {
+                        failing_block[index] = new_block[index];
+                    }
+                    block = failing_block + SDRAM_TEST_BLOCK_WORDS;
+                }
+            }
+        }
+        else
+        {
+            block = end;
+            while (block > config->start)
+            {
+                failing_block = sdram_neon_read_write_down (config->start, block, expected_block, new_block);
+                if (failing_block == NULL)
+                {
+                    block = config->start;
+                }
+                else
+                {
+                    sdram_test_check_block (failing_block, expected_block, result);
+                    for (index = 0; index < SDRAM_TEST_BLOCK_WORDS; index++)
+                    {
+                        failing_block[index] = new_block[index];
+                    }
+                    block = failing_block;
+                }
+            }
+        }
+    }
+    else
+    {
+        for (count = 0; count < config->num_words; count++)
+        {
+            volatile uint32_t *const word =
+                    &config->start[(direction == MARCH_UP) ? count : (config->num_words - 1 - count)];
+            const uint32_t pattern_index = ((uint32_t) word / sizeof (uint32_t)) % SDRAM_TEST_BLOCK_WORDS;
+
+            if (expected_block != NULL)
+            {
+                actual = *word;
+                if (actual != expected_block[pattern_index])
+                {
+                    sdram_test_report_error (result, word, expected_block[pattern_index], actual);
+                }
+            }
+            if (new_block != NULL)
+            {
+                *word = new_block[pattern_index];
+            }
+        }
+    }
+
+    sdram_test_invalidate_region (config);
+}
+
+/**
+ * @brief Test for address lines which are stuck high, stuck low or shorted together
+ * @details Based upon the memTestAddressBus() algorithm by Michael Barr. Only the word address lines are tested.
+ *          Each write is cleaned to the SDRAM and each read invalidated from the cache, so that aliased addresses
+ *          are detected when the memory under test is cached.
+ * @param[in] config Defines how the memory is being tested
+ * @param[in,out] result Updated with the failing words
+ */
+static void sdram_test_address_bus (const sdram_test_config_t *const config, sdram_test_pattern_result_t *const result)
+{
+    const uint32_t pattern = 0xAAAAAAAA;
+    const uint32_t antipattern = 0x55555555;
+    const uint32_t address_mask = config->num_words - 1;
+    volatile uint32_t *const base = config->start;
+    uint32_t offset;
+    uint32_t test_offset;
+    uint32_t actual;
+
+    /* Write the default pattern at each of the power-of-two offsets */
+    for (offset = 1; (offset & address_mask) != 0; offset <<= 1)
+    {
+        sdram_test_write_word (config, &base[offset], pattern);
+    }
+
+    /* Check for address bits stuck high */
+    sdram_test_write_word (config, &base[0], antipattern);
+    for (offset = 1; (offset & address_mask) != 0; offset <<= 1)
+    {
+        actual = sdram_test_read_word (config, &base[offset]);
+        if (actual != pattern)
+        {
+            sdram_test_report_error (result, &base[offset], pattern, actual);
+        }
+    }
+    sdram_test_write_word (config, &base[0], pattern);
+
+    /* Check for address bits stuck low or shorted */
+    for (test_offset = 1; (test_offset & address_mask) != 0; test_offset <<= 1)
+    {
+        sdram_test_write_word (config, &base[test_offset], antipattern);
+
+        actual = sdram_test_read_word (config, &base[0]);
+        if (actual != pattern)
+        {
+            sdram_test_report_error (result, &base[0], pattern, actual);
+        }
+
+        for (offset = 1; (offset & address_mask) != 0; offset <<= 1)
+        {
+            if (offset != test_offset)
+            {
+                actual = sdram_test_read_word (config, &base[offset]);
+                if (actual != pattern)
+                {
+                    sdram_test_report_error (result, &base[offset], pattern, actual);
+                }
+            }
+        }
+
+        sdram_test_write_word (config, &base[test_offset], pattern);
+    }
+}
+
+/**
+ * @brief Walk a one, and then a zero, across the data bits in successive words over the memory under test
+ * @details As the pattern block is 16 words, the upper and lower 16 data bits are walked in separate passes
+ * @param[in] config Defines how the memory is being tested
+ * @param[in,out] result Updated with the failing words
+ */
+static void sdram_test_walking_ones_zeros (const sdram_test_config_t *const config,
+                                           sdram_test_pattern_result_t *const result)
+{
+    uint32_t pass;
+    uint32_t index;
+    uint32_t *const block = pattern_blocks[0];
+
+    for (pass = 0; pass < 4; pass++)
+    {
+        const uint32_t first_bit = (pass & 1) ? SDRAM_TEST_BLOCK_WORDS : 0;
+        const uint32_t invert = (pass & 2) ? 0xFFFFFFFF : 0;
+
+        for (index = 0; index < SDRAM_TEST_BLOCK_WORDS; index++)
+        {
+            block[index] = (1u << (first_bit + index)) ^ invert;
+        }
+        march_element (config, MARCH_UP, NULL, block, result);
+        march_element (config, MARCH_UP, block, NULL, result);
+    }
+}
+
+/**
+ * @brief Perform the March C- algorithm using solid backgrounds of all zeros and all ones:
+ *        {up(w0); up(r0,w1); up(r1,w0); down(r0,w1); down(r1,w0); up(r0)}
+ * @param[in] config Defines how the memory is being tested
+ * @param[in,out] result Updated with the failing words
+ */
+static void sdram_test_march_c_minus (const sdram_test_config_t *const config, sdram_test_pattern_result_t *const result)
+{
+    uint32_t *const zeros = pattern_blocks[0];
+    uint32_t *const ones = pattern_blocks[1];
+
+    sdram_test_fill_block (zeros, 0x00000000);
+    sdram_test_fill_block (ones, 0xFFFFFFFF);
+    march_element (config, MARCH_UP, NULL, zeros, result);
+    march_element (config, MARCH_UP, zeros, ones, result);
+    march_element (config, MARCH_UP, ones, zeros, result);
+    march_element (config, MARCH_DOWN, zeros, ones, result);
+    march_element (config, MARCH_DOWN, ones, zeros, result);
+    march_element (config, MARCH_UP, zeros, NULL, result);
+}
+
+/**
+ * @brief Perform moving inversions over each data background:
+ *        {up(wB); up(rB,w~B); down(r~B,wB); up(rB)}
+ * @param[in] config Defines how the memory is being tested
+ * @param[in,out] result Updated with the failing words
+ */
+static void sdram_test_moving_inversions (const sdram_test_config_t *const config,
+                                          sdram_test_pattern_result_t *const result)
+{
+    uint32_t *const background = pattern_blocks[0];
+    uint32_t *const inverse = pattern_blocks[1];
+    uint32_t background_index;
+
+    for (background_index = 0; background_index < NUM_MOVING_INVERSION_BACKGROUNDS; background_index++)
+    {
+        sdram_test_fill_block (background, moving_inversion_backgrounds[background_index]);
+        sdram_test_fill_block (inverse, ~moving_inversion_backgrounds[background_index]);
+        march_element (config, MARCH_UP, NULL, background, result);
+        march_element (config, MARCH_UP, background, inverse, result);
+        march_element (config, MARCH_DOWN, inverse, background, result);
+        march_element (config, MARCH_UP, background, NULL, result);
+    }
+}
+
+/**
+ * @brief Write the word index plus the iteration to each word, and then its complement, checking each
+ * @details This was the original SDRAM test, and detects address aliasing over the entire region
+ * @param[in] config Defines how the memory is being tested
+ * @param[in,out] result Updated with the failing words
+ */
+static void sdram_test_address_in_address (const sdram_test_config_t *const config,
+                                           sdram_test_pattern_result_t *const result)
+{
+    volatile uint32_t *const base = config->start;
+    uint32_t index;
+    uint32_t expected;
+    uint32_t actual;
+    uint32_t invert;
+
+    for (invert = 0; invert < 2; invert++)
+    {
+        for (index = 0; index < config->num_words; index++)
+        {
+            base[index] = invert ? ~(index + config->iteration) : (index + config->iteration);
+        }
+        sdram_test_invalidate_region (config);
+
+        for (index = 0; index < config->num_words; index++)
+        {
+            expected = invert ? ~(index + config->iteration) : (index + config->iteration);
+            actual = base[index];
+            if (actual != expected)
+            {
+                sdram_test_report_error (result, &base[index], expected, actual);
+            }
+        }
+    }
+}
+
+/** The test patterns in the engine, in the order they are run */
+const sdram_test_pattern_t sdram_test_patterns[] =
+{
+    {"address bus isolation", sdram_test_address_bus},
+    {"data bus walking ones/zeros", sdram_test_walking_ones_zeros},
+    {"March C-", sdram_test_march_c_minus},
+    {"moving inversions", sdram_test_moving_inversions},
+    {"address in address", sdram_test_address_in_address}
+};
+const uint32_t sdram_test_num_patterns = sizeof (sdram_test_patterns) / sizeof (sdram_test_patterns[0]);
+
+/**
+ * @brief Run one test pattern, timing it using the timestamp
+ * @param[in] pattern The test pattern to run
+ * @param[in] config Defines how the memory is tested
+ * @param[out] result The result of the test pattern
+ */
+void sdram_test_run_pattern (const sdram_test_pattern_t *const pattern, const sdram_test_config_t *const config,
+                             sdram_test_pattern_result_t *const result)
+{
+    uint64_t start_ns;
+
+    result->num_errors = 0;
+    result->failing_bits = 0;
+    result->first_failing_address = 0;
+
+    start_ns = timestamp_get_ns ();
+    pattern->run (config, result);
+    result->duration_ns = timestamp_get_ns () - start_ns;
+}
@@ -0,0 +1,71 @@
+/*
+ * @file sdram_test_patterns.h
+ * @date 16 Oct 2026
+ * @brief Pluggable engine of test patterns used to test the SDRAM
+ */
+
+#ifndef SDRAM_TEST_PATTERNS_H_
+#define SDRAM_TEST_PATTERNS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Selects how the test patterns access the memory under test */
+typedef enum
+{
+    /** C implementation which accesses one word at a time in the exact order of the March elements */
+    SDRAM_TEST_SCALAR,
+    /** NEON implementation which accesses one 64 byte cache line at a time, to run at memory bandwidth */
+    SDRAM_TEST_NEON
+} sdram_test_implementation;
+
+/** Defines the memory region tested and how it is tested */
+typedef struct
+{
+    /** The start of the memory region to test, which must be aligned to 64 bytes */
+    uint32_t *start;
+    /** The number of words to test, which must be a power of two and a multiple of 16 */
+    uint32_t num_words;
+    /** Selects how the test patterns access the memory */
+    sdram_test_implementation implementation;
+    /** When true the caller has mapped the memory region as non-cacheable, so the caches are bypassed.
+     *  When false the memory region is invalidated from the caches after each March element, so that each
+     *  element has to read the memory region. */
+    bool cache_bypass;
+    /** Varied on each iteration of the test, to change the data values written by the address in address pattern */
+    uint32_t iteration;
+} sdram_test_config_t;
+
+/** The results of running one test pattern */
+typedef struct
+{
+    /** The number of words which didn't read back the expected value */
+    uint32_t num_errors;
+    /** The bits which failed in any word, with bit 0 as the least significant data bit */
+    uint32_t failing_bits;
+    /** The address of the first word which failed */
+    uint32_t first_failing_address;
+    /** The time taken to run the test pattern, in nanoseconds */
+    uint64_t duration_ns;
+} sdram_test_pattern_result_t;
+
+/** The prototype of each test pattern */
+typedef void (*sdram_test_pattern_fn) (const sdram_test_config_t *const config,
+                                       sdram_test_pattern_result_t *const result);
+
+/** Describes one test pattern in the engine */
+typedef struct
+{
+    /** Describes the test pattern in the results */
+    const char *name;
+    /** Runs the test pattern */
+    sdram_test_pattern_fn run;
+} sdram_test_pattern_t;
+
+extern const sdram_test_pattern_t sdram_test_patterns[];
+extern const uint32_t sdram_test_num_patterns;
+
+void sdram_test_run_pattern (const sdram_test_pattern_t *const pattern, const sdram_test_config_t *const config,
+                             sdram_test_pattern_result_t *const result);
+
+#endif /* SDRAM_TEST_PATTERNS_H_ */
@@ -0,0 +1,431 @@
+/*
+ * @file stream_benchmark.c
+ * @date 16 Oct 2026
+ * @brief STREAM style benchmark of the memory bandwidth achievable in the DDR3 and OCMC RAM
+ * @details Runs the copy, scale, add and triad kernels from stream_kernels.asm for each variant of the instructions
+ *          used to access memory, and reports the bandwidth in MB/s (10^6 bytes per second) using the STREAM
+ *          convention of counting the bytes read plus the bytes written.
+ *
+ *          The kernels operate on 32-bit words rather than the doubles used by the original STREAM, since the
+ *          interest is the memory bandwidth for moving packet buffers rather than floating point performance.
+ *
+ *          The caches are cleaned and invalidated before each timed pass, so that each pass has to fetch the
+ *          source arrays from the memory under test. This is necessary for the OCMC RAM where the arrays are
+ *          smaller than the caches. The best of STREAM_NUM_TIMED_PASSES is reported, as per STREAM.
+ *
+ *          The cache policy matrix runs the same kernels, plus a load latency measurement, after the caller has
+ *          changed the cache policy of a memory region in the page table.
+ *
+ *          The PMU event counters are used to report the L1 data and L2 cache miss rates of the triad kernel.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <AM3352_SOM.h>
+#include <uartStdio.h>
+#include <cache.h>
+#include <pmu.h>
+
+#include "stream_benchmark.h"
+
+/** The number of times each kernel is timed, of which the fastest is reported */
+#define STREAM_NUM_TIMED_PASSES 5
+
+/** The alignment of the arrays, which is the Cortex-A8 cache line size as required by the NEON kernels */
+#define STREAM_ARRAY_ALIGNMENT 64
+
+/** The size of each array in the DDR3. STREAM requires each array to be at least 4 times the size of the
+ *  largest cache, which is the 256KB L2 cache. The arrays are placed at the start of the SDRAM, which is
+ *  subsequently overwritten by the SDRAM test. */
+#define STREAM_DDR_BASE_ADDR 0x80000000
+#define STREAM_DDR_ARRAY_WORDS (512 * 1024)
+
+/** The size of each array in the OCMC RAM, which is limited by the OCMC RAM also containing the sdram_test program */
+#define STREAM_OCMC_ARRAY_WORDS 512
+
+/** The strides in cache lines between the loads used to measure the latency of each region. Must be odd, so that all
+ *  lines are visited as the number of lines in each region is a power of two.
+ *  In the DDR3 the stride of 4160 bytes is larger than a DDR3 page, so each load opens a different page.
+ *  The OCMC RAM has no pages, and its arrays are only 32 lines so a stride larger than that would wrap to visit the
+ *  lines sequentially. Its stride just ensures consecutive loads are to lines which aren't adjacent. */
+#define STREAM_DDR_LATENCY_STRIDE_LINES 65
+#define STREAM_OCMC_LATENCY_STRIDE_LINES 13
+
+/** The index in stream_variants[] of the NEON VLD1/VST1 variant used for the cache policy matrix */
+#define STREAM_POLICY_VARIANT_INDEX 2
+
+/** The value of the scalar used by the scale and triad kernels */
+#define STREAM_SCALAR 3
+
+/** Identifies the STREAM kernels */
+typedef enum
+{
+    STREAM_COPY,
+    STREAM_SCALE,
+    STREAM_ADD,
+    STREAM_TRIAD,
+
+    STREAM_NUM_KERNELS
+} stream_kernel_id;
+
+/** The prototype of the kernels in stream_kernels.asm */
+typedef void (*stream_kernel_t) (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                                 uint32_t num_words, uint32_t pld_distance);
+
+void stream_copy_scalar (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                         uint32_t num_words, uint32_t pld_distance);
+void stream_scale_scalar (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                          uint32_t num_words, uint32_t pld_distance);
+void stream_add_scalar (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                        uint32_t num_words, uint32_t pld_distance);
+void stream_triad_scalar (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                          uint32_t num_words, uint32_t pld_distance);
+void stream_copy_ldm (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                      uint32_t num_words, uint32_t pld_distance);
+void stream_scale_ldm (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                       uint32_t num_words, uint32_t pld_distance);
+void stream_add_ldm (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                     uint32_t num_words, uint32_t pld_distance);
+void stream_triad_ldm (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                       uint32_t num_words, uint32_t pld_distance);
+void stream_copy_neon (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                       uint32_t num_words, uint32_t pld_distance);
+void stream_scale_neon (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                        uint32_t num_words, uint32_t pld_distance);
+void stream_add_neon (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                      uint32_t num_words, uint32_t pld_distance);
+void stream_triad_neon (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                        uint32_t num_words, uint32_t pld_distance);
+void stream_copy_neon_pld (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                           uint32_t num_words, uint32_t pld_distance);
+void stream_scale_neon_pld (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                            uint32_t num_words, uint32_t pld_distance);
+void stream_add_neon_pld (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                          uint32_t num_words, uint32_t pld_distance);
+void stream_triad_neon_pld (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                            uint32_t num_words, uint32_t pld_distance);
+
+/** One variant of the instructions used to access memory, which is benchmarked for all kernels */
+typedef struct
+{
+    /** Describes the variant in the results */
+    const char *name;
+    /** The distance in bytes ahead of the source which is prefetched, for the variants which use PLD */
+    uint32_t pld_distance;
+    /** The implementation of each kernel for this variant */
+    stream_kernel_t kernels[STREAM_NUM_KERNELS];
+} stream_variant_t;
+
+static const stream_variant_t stream_variants[] =
+{
+    {"scalar LDR/STR", 0, {stream_copy_scalar, stream_scale_scalar, stream_add_scalar, stream_triad_scalar}},
+    {"LDM/STM", 0, {stream_copy_ldm, stream_scale_ldm, stream_add_ldm, stream_triad_ldm}},
+    {"NEON VLD1/VST1", 0, {stream_copy_neon, stream_scale_neon, stream_add_neon, stream_triad_neon}},
+    {"NEON PLD 64", 64, {stream_copy_neon_pld, stream_scale_neon_pld, stream_add_neon_pld, stream_triad_neon_pld}},
+    {"NEON PLD 128", 128, {stream_copy_neon_pld, stream_scale_neon_pld, stream_add_neon_pld, stream_triad_neon_pld}},
+    {"NEON PLD 256", 256, {stream_copy_neon_pld, stream_scale_neon_pld, stream_add_neon_pld, stream_triad_neon_pld}},
+    {"NEON PLD 512", 512, {stream_copy_neon_pld, stream_scale_neon_pld, stream_add_neon_pld, stream_triad_neon_pld}}
+};
+#define NUM_STREAM_VARIANTS (sizeof (stream_variants) / sizeof (stream_variants[0]))
+
+/** The number of arrays accessed by each kernel, used to calculate the number of bytes transferred */
+static const uint32_t stream_arrays_accessed[STREAM_NUM_KERNELS] = {2, 2, 3, 3};
+
+/** The PMU events counted for each kernel, to report the cache miss rates */
+static const pmu_event_set_t stream_pmu_events =
+{
+    .events = {PMU_EVENT_L1D_CACHE_REFILL, PMU_EVENT_L1D_CACHE_ACCESS, PMU_EVENT_L2_CACHE_MISS, PMU_EVENT_L2_ACCESS}
+};
+#define STREAM_PMU_L1D_REFILL 0
+#define STREAM_PMU_L1D_ACCESS 1
+#define STREAM_PMU_L2_MISS    2
+#define STREAM_PMU_L2_ACCESS  3
+
+/** The arrays used in the OCMC RAM. Only the destination array is written by the kernels. */
+static uint32_t ocmc_arrays[3][STREAM_OCMC_ARRAY_WORDS] __attribute__((aligned(STREAM_ARRAY_ALIGNMENT)));
+
+/** Defines the arrays used for one memory region */
+typedef struct
+{
+    /** Describes the memory region in the results */
+    const char *name;
+    /** The destination array */
+    uint32_t *dst;
+    /** The first source array */
+    uint32_t *src1;
+    /** The second source array */
+    uint32_t *src2;
+    /** The number of words in each array */
+    uint32_t num_words;
+    /** The stride in cache lines between the loads used to measure the latency */
+    uint32_t latency_stride_lines;
+} stream_region_t;
+
+static const stream_region_t stream_regions[STREAM_NUM_REGIONS] =
+{
+    [STREAM_REGION_DDR] =
+    {
+        .name = "DDR3",
+        .dst = (uint32_t *) STREAM_DDR_BASE_ADDR,
+        .src1 = (uint32_t *) STREAM_DDR_BASE_ADDR + STREAM_DDR_ARRAY_WORDS,
+        .src2 = (uint32_t *) STREAM_DDR_BASE_ADDR + (2 * STREAM_DDR_ARRAY_WORDS),
+        .num_words = STREAM_DDR_ARRAY_WORDS,
+        .latency_stride_lines = STREAM_DDR_LATENCY_STRIDE_LINES
+    },
+    [STREAM_REGION_OCMC] =
+    {
+        .name = "OCMC RAM",
+        .dst = ocmc_arrays[0],
+        .src1 = ocmc_arrays[1],
+        .src2 = ocmc_arrays[2],
+        .num_words = STREAM_OCMC_ARRAY_WORDS,
+        .latency_stride_lines = STREAM_OCMC_LATENCY_STRIDE_LINES
+    }
+};
+
+/**
+ * @brief Get the expected result of a kernel for one element
+ * @param[in] kernel Which kernel to get the result for
+ * @param[in] src1 The value of the first source element
+ * @param[in] src2 The value of the second source element
+ * @return The expected value of the destination element
+ */
+static uint32_t stream_expected_result (const stream_kernel_id kernel, const uint32_t src1, const uint32_t src2)
+{
+    switch (kernel)
+    {
+    case STREAM_COPY:
+        return src1;
+    case STREAM_SCALE:
+        return STREAM_SCALAR * src1;
+    case STREAM_ADD:
+        return src1 + src2;
+    case STREAM_TRIAD:
+    default:
+        return src1 + (STREAM_SCALAR * src2);
+    }
+}
+
+/**
+ * @brief Initialise the source arrays for a memory region
+ * @param[in] region The memory region to initialise
+ */
+static void stream_initialise_sources (const stream_region_t *const region)
+{
+    uint32_t index;
+
+    for (index = 0; index < region->num_words; index++)
+    {
+        region->src1[index] = index;
+        region->src2[index] = ~index;
+    }
+}
+
+/**
+ * @brief Time one kernel in a memory region, and verify the result
+ * @details The time for each pass includes cleaning the destination from the cache, so that write-back
+ *          cache policies are charged for writing the destination to memory.
+ * @param[in] region The memory region to run the kernel in
+ * @param[in] kernel_id Which kernel is being timed
+ * @param[in] kernel The kernel implementation to time
+ * @param[in] pld_distance The PLD distance passed to the kernel
+ * @param[in] cycle_counter_ticks_per_sec The measured frequency of the cycle counter, used to convert to MB/s
+ * @param[in,out] num_errors Incremented for each destination word which fails verification
+ * @param[out] best_pass_counts The PMU counts during the fastest pass
+ * @return Returns the bandwidth in MB/s of the fastest pass
+ */
+static uint32_t stream_time_kernel (const stream_region_t *const region, const stream_kernel_id kernel_id,
+                                    const stream_kernel_t kernel, const uint32_t pld_distance,
+                                    const uint32_t cycle_counter_ticks_per_sec, uint32_t *const num_errors,
+                                    pmu_counters_t *const best_pass_counts)
+{
+    pmu_counters_t start_counts;
+    pmu_counters_t end_counts;
+    const uint32_t array_bytes = region->num_words * sizeof (uint32_t);
+    uint32_t pass;
+    uint32_t index;
+    uint32_t start_cycle_count;
+    uint32_t pass_cycles;
+    uint32_t best_cycles = 0xFFFFFFFFu;
+
+    for (pass = 0; pass < STREAM_NUM_TIMED_PASSES; pass++)
+    {
+        CacheDataCleanInvalidateBuff ((unsigned int) region->dst, array_bytes);
+        CacheDataCleanInvalidateBuff ((unsigned int) region->src1, array_bytes);
+        CacheDataCleanInvalidateBuff ((unsigned int) region->src2, array_bytes);
+        pmu_counters_read (&start_counts);
+        start_cycle_count = pmu_get_cycle_count ();
+        kernel (region->dst, region->src1, region->src2, STREAM_SCALAR, region->num_words, pld_distance);
+        CacheDataCleanBuff ((unsigned int) region->dst, array_bytes);
+        pass_cycles = pmu_get_cycle_count () - start_cycle_count;
+        pmu_counters_read (&end_counts);
+        if (pass_cycles < best_cycles)
+        {
+            best_cycles = pass_cycles;
+            pmu_counters_difference (&start_counts, &end_counts, best_pass_counts);
+        }
+    }
+
+    for (index = 0; index < region->num_words; index++)
+    {
+        if (region->dst[index] != stream_expected_result (kernel_id, region->src1[index], region->src2[index]))
+        {
+            (*num_errors)++;
+        }
+    }
+
+    return (uint32_t) (((uint64_t) stream_arrays_accessed[kernel_id] * array_bytes * cycle_counter_ticks_per_sec) /
+                       ((uint64_t) best_cycles * 1000000u));
+}
+
+/**
+ * @brief Calculate a miss rate as a percentage
+ * @param[in] misses The number of misses
+ * @param[in] accesses The number of accesses
+ * @return The miss rate in percent, or zero if there were no accesses
+ */
+static uint32_t stream_miss_percent (const uint64_t misses, const uint64_t accesses)
+{
+    return (accesses > 0) ? (uint32_t) ((misses * 100u) / accesses) : 0;
+}
+
+/**
+ * @brief Measure the average latency of loads which miss in the caches
+ * @details The destination array of the region is used to hold a chain of pointers with one pointer per cache line,
+ *          where the lines are visited with the stride chosen for the region so that consecutive loads aren't to
+ *          adjacent lines, and in the DDR3 are to different pages. As each load depends upon the previous the CPU
+ *          can't overlap the loads.
+ * @param[in] region The memory region to measure the latency of
+ * @return Returns the average CPU cycles per load
+ */
+static uint32_t stream_measure_load_latency (const stream_region_t *const region)
+{
+    const uint32_t words_per_line = STREAM_ARRAY_ALIGNMENT / sizeof (uint32_t);
+    const uint32_t num_lines = region->num_words / words_per_line;
+    uint32_t line;
+    uint32_t next_line;
+    uint32_t start_cycle_count;
+    uint32_t total_cycles;
+    volatile uint32_t *pointer;
+
+    line = 0;
+    do
+    {
+        next_line = (line + region->latency_stride_lines) % num_lines;
+        region->dst[line * words_per_line] = (uint32_t) &region->dst[next_line * words_per_line];
+        line = next_line;
+    } while (line != 0);
+    CacheDataCleanInvalidateBuff ((unsigned int) region->dst, region->num_words * sizeof (uint32_t));
+
+    pointer = region->dst;
+    start_cycle_count = pmu_get_cycle_count ();
+    for (line = 0; line < num_lines; line++)
+    {
+        pointer = (volatile uint32_t *) *pointer;
+    }
+    total_cycles = pmu_get_cycle_count () - start_cycle_count;
+
+    return total_cycles / num_lines;
+}
+
+/**
+ * @brief Run the STREAM benchmark in the DDR3 and OCMC RAM, displaying the results on the console
+ * @details Must be called with the MMU and caches enabled, and with the cycle counter running.
+ *          Runs all variants of all kernels in each region.
+ * @param[in] cycle_counter_ticks_per_sec The measured frequency of the cycle counter, used to convert to MB/s
+ */
+void stream_benchmark_run (const uint32_t cycle_counter_ticks_per_sec)
+{
+    uint32_t region_index;
+    uint32_t variant_index;
+    uint32_t kernel;
+    uint32_t num_errors;
+    uint32_t mb_per_sec[STREAM_NUM_KERNELS];
+    pmu_counters_t pmu_counts[STREAM_NUM_KERNELS];
+
+    pmu_event_counters_configure (&stream_pmu_events);
+    pmu_event_counters_start ();
+    for (region_index = 0; region_index < STREAM_NUM_REGIONS; region_index++)
+    {
+        const stream_region_t *const region = &stream_regions[region_index];
+
+        stream_initialise_sources (region);
+        UARTprintf ("\nSTREAM benchmark for %s with arrays of %u bytes, MB/s best of %u passes\n",
+                    region->name, region->num_words * sizeof (uint32_t), STREAM_NUM_TIMED_PASSES);
+        UARTprintf ("  Copy  Scale    Add  Triad  Triad L1D miss%%  L2 miss%%  Variant\n");
+        for (variant_index = 0; variant_index < NUM_STREAM_VARIANTS; variant_index++)
+        {
+            const stream_variant_t *const variant = &stream_variants[variant_index];
+
+            num_errors = 0;
+            for (kernel = 0; kernel < STREAM_NUM_KERNELS; kernel++)
+            {
+                mb_per_sec[kernel] = stream_time_kernel (region, kernel, variant->kernels[kernel],
+                                                         variant->pld_distance, cycle_counter_ticks_per_sec,
+                                                         &num_errors, &pmu_counts[kernel]);
+            }
+
+            UARTprintf ("%6u %6u %6u %6u  %15u  %8u  %s%s\n",
+                        mb_per_sec[STREAM_COPY], mb_per_sec[STREAM_SCALE], mb_per_sec[STREAM_ADD],
+                        mb_per_sec[STREAM_TRIAD],
+                        stream_miss_percent (pmu_counts[STREAM_TRIAD].events[STREAM_PMU_L1D_REFILL],
+                                             pmu_counts[STREAM_TRIAD].events[STREAM_PMU_L1D_ACCESS]),
+                        stream_miss_percent (pmu_counts[STREAM_TRIAD].events[STREAM_PMU_L2_MISS],
+                                             pmu_counts[STREAM_TRIAD].events[STREAM_PMU_L2_ACCESS]),
+                        variant->name, (num_errors > 0) ? " FAILED verification" : "");
+        }
+    }
+}
+
+/**
+ * @brief Display the heading for the cache policy matrix of one memory region
+ * @param[in] region_id Which memory region the following calls to stream_benchmark_cache_policy() are for
+ */
+void stream_benchmark_cache_policy_heading (const stream_region_id region_id)
+{
+    const stream_region_t *const region = &stream_regions[region_id];
+
+    UARTprintf ("\nCache policy matrix for %s with arrays of %u bytes, NEON VLD1/VST1 MB/s and load latency\n",
+                region->name, region->num_words * sizeof (uint32_t));
+    UARTprintf ("  Copy  Scale    Add  Triad  Latency(cycles)  Triad L1D miss%%  L2 miss%%  Cache policy\n");
+}
+
+/**
+ * @brief Benchmark one memory region using the cache policy which has been set in the page table by the caller
+ * @details Displays one row of the cache policy matrix, using the NEON kernels as the same kernels are
+ *          run for all policies.
+ * @param[in] region_id Which memory region to benchmark
+ * @param[in] policy_name Describes the cache policy in the results
+ * @param[in] cycle_counter_ticks_per_sec The measured frequency of the cycle counter, used to convert to MB/s
+ */
+void stream_benchmark_cache_policy (const stream_region_id region_id, const char *const policy_name,
+                                    const uint32_t cycle_counter_ticks_per_sec)
+{
+    const stream_region_t *const region = &stream_regions[region_id];
+    const stream_variant_t *const variant = &stream_variants[STREAM_POLICY_VARIANT_INDEX];
+    uint32_t kernel;
+    uint32_t num_errors = 0;
+    uint32_t mb_per_sec[STREAM_NUM_KERNELS];
+    uint32_t latency_cycles;
+    pmu_counters_t pmu_counts[STREAM_NUM_KERNELS];
+
+    pmu_event_counters_configure (&stream_pmu_events);
+    pmu_event_counters_start ();
+    stream_initialise_sources (region);
+    for (kernel = 0; kernel < STREAM_NUM_KERNELS; kernel++)
+    {
+        mb_per_sec[kernel] = stream_time_kernel (region, kernel, variant->kernels[kernel], variant->pld_distance,
+                                                 cycle_counter_ticks_per_sec, &num_errors, &pmu_counts[kernel]);
+    }
+    latency_cycles = stream_measure_load_latency (region);
+
+    UARTprintf ("%6u %6u %6u %6u  %15u  %15u  %8u  %s%s\n",
+                mb_per_sec[STREAM_COPY], mb_per_sec[STREAM_SCALE], mb_per_sec[STREAM_ADD], mb_per_sec[STREAM_TRIAD],
+                latency_cycles,
+                stream_miss_percent (pmu_counts[STREAM_TRIAD].events[STREAM_PMU_L1D_REFILL],
+                                     pmu_counts[STREAM_TRIAD].events[STREAM_PMU_L1D_ACCESS]),
+                stream_miss_percent (pmu_counts[STREAM_TRIAD].events[STREAM_PMU_L2_MISS],
+                                     pmu_counts[STREAM_TRIAD].events[STREAM_PMU_L2_ACCESS]),
+                policy_name, (num_errors > 0) ? " FAILED verification" : "");
+}
@@ -0,0 +1,26 @@
+/*
+ * @file stream_benchmark.h
+ * @date 16 Oct 2026
+ * @brief STREAM style benchmark of the memory bandwidth achievable in the DDR3 and OCMC RAM
+ */
+
+#ifndef STREAM_BENCHMARK_H_
+#define STREAM_BENCHMARK_H_
+
+#include <stdint.h>
+
+/** Identifies the memory regions which are benchmarked */
+typedef enum
+{
+    STREAM_REGION_DDR,
+    STREAM_REGION_OCMC,
+
+    STREAM_NUM_REGIONS
+} stream_region_id;
+
+void stream_benchmark_run (const uint32_t cycle_counter_ticks_per_sec);
+void stream_benchmark_cache_policy_heading (const stream_region_id region_id);
+void stream_benchmark_cache_policy (const stream_region_id region_id, const char *const policy_name,
+                                    const uint32_t cycle_counter_ticks_per_sec);
+
+#endif /* STREAM_BENCHMARK_H_ */
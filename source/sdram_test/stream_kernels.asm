@@ -0,0 +1,220 @@
+/*
+  @file stream_kernels.asm
+  @date 16 Oct 2026
+  @brief STREAM style copy, scale, add and triad kernels used to measure the achievable memory bandwidth
+  @details The kernels are written in assembler so that the instructions used to access memory are fixed,
+           regardless of the compiler optimisation level. Each kernel operates on 32-bit words, and has the
+           C prototype:
+
+           void kernel (uint32_t *dst, const uint32_t *src1, const uint32_t *src2, uint32_t scalar,
+                        uint32_t num_words, uint32_t pld_distance);
+
+           copy:  dst[i] = src1[i]
+           scale: dst[i] = scalar * src1[i]
+           add:   dst[i] = src1[i] + src2[i]
+           triad: dst[i] = src1[i] + scalar * src2[i]
+
+           The variants are:
+           _scalar   : One word per LDR / STR.
+           _ldm      : Multiple words per LDM / STM.
+           _neon     : 64 bytes, i.e. one cache line, per iteration using VLD1 / VST1.
+           _neon_pld : As _neon, with a PLD of each source pld_distance bytes ahead of the current position.
+
+           num_words must be a non-zero multiple of 16, and the arrays must be aligned to 64 bytes.
+           src2 and scalar are ignored by the kernels which don't use them.
+*/
+
+        .arch armv7-a
+        .fpu  neon
+        .syntax unified
+        .arm
+        .text
+
+/* Save the registers used, and load the stack arguments: r12 = num_words, lr = pld_distance */
+        .macro kernel_entry name
+        .global \name
+        .type   \name, %function
+\name:
+        push  {r4-r11, lr}
+        ldr   r12, [sp, #36]
+        ldr   lr,  [sp, #40]
+        .endm
+
+        .macro kernel_exit
+        pop   {r4-r11, pc}
+        .endm
+
+/* Scalar variants */
+        kernel_entry stream_copy_scalar
+1:      ldr   r4, [r1], #4
+        str   r4, [r0], #4
+        subs  r12, r12, #1
+        bne   1b
+        kernel_exit
+
+        kernel_entry stream_scale_scalar
+1:      ldr   r4, [r1], #4
+        mul   r4, r4, r3
+        str   r4, [r0], #4
+        subs  r12, r12, #1
+        bne   1b
+        kernel_exit
+
+        kernel_entry stream_add_scalar
+1:      ldr   r4, [r1], #4
+        ldr   r5, [r2], #4
+        add   r4, r4, r5
+        str   r4, [r0], #4
+        subs  r12, r12, #1
+        bne   1b
+        kernel_exit
+
+        kernel_entry stream_triad_scalar
+1:      ldr   r4, [r1], #4
+        ldr   r5, [r2], #4
+        mla   r4, r5, r3, r4
+        str   r4, [r0], #4
+        subs  r12, r12, #1
+        bne   1b
+        kernel_exit
+
+/* LDM / STM variants, which transfer 8 words per iteration for a single source or 4 words per iteration
+   from each of two sources */
+        kernel_entry stream_copy_ldm
+1:      ldmia r1!, {r4-r11}
+        stmia r0!, {r4-r11}
+        subs  r12, r12, #8
+        bne   1b
+        kernel_exit
+
+        kernel_entry stream_scale_ldm
+1:      ldmia r1!, {r4-r11}
+        mul   r4, r4, r3
+        mul   r5, r5, r3
+        mul   r6, r6, r3
+        mul   r7, r7, r3
+        mul   r8, r8, r3
+        mul   r9, r9, r3
+        mul   r10, r10, r3
+        mul   r11, r11, r3
+        stmia r0!, {r4-r11}
+        subs  r12, r12, #8
+        bne   1b
+        kernel_exit
+
+        kernel_entry stream_add_ldm
+1:      ldmia r1!, {r4-r7}
+        ldmia r2!, {r8-r11}
+        add   r4, r4, r8
+        add   r5, r5, r9
+        add   r6, r6, r10
+        add   r7, r7, r11
+        stmia r0!, {r4-r7}
+        subs  r12, r12, #4
+        bne   1b
+        kernel_exit
+
+        kernel_entry stream_triad_ldm
+1:      ldmia r1!, {r4-r7}
+        ldmia r2!, {r8-r11}
+        mla   r4, r8, r3, r4
+        mla   r5, r9, r3, r5
+        mla   r6, r10, r3, r6
+        mla   r7, r11, r3, r7
+        stmia r0!, {r4-r7}
+        subs  r12, r12, #4
+        bne   1b
+        kernel_exit
+
+/* NEON variants, which transfer one 64 byte cache line from each source per iteration.
+   Only q0-q3 and q8-q12 are used, since d8-d15 are callee saved.
+   When the pld argument is non-zero a PLD is issued for each source at pld_distance bytes ahead. */
+        .macro neon_copy name, pld
+        kernel_entry \name
+1:
+        .if \pld
+        pld   [r1, lr]
+        .endif
+        vld1.32 {d0-d3}, [r1:128]!
+        vld1.32 {d4-d7}, [r1:128]!
+        vst1.32 {d0-d3}, [r0:128]!
+        vst1.32 {d4-d7}, [r0:128]!
+        subs  r12, r12, #16
+        bne   1b
+        kernel_exit
+        .endm
+
+        .macro neon_scale name, pld
+        kernel_entry \name
+        vdup.32 q12, r3
+1:
+        .if \pld
+        pld   [r1, lr]
+        .endif
+        vld1.32 {d0-d3}, [r1:128]!
+        vld1.32 {d4-d7}, [r1:128]!
+        vmul.i32 q0, q0, q12
+        vmul.i32 q1, q1, q12
+        vmul.i32 q2, q2, q12
+        vmul.i32 q3, q3, q12
+        vst1.32 {d0-d3}, [r0:128]!
+        vst1.32 {d4-d7}, [r0:128]!
+        subs  r12, r12, #16
+        bne   1b
+        kernel_exit
+        .endm
+
+        .macro neon_add name, pld
+        kernel_entry \name
+1:
+        .if \pld
+        pld   [r1, lr]
+        pld   [r2, lr]
+        .endif
+        vld1.32 {d0-d3}, [r1:128]!
+        vld1.32 {d4-d7}, [r1:128]!
+        vld1.32 {d16-d19}, [r2:128]!
+        vld1.32 {d20-d23}, [r2:128]!
+        vadd.i32 q0, q0, q8
+        vadd.i32 q1, q1, q9
+        vadd.i32 q2, q2, q10
+        vadd.i32 q3, q3, q11
+        vst1.32 {d0-d3}, [r0:128]!
+        vst1.32 {d4-d7}, [r0:128]!
+        subs  r12, r12, #16
+        bne   1b
+        kernel_exit
+        .endm
+
+        .macro neon_triad name, pld
+        kernel_entry \name
+        vdup.32 q12, r3
+1:
+        .if \pld
+        pld   [r1, lr]
+        pld   [r2, lr]
+        .endif
+        vld1.32 {d0-d3}, [r1:128]!
+        vld1.32 {d4-d7}, [r1:128]!
+        vld1.32 {d16-d19}, [r2:128]!
+        vld1.32 {d20-d23}, [r2:128]!
+        vmla.i32 q0, q8, q12
+        vmla.i32 q1, q9, q12
+        vmla.i32 q2, q10, q12
+        vmla.i32 q3, q11, q12
+        vst1.32 {d0-d3}, [r0:128]!
+        vst1.32 {d4-d7}, [r0:128]!
+        subs  r12, r12, #16
+        bne   1b
+        kernel_exit
+        .endm
+
+        neon_copy  stream_copy_neon, 0
+        neon_scale stream_scale_neon, 0
+        neon_add   stream_add_neon, 0
+        neon_triad stream_triad_neon, 0
+
+        neon_copy  stream_copy_neon_pld, 1
+        neon_scale stream_scale_neon_pld, 1
+        neon_add   stream_add_neon_pld, 1
+        neon_triad stream_triad_neon_pld, 1